@@ -32,6 +32,13 @@ function minizip.project()
 			path.join(minizip.source, "minizip.c"),
 		}
 
+		-- The tests project also builds it on Linux
+		filter "system:not windows"
+			removefiles {
+				path.join(minizip.source, "iowin32.c"),
+			}
+		filter {}
+
 		defines {
 			"_CRT_SECURE_NO_DEPRECATE",
 		}
@@ -250,18 +250,21 @@ end
 
 flags {"NoIncrementalLink", "NoMinimalRebuild", "MultiProcessorCompile", "No64BitChecks"}
 
-filter "platforms:x64"
+filter {"platforms:x64", "system:windows"}
 	defines {"_WINDOWS", "WIN32"}
 filter {}
 
 filter "configurations:Release"
 	optimize "Size"
-	buildoptions {"/GL"}
-	linkoptions {"/IGNORE:4702", "/LTCG"}
 	defines {"NDEBUG"}
 	fatalwarnings {"All"}
 filter {}
 
+filter {"configurations:Release", "system:windows"}
+	buildoptions {"/GL"}
+	linkoptions {"/IGNORE:4702", "/LTCG"}
+filter {}
+
 filter "configurations:Debug"
 	optimize "Debug"
 	defines {"DEBUG", "_DEBUG"}
@@ -348,6 +351,37 @@ resincludedirs {"$(ProjectDir)src"}
 
 dependencies.imports()
 
+project "tests"
+kind "ConsoleApp"
+language "C++"
+
+-- Only portable units are linked in, so the tests also build on Linux (premake5 gmake2)
+files {
+	"./src/test/**.hpp",
+	"./src/test/**.cpp",
+	"./src/common/utils/compression.*",
+	"./src/common/utils/frame_pacer.*",
+	"./src/common/utils/http_server.*",
+	"./src/common/utils/latency_stats.*",
+	"./src/common/utils/memory.*",
+	"./src/common/utils/metrics.*",
+	"./src/common/utils/output_history.*",
+	"./src/common/utils/signature_scanner.*",
+	"./src/common/utils/string.*",
+	"./src/common/utils/transaction.*",
+	"./src/client/steam/callbacks.*",
+}
+
+-- src/test comes first, its std_include.hpp stands in for the client's precompiled header
+includedirs {"./src/test", "./src/common", "./src/client"}
+
+gsl.import()
+minizip.import()
+
+filter "system:linux"
+	links {"pthread"}
+filter {}
+
 group "Dependencies"
 dependencies.projects()
 
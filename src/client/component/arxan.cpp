@@ -116,16 +116,6 @@ namespace arxan
 	class component final : public component_interface
 	{
 	public:
-		void* load_import(const std::string& library, const std::string& function) override
-		{
-			if (function == "SetThreadContext")
-			{
-				//return set_thread_context_stub;
-			}
-
-			return nullptr;
-		}
-
 		void post_load() override
 		{
 			hide_being_debugged();
@@ -10,14 +10,21 @@
 
 #include <utils/concurrency.hpp>
 #include <utils/hook.hpp>
+#include <utils/string.hpp>
 #include <utils/thread.hpp>
 
 namespace console
 {
 	namespace
 	{
-		using message_queue = std::queue<std::string>;
-		utils::concurrency::container<message_queue> message_queue_;
+		struct message_chunk
+		{
+			uint16_t length;
+			char data[0xFE];
+		};
+
+		// Producers never block on the console or stdout, the runner batches the output
+		utils::concurrency::ring_queue<message_chunk, 0x2000> message_queue_;
 
 		std::atomic_bool started_{false};
 		std::atomic_bool terminate_runner_{false};
@@ -56,30 +63,33 @@ namespace console
 			}
 
 			game_console::print(type, message);
+			utils::concurrency::push_chunked(message_queue_, message);
+		}
 
-			if (game::is_headless())
-			{
-				std::fputs(message.data(), stdout);
-				return;
-			}
+		void flush_messages()
+		{
+			static std::string message_buffer{};
+			message_buffer.clear();
 
-			message_queue_.access([&message](message_queue& queue)
+			message_queue_.consume([](const message_chunk& chunk)
 			{
-				queue.emplace(message);
+				message_buffer.append(chunk.data, chunk.length);
 			});
-		}
 
-		message_queue empty_message_queue()
-		{
-			message_queue current_queue{};
+			if (const auto dropped = message_queue_.take_dropped())
+			{
+				message_buffer.append(utils::string::va("%zu console messages were dropped\n", dropped));
+			}
 
-			message_queue_.access([&](message_queue& queue)
+			if (!message_buffer.empty())
 			{
-				current_queue = std::move(queue);
-				queue = {};
-			});
+				print_message(message_buffer.data());
 
-			return current_queue;
+				if (game::is_headless())
+				{
+					std::fflush(stdout);
+				}
+			}
 		}
 
 		void print_stub(const char* fmt, ...)
@@ -88,10 +98,13 @@ namespace console
 
 			va_list ap;
 			va_start(ap, fmt);
-			[[maybe_unused]] const auto res = vsnprintf(buffer, sizeof(buffer), fmt, ap);
+			const auto res = vsnprintf(buffer, sizeof(buffer), fmt, ap);
 			va_end(ap);
 
-			print_message(buffer);
+			if (res > 0)
+			{
+				utils::concurrency::push_chunked(message_queue_, {buffer, std::min(static_cast<size_t>(res), sizeof(buffer) - 1)});
+			}
 		}
 
 		void append_text(const char* text)
@@ -129,41 +142,27 @@ namespace console
 
 			utils::hook::jump(printf, print_stub);
 
-			if (game::is_headless())
-			{
-				return;
-			}
-
 			terminate_runner_ = false;
 
 			this->message_runner_ = utils::thread::create_named_thread("Console IO", []
 			{
-				while (!started_)
+				while (!started_ && !game::is_headless())
 				{
 					std::this_thread::sleep_for(10ms);
 				}
 
 				while (!terminate_runner_)
 				{
-					std::string message_buffer{};
-					auto current_queue = empty_message_queue();
-
-					while (!current_queue.empty())
-					{
-						const auto& msg = current_queue.front();
-						message_buffer.append(msg);
-						current_queue.pop();
-					}
-
-					if (!message_buffer.empty())
-					{
-						print_message(message_buffer.data());
-					}
-
+					flush_messages();
 					std::this_thread::sleep_for(5ms);
 				}
 			});
 
+			if (game::is_headless())
+			{
+				return;
+			}
+
 			this->console_runner_ = utils::thread::create_named_thread("Console Window", [this]
 			{
 				game::Sys_ShowConsole();
@@ -210,6 +209,8 @@ namespace console
 			{
 				this->console_runner_.join();
 			}
+
+			flush_messages();
 		}
 
 	private:
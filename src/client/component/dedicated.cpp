@@ -12,6 +12,7 @@
 
 #include "component/gsc/script_extension.hpp"
 
+#include <utils/frame_pacer.hpp>
 #include <utils/hook.hpp>
 #include <utils/string.hpp>
 
@@ -103,9 +104,72 @@ namespace dedicated
 			}
 		}
 
+		// Stock server tick rate, used when sv_fps isn't available
+		constexpr uint32_t default_tick_rate = 20;
+
+		// Com_Frame also services packets, so it runs several frames per server tick.
+		// SV_Frame only runs a tick once a full tick interval has accumulated, and with a
+		// whole multiple every tick boundary falls onto a frame deadline instead of aliasing.
+		constexpr uint32_t frames_per_tick = 5;
+		constexpr uint32_t max_frame_rate = 1000;
+
+		utils::frame_pacer& get_frame_pacer()
+		{
+			static utils::frame_pacer pacer{};
+			return pacer;
+		}
+
+		uint32_t get_tick_rate()
+		{
+			// sv_fps might not be registered yet, keep looking until it is
+			static const game::dvar_t* sv_fps{};
+			if (!sv_fps)
+			{
+				sv_fps = game::Dvar_FindVar("sv_fps");
+			}
+
+			if (sv_fps && sv_fps->current.integer > 0)
+			{
+				return static_cast<uint32_t>(sv_fps->current.integer);
+			}
+
+			return default_tick_rate;
+		}
+
+		uint32_t get_frame_rate()
+		{
+			// com_maxfps only caps client rendering, the server loop follows the server tick rate
+			const auto tick_rate = get_tick_rate();
+			const auto frames = std::max(1u, std::min(frames_per_tick, max_frame_rate / tick_rate));
+			return tick_rate * frames;
+		}
+
 		void sync_gpu_stub()
 		{
-			std::this_thread::sleep_for(1ms);
+			get_frame_pacer().wait(get_frame_rate());
+		}
+
+		void print_frame_statistics(const command::params& params)
+		{
+			auto& pacer = get_frame_pacer();
+
+			if (params.size() > 1 && params.get(1) == "reset"s)
+			{
+				pacer.reset_statistics();
+				console::info("Frame statistics reset\n");
+				return;
+			}
+
+			const auto to_ms = [](const std::chrono::nanoseconds value)
+			{
+				return std::chrono::duration<double, std::milli>(value).count();
+			};
+
+			const auto& stats = pacer.get_statistics();
+			console::info("Target rate: %u fps (%u server ticks per second)\n", get_frame_rate(), get_tick_rate());
+			console::info("Frames: %llu, overruns: %llu, skipped frames: %llu\n", stats.ticks, stats.overruns, stats.skipped_ticks);
+			console::info("Lateness: %.3f ms average, %.3f ms max\n", to_ms(stats.get_average_lateness()), to_ms(stats.max_lateness));
+			console::info("Max overrun: %.3f ms\n", to_ms(stats.max_overrun));
 		}
 
 		void sv_kill_server_f()
@@ -168,11 +232,6 @@ namespace dedicated
 	class component final : public component_interface
 	{
 	public:
-		void* load_import(const std::string& library, const std::string& function) override
-		{
-			return nullptr;
-		}
-
 		void post_unpack() override
 		{
 			if (!game::environment::is_dedi())
@@ -193,6 +252,9 @@ namespace dedicated
 			// Don't allow sv_hostname to be changed by the game
 			dvars::disable::set_string("sv_hostname");
 
+			// Apply the patches below with a single protection change per page
+			utils::hook::transaction patches{};
+
 			// Hook R_SyncGpu
 			utils::hook::jump(0x1405A7630, sync_gpu_stub);
 
@@ -281,6 +343,8 @@ namespace dedicated
 			utils::hook::set<uint64_t>(0x1404D140D, 0x80000000);
 			utils::hook::set<uint64_t>(0x1404D14BF, 0x80000000);
 
+			patches.commit();
+
 			// initialize the game after onlinedataflags is 32 (workaround)
 			scheduler::schedule([=]()
 			{
@@ -318,6 +382,7 @@ namespace dedicated
 			}, scheduler::pipeline::main, 1s);
 
 			command::add("killserver", sv_kill_server_f);
+			command::add("sv_frameStats", print_frame_statistics);
 
 			command::add("map", [](const command::params& argument)
 			{
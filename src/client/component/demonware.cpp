@@ -386,27 +386,19 @@ namespace demonware
 			server_thread = utils::thread::create_named_thread("Demonware", server_main);
 		}
 
-		void* load_import(const std::string& library, const std::string& function) override
+		void post_start() override
 		{
-			if (library == "WS2_32.dll")
-			{
-				if (function == "#3") return io::closesocket_stub;
-				if (function == "#4") return io::connect_stub;
-				if (function == "#10") return io::ioctlsocket_stub;
-				if (function == "#16") return io::recv_stub;
-				if (function == "#17") return io::recvfrom_stub;
-				if (function == "#18") return io::select_stub;
-				if (function == "#19") return io::send_stub;
-				if (function == "#20") return io::sendto_stub;
-				if (function == "#52") return io::gethostbyname_stub;
-			}
-
-			if (function == "InternetGetConnectedState")
-			{
-				return io::internet_get_connected_state_stub;
-			}
-
-			return nullptr;
+			component_loader::register_import("WS2_32.dll", "#3", io::closesocket_stub);
+			component_loader::register_import("WS2_32.dll", "#4", io::connect_stub);
+			component_loader::register_import("WS2_32.dll", "#10", io::ioctlsocket_stub);
+			component_loader::register_import("WS2_32.dll", "#16", io::recv_stub);
+			component_loader::register_import("WS2_32.dll", "#17", io::recvfrom_stub);
+			component_loader::register_import("WS2_32.dll", "#18", io::select_stub);
+			component_loader::register_import("WS2_32.dll", "#19", io::send_stub);
+			component_loader::register_import("WS2_32.dll", "#20", io::sendto_stub);
+			component_loader::register_import("WS2_32.dll", "#52", io::gethostbyname_stub);
+
+			component_loader::register_import({}, "InternetGetConnectedState", io::internet_get_connected_state_stub);
 		}
 
 		void post_unpack() override
@@ -9,17 +9,394 @@
 #include <utils/concurrency.hpp>
 #include <utils/hook.hpp>
 #include <utils/io.hpp>
+#include <utils/latency_stats.hpp>
+#include <utils/memory.hpp>
+#include <utils/string.hpp>
 
 namespace fastfiles
 {
 	static utils::concurrency::container<std::string> current_fastfile;
 
+	constexpr int get_asset_type_size(const game::XAssetType type)
+	{
+		constexpr int asset_type_sizes[] =
+		{
+			96, 88, 128, 56, 40, 216, 56, 680,
+			480, 32, 32, 32, 32, 32, 352, 1456,
+			104, 32, 24, 152, 152, 152, 16, 64,
+			640, 40, 16, 408, 24, 288, 176, 2800,
+			48, -1, 40, 24, 200, 88, 16, 120,
+			3560, 32, 64, 16, 16, -1, -1, -1,
+			-1, 24, 40, 24, 40, 24, 128, 2256,
+			136, 32, 72, 24, 64, 88, 48, 32,
+			96, 152, 64, 32,
+		};
+
+		return asset_type_sizes[type];
+	}
+
 	namespace
 	{
+		constexpr auto pool_config_file = "players2/pool_sizes.json";
+
+		struct pool_usage
+		{
+			std::atomic_int live{0};
+			std::atomic_int peak{0};
+		};
+
+		struct pool_reference
+		{
+			size_t address;
+			size_t offset;
+		};
+
+		std::array<pool_usage, game::ASSET_TYPE_COUNT> pool_usages;
+
+		// Code that addresses a pool directly instead of going through DB_XAssetPool
+		const std::unordered_map<game::XAssetType, std::vector<pool_reference>>& get_pool_references()
+		{
+			static const std::unordered_map<game::XAssetType, std::vector<pool_reference>> references =
+			{
+				{
+					game::ASSET_TYPE_XMODEL,
+					{
+						{0x14026FD63, 8},
+						{0x14026FDB3, 8},
+						{0x14026FFAC, 8},
+						{0x14027463C, 8},
+						{0x140274689, 8},
+					},
+				},
+			};
+
+			return references;
+		}
+
+		// Pools that can be moved: every direct reference is patched, or the game only reaches them through DB_XAssetPool.
+		// Others, like weapon, localize or sound, are addressed elsewhere and crash on rejoin once moved.
+		bool is_pool_relocatable(const game::XAssetType type)
+		{
+			if (type == game::ASSET_TYPE_FONT)
+			{
+				return true;
+			}
+
+			// The known references are multiplayer addresses
+			return !game::environment::is_sp() && get_pool_references().contains(type);
+		}
+
+		// Only ever grows a pool and only runs before the first zone is loaded,
+		// the old storage stays untouched so nothing is invalidated on rejoin or map rotation
+		void reallocate_asset_pool(const game::XAssetType type, const int size)
+		{
+			const auto element_size = get_asset_type_size(type);
+			assert(element_size == game::DB_GetXAssetTypeSize(type));
+
+			if (element_size <= 0 || size <= game::g_poolSize[type])
+			{
+				return;
+			}
+
+			auto* new_pool = utils::memory::allocate_array<char>(static_cast<size_t>(element_size) * size);
+			std::memmove(new_pool, game::DB_XAssetPool[type], static_cast<size_t>(game::g_poolSize[type]) * element_size);
+
+			game::DB_XAssetPool[type] = new_pool;
+			game::g_poolSize[type] = size;
+
+			if (game::environment::is_sp())
+			{
+				return;
+			}
+
+			const auto& references = get_pool_references();
+			if (const auto references_entry = references.find(type); references_entry != references.end())
+			{
+				for (const auto& reference : references_entry->second)
+				{
+					utils::hook::inject(reference.address, new_pool + reference.offset);
+				}
+			}
+		}
+
+		std::optional<game::XAssetType> find_asset_type(const std::string& name)
+		{
+			for (auto i = 0; i < game::ASSET_TYPE_COUNT; ++i)
+			{
+				if (utils::string::to_lower(game::g_assetNames[i]) == utils::string::to_lower(name))
+				{
+					return static_cast<game::XAssetType>(i);
+				}
+			}
+
+			return {};
+		}
+
+		// Relocatable pool sizes can be raised through players2/pool_sizes.json, e.g. { "xmodel": 9500, "font": 64 }
+		void load_pool_config(std::unordered_map<game::XAssetType, int>& sizes)
+		{
+			std::string data{};
+			if (!utils::io::read_file(pool_config_file, &data))
+			{
+				return;
+			}
+
+			rapidjson::Document doc{};
+			const rapidjson::ParseResult parse_result = doc.Parse(data);
+			if (!parse_result || !doc.IsObject())
+			{
+				console::error("%s contains invalid data\n", pool_config_file);
+				return;
+			}
+
+			for (const auto& entry : doc.GetObj())
+			{
+				const auto type = find_asset_type(entry.name.GetString());
+				if (!type.has_value() || !entry.value.IsInt() || get_asset_type_size(*type) <= 0)
+				{
+					console::warn("%s: ignoring pool '%s'\n", pool_config_file, entry.name.GetString());
+					continue;
+				}
+
+				if (!is_pool_relocatable(*type))
+				{
+					console::error("%s: the '%s' pool can't be resized, the game references it directly\n",
+						pool_config_file, entry.name.GetString());
+					continue;
+				}
+
+				auto& size = sizes[*type];
+				size = std::max(size, entry.value.GetInt());
+			}
+		}
+
+		void reallocate_asset_pools()
+		{
+			std::unordered_map<game::XAssetType, int> sizes;
+			sizes[game::ASSET_TYPE_FONT] = 48;
+
+			if (!game::environment::is_sp())
+			{
+				sizes[game::ASSET_TYPE_XMODEL] = 8832;
+
+				// Reallocate asset pools
+				// Disabled because it causes a crash in the main menu once you rejoin a server after
+				// disconnecting and waiting for the server to map rotating.
+#if 0
+				sizes[game::ASSET_TYPE_LUA_FILE] = 768;
+				sizes[game::ASSET_TYPE_WEAPON] = 1400;
+				sizes[game::ASSET_TYPE_LOCALIZE_ENTRY] = 27200;
+				sizes[game::ASSET_TYPE_XANIMPARTS] = 11600;
+				sizes[game::ASSET_TYPE_ATTACHMENT] = 256;
+				sizes[game::ASSET_TYPE_FONT] = 96;
+				sizes[game::ASSET_TYPE_SNDDRIVER_GLOBALS] = 4;
+				sizes[game::ASSET_TYPE_EQUIPMENT_SND_TABLE] = 4;
+				sizes[game::ASSET_TYPE_SOUND] = 32000;
+				sizes[game::ASSET_TYPE_LOADED_SOUND] = 14000;
+				sizes[game::ASSET_TYPE_VERTEXDECL] = 3072;
+				sizes[game::ASSET_TYPE_COMPUTESHADER] = 1024;
+				sizes[game::ASSET_TYPE_REVERB_PRESET] = 128;
+				sizes[game::ASSET_TYPE_IMPACT_FX] = 40;
+#endif
+			}
+
+			load_pool_config(sizes);
+
+			for (const auto& [type, size] : sizes)
+			{
+				reallocate_asset_pool(type, size);
+			}
+		}
+
+		void sample_pool_usage()
+		{
+			for (auto i = 0; i < game::ASSET_TYPE_COUNT; ++i)
+			{
+				if (game::g_poolSize[i] <= 0 || get_asset_type_size(static_cast<game::XAssetType>(i)) <= 0)
+				{
+					continue;
+				}
+
+				auto count = 0;
+				game::DB_EnumXAssets_Internal(static_cast<game::XAssetType>(i), static_cast<void(*)(game::XAssetHeader, void*)>([](game::XAssetHeader, void* data)
+				{
+					++*static_cast<int*>(data);
+				}), &count, true);
+
+				auto& usage = pool_usages[i];
+				usage.live = count;
+
+				auto peak = usage.peak.load();
+				while (count > peak && !usage.peak.compare_exchange_weak(peak, count))
+				{
+				}
+			}
+		}
+
+		void print_pool_sizes()
+		{
+			sample_pool_usage();
+
+			size_t allocated_bytes = 0;
+			size_t peak_bytes = 0;
+
+			for (auto i = 0; i < game::ASSET_TYPE_COUNT; i++)
+			{
+				const auto size = game::g_poolSize[i];
+				const auto live = pool_usages[i].live.load();
+				const auto peak = pool_usages[i].peak.load();
+				const auto element_size = std::max(get_asset_type_size(static_cast<game::XAssetType>(i)), 0);
+
+				allocated_bytes += static_cast<size_t>(size) * element_size;
+				peak_bytes += static_cast<size_t>(peak) * element_size;
+
+				console::print(size && peak * 10 >= size * 9 ? console::con_type_warning : console::con_type_info,
+					"g_poolSize[%i]: %i, used %i, peak %i // %s\n", i, size, live, peak, game::g_assetNames[i]);
+			}
+
+			console::info("Pool memory: %zu KB allocated, %zu KB used at peak\n", allocated_bytes / 1024, peak_bytes / 1024);
+			console::info("Usage is sampled after each zone load and by this command, not when zones are unloaded\n");
+		}
+
 		utils::hook::detour db_try_load_x_file_internal_hook;
 		utils::hook::detour db_find_x_asset_header_hook;
 		utils::hook::detour db_read_stream_file_hook;
 
+		const game::dvar_t* db_profile_assets;
+
+		constexpr std::size_t slowest_asset_count = 32;
+		constexpr auto asset_stats_folder = "asset_stats";
+
+		struct zone_load
+		{
+			std::string name;
+			std::uint64_t duration_ns;
+		};
+
+		std::array<utils::latency_stats::histogram, game::ASSET_TYPE_COUNT> asset_latencies;
+		utils::latency_stats::slowest_list slowest_assets{slowest_asset_count};
+		utils::concurrency::container<std::vector<zone_load>> zone_loads;
+
+		std::uint64_t to_ns(const std::chrono::steady_clock::duration duration)
+		{
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		}
+
+		void record_asset_lookup(const game::XAssetType type, const char* name, const std::uint64_t duration_ns)
+		{
+			if (static_cast<std::size_t>(type) >= asset_latencies.size())
+			{
+				return;
+			}
+
+			asset_latencies[type].record(duration_ns);
+			slowest_assets.record(type, name ? name : "", duration_ns);
+		}
+
+		void reset_asset_stats()
+		{
+			for (auto& latency : asset_latencies)
+			{
+				latency.reset();
+			}
+
+			slowest_assets.reset();
+
+			zone_loads.access([](std::vector<zone_load>& zones)
+			{
+				zones.clear();
+			});
+		}
+
+		// Only plain file names, so the command can't write outside of the stats folder
+		std::optional<std::string> get_asset_stats_path(const std::string& file)
+		{
+			const std::filesystem::path path(file);
+			if (file.empty() || path != path.filename() || path == "." || path == "..")
+			{
+				return {};
+			}
+
+			return (std::filesystem::path(asset_stats_folder) / path).generic_string();
+		}
+
+		double to_ms(const std::uint64_t duration_ns)
+		{
+			return static_cast<double>(duration_ns) / 1'000'000.0;
+		}
+
+		std::string build_asset_stats_csv()
+		{
+			using utils::string::quote_csv;
+
+			std::string buffer = "section,name,type,count,total_ms,avg_ms,p50_ms,p99_ms,max_ms\n";
+
+			for (auto i = 0; i < game::ASSET_TYPE_COUNT; ++i)
+			{
+				const auto& latency = asset_latencies[i];
+				const auto count = latency.get_count();
+				if (!count)
+				{
+					continue;
+				}
+
+				const auto total = latency.get_total();
+				buffer.append(std::format("type,,{},{},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}\n", quote_csv(game::g_assetNames[i]), count,
+					to_ms(total), to_ms(total / count), to_ms(latency.get_percentile(50)), to_ms(latency.get_percentile(99)),
+					to_ms(latency.get_max())));
+			}
+
+			for (const auto& asset : slowest_assets.get())
+			{
+				buffer.append(std::format("asset,{},{},1,{:.3f},,,,\n", quote_csv(asset.name), quote_csv(game::g_assetNames[asset.category]),
+					to_ms(asset.duration_ns)));
+			}
+
+			zone_loads.access([&](const std::vector<zone_load>& zones)
+			{
+				for (const auto& zone : zones)
+				{
+					buffer.append(std::format("zone,{},,1,{:.3f},,,,\n", quote_csv(zone.name), to_ms(zone.duration_ns)));
+				}
+			});
+
+			return buffer;
+		}
+
+		void print_asset_stats()
+		{
+			console::info("Asset lookups per type (%s):\n", db_profile_assets->current.enabled ? "profiling" : "profiling disabled");
+
+			for (auto i = 0; i < game::ASSET_TYPE_COUNT; ++i)
+			{
+				const auto& latency = asset_latencies[i];
+				const auto count = latency.get_count();
+				if (!count)
+				{
+					continue;
+				}
+
+				console::info("  %-24s %8llu lookups, avg %.3f ms, p50 <%.3f ms, p99 <%.3f ms, max %.3f ms\n", game::g_assetNames[i], count,
+					to_ms(latency.get_total() / count), to_ms(latency.get_percentile(50)), to_ms(latency.get_percentile(99)),
+					to_ms(latency.get_max()));
+			}
+
+			console::info("Slowest assets:\n");
+			for (const auto& asset : slowest_assets.get())
+			{
+				console::info("  %9.3f ms  %s (%s)\n", to_ms(asset.duration_ns), asset.name.data(), game::g_assetNames[asset.category]);
+			}
+
+			console::info("Zone loads:\n");
+			zone_loads.access([](const std::vector<zone_load>& zones)
+			{
+				for (const auto& zone : zones)
+				{
+					console::info("  %9.3f ms  %s\n", to_ms(zone.duration_ns), zone.name.data());
+				}
+			});
+		}
+
 		int db_read_stream_file_stub(int allow_abort, int finish)
 		{
 			// always use lz4 compressor type when reading stream files
@@ -34,7 +411,21 @@ namespace fastfiles
 			{
 				fastfile = zone_name;
 			});
-			return db_try_load_x_file_internal_hook.invoke<void>(zone_name, flags);
+
+			const auto start = std::chrono::steady_clock::now();
+			db_try_load_x_file_internal_hook.invoke<void>(zone_name, flags);
+
+			// Loading happens synchronously on this thread, so pools are at their fullest right now
+			sample_pool_usage();
+
+			if (db_profile_assets->current.enabled)
+			{
+				const auto duration_ns = to_ns(std::chrono::steady_clock::now() - start);
+				zone_loads.access([&](std::vector<zone_load>& zones)
+				{
+					zones.emplace_back(zone_load{zone_name, duration_ns});
+				});
+			}
 		}
 
 		void dump_gsc_script(const std::string& name, game::XAssetHeader header)
@@ -60,20 +451,25 @@ namespace fastfiles
 
 		game::XAssetHeader db_find_x_asset_header_stub(game::XAssetType type, const char* name, int allow_create_default)
 		{
-			const auto start = game::Sys_Milliseconds();
+			const auto start = std::chrono::steady_clock::now();
 			const auto result = db_find_x_asset_header_hook.invoke<game::XAssetHeader>(type, name, allow_create_default);
-			const auto diff = game::Sys_Milliseconds() - start;
+			const auto diff = std::chrono::steady_clock::now() - start;
+
+			if (db_profile_assets->current.enabled)
+			{
+				record_asset_lookup(type, name, to_ns(diff));
+			}
 
 			if (type == game::ASSET_TYPE_SCRIPTFILE)
 			{
 				dump_gsc_script(name, result);
 			}
 
-			if (diff > 100)
+			if (diff > 100ms)
 			{
 				console::print(
-					result.data == nullptr ? console::con_type_error : console::con_type_warning, "Waited %i msec for asset '%s' of type '%s'.\n",
-					diff,
+					result.data == nullptr ? console::con_type_error : console::con_type_warning, "Waited %lld msec for asset '%s' of type '%s'.\n",
+					std::chrono::duration_cast<std::chrono::milliseconds>(diff).count(),
 					name,
 					game::g_assetNames[type]
 				);
@@ -93,39 +489,6 @@ namespace fastfiles
 		return fastfile_copy;
 	}
 
-	constexpr int get_asset_type_size(const game::XAssetType type)
-	{
-		constexpr int asset_type_sizes[] =
-		{
-			96, 88, 128, 56, 40, 216, 56, 680,
-			480, 32, 32, 32, 32, 32, 352, 1456,
-			104, 32, 24, 152, 152, 152, 16, 64,
-			640, 40, 16, 408, 24, 288, 176, 2800,
-			48, -1, 40, 24, 200, 88, 16, 120,
-			3560, 32, 64, 16, 16, -1, -1, -1,
-			-1, 24, 40, 24, 40, 24, 128, 2256,
-			136, 32, 72, 24, 64, 88, 48, 32,
-			96, 152, 64, 32,
-		};
-
-		return asset_type_sizes[type];
-	}
-
-	template <game::XAssetType Type, size_t Size>
-	char* reallocate_asset_pool()
-	{
-		constexpr auto element_size = get_asset_type_size(Type);
-		static char new_pool[element_size * Size]{0};
-		assert(get_asset_type_size(Type) == game::DB_GetXAssetTypeSize(Type));
-
-		std::memmove(new_pool, game::DB_XAssetPool[Type], game::g_poolSize[Type] * element_size);
-
-		game::DB_XAssetPool[Type] = new_pool;
-		game::g_poolSize[Type] = Size;
-
-		return new_pool;
-	}
-
 	void enum_assets(const game::XAssetType type, const std::function<void(game::XAssetHeader)>& callback, const bool include_override)
 	{
 		game::DB_EnumXAssets_Internal(type, static_cast<void(*)(game::XAssetHeader, void*)>([](game::XAssetHeader header, void* data)
@@ -144,48 +507,56 @@ namespace fastfiles
 
 			db_find_x_asset_header_hook.create(game::DB_FindXAssetHeader, db_find_x_asset_header_stub);
 			dvars::g_dump_scripts = game::Dvar_RegisterBool("g_dumpScripts", false, game::DVAR_FLAG_NONE);
+			db_profile_assets = game::Dvar_RegisterBool("db_profileAssets", false, game::DVAR_FLAG_NONE);
+
+			command::add("db_assetStats", [](const command::params& params)
+			{
+				if (params.size() < 2)
+				{
+					print_asset_stats();
+					return;
+				}
+
+				if (params.get(1) != "csv"s)
+				{
+					console::info("USAGE: db_assetStats [csv <file>]\n");
+					return;
+				}
 
-			command::add("g_poolSizes", []()
+				const auto path = get_asset_stats_path(params.size() > 2 ? params.get(2) : "asset_stats.csv");
+				if (!path.has_value())
+				{
+					console::error("The file name can't contain a path, stats are always written to %s\n", asset_stats_folder);
+					return;
+				}
+
+				if (!utils::io::write_file(*path, build_asset_stats_csv()))
+				{
+					console::error("Failed to write %s\n", path->data());
+					return;
+				}
+
+				console::info("Asset stats written to %s\n", path->data());
+			});
+
+			command::add("db_assetStatsReset", reset_asset_stats);
+
+			command::add("g_poolSizes", print_pool_sizes);
+			command::add("g_poolUsageReset", []()
 			{
-				for (auto i = 0; i < game::ASSET_TYPE_COUNT; i++)
+				for (auto& usage : pool_usages)
 				{
-					console::info("g_poolSize[%i]: %i // %s\n", i, game::g_poolSize[i], game::g_assetNames[i]);
+					usage.peak = usage.live.load();
 				}
 			});
 
 			// Allow loading of mixed compressor types
 			utils::hook::nop(SELECT_VALUE(0x1401536D7, 0x140242DF7), 2);
 
-			reallocate_asset_pool<game::ASSET_TYPE_FONT, 48>();
+			reallocate_asset_pools();
 
 			if (!game::environment::is_sp())
 			{
-				const auto* xmodel_pool = reallocate_asset_pool<game::ASSET_TYPE_XMODEL, 8832>();
-				utils::hook::inject(0x14026FD63, xmodel_pool + 8);
-				utils::hook::inject(0x14026FDB3, xmodel_pool + 8);
-				utils::hook::inject(0x14026FFAC, xmodel_pool + 8);
-				utils::hook::inject(0x14027463C, xmodel_pool + 8);
-				utils::hook::inject(0x140274689, xmodel_pool + 8);
-
-				// Reallocate asset pools
-				// Disabled because it causes a crash in the main menu once you rejoin a server after
-				// disconnecting and waiting for the server to map rotating.
-#if 0
-				reallocate_asset_pool<game::ASSET_TYPE_LUA_FILE, 768>();
-				reallocate_asset_pool<game::ASSET_TYPE_WEAPON, 1400>();
-				reallocate_asset_pool<game::ASSET_TYPE_LOCALIZE_ENTRY, 27200>();
-				reallocate_asset_pool<game::ASSET_TYPE_XANIMPARTS, 11600>();
-				reallocate_asset_pool<game::ASSET_TYPE_ATTACHMENT, 256>();
-				reallocate_asset_pool<game::ASSET_TYPE_FONT, 96>();
-				reallocate_asset_pool<game::ASSET_TYPE_SNDDRIVER_GLOBALS, 4>();
-				reallocate_asset_pool<game::ASSET_TYPE_EQUIPMENT_SND_TABLE, 4>();
-				reallocate_asset_pool<game::ASSET_TYPE_SOUND, 32000>();
-				reallocate_asset_pool<game::ASSET_TYPE_LOADED_SOUND, 14000>();
-				reallocate_asset_pool<game::ASSET_TYPE_VERTEXDECL, 3072>();
-				reallocate_asset_pool<game::ASSET_TYPE_COMPUTESHADER, 1024>();
-				reallocate_asset_pool<game::ASSET_TYPE_REVERB_PRESET, 128>();
-				reallocate_asset_pool<game::ASSET_TYPE_IMPACT_FX, 40>();
-#endif
 				// Fix compressor type on streamed file load
 				db_read_stream_file_hook.create(0x14027AA70, db_read_stream_file_stub);
 
@@ -10,7 +10,7 @@
 
 #include <utils/string.hpp>
 #include <utils/hook.hpp>
-#include <utils/concurrency.hpp>
+#include <utils/output_history.hpp>
 
 #include "version.hpp"
 
@@ -32,7 +32,10 @@ namespace game_console
 			int info_line_count{};
 		};
 
-		using output_queue = std::deque<std::string>;
+		constexpr size_t default_output_lines = 512;
+		constexpr size_t max_output_lines = 0x10000;
+
+		using utils::output_history;
 
 		struct ingame_console
 		{
@@ -45,9 +48,11 @@ namespace game_console
 			float screen_max[2]{}; //right & bottom
 			console_globals globals{};
 			bool output_visible{};
-			int display_line_offset{};
 			int line_count{};
-			utils::concurrency::container<output_queue, std::recursive_mutex> output{};
+			std::mutex output_mutex{};
+			std::atomic<std::shared_ptr<output_history>> output{
+				std::make_shared<output_history>(default_output_lines)
+			};
 		};
 
 		ingame_console con{};
@@ -70,21 +75,71 @@ namespace game_console
 			matches.clear();
 		}
 
-		void print_internal(const std::string& data)
+		// Must be called with the output mutex held
+		std::shared_ptr<output_history> get_output_for_write()
 		{
-			con.output.access([&](output_queue& output)
+			auto output = con.output.load();
+
+			const auto capacity = dvars::con_outputMaxLines
+				                      ? static_cast<size_t>(dvars::con_outputMaxLines->current.integer)
+				                      : output->capacity();
+
+			if (capacity != output->capacity())
 			{
-				if (con.visible_line_count > 0
-					&& con.display_line_offset == (output.size() - con.visible_line_count))
-				{
-					con.display_line_offset++;
-				}
-				output.push_back(data);
-				if (output.size() > 512)
+				auto resized = std::make_shared<output_history>(capacity);
+				output->for_each(output->end() - std::min(output->end() - output->begin(), capacity),
+				                 [&](const std::string_view& line)
+				                 {
+					                 resized->append({}, line);
+				                 });
+
+				con.output.store(resized);
+				output = std::move(resized);
+			}
+
+			return output;
+		}
+
+		void print_lines(const std::string_view& prefix, const std::string_view& data)
+		{
+			std::lock_guard _(con.output_mutex);
+			const auto output = get_output_for_write();
+
+			size_t start = 0;
+			while (start < data.size())
+			{
+				auto end = data.find('\n', start);
+				if (end == std::string_view::npos)
 				{
-					output.pop_front();
+					end = data.size();
 				}
-			});
+
+				output->append(prefix, data.substr(start, end - start));
+				start = end + 1;
+			}
+		}
+
+		void clear_output()
+		{
+			std::lock_guard _(con.output_mutex);
+
+			const auto capacity = con.output.load()->capacity();
+			con.output.store(std::make_shared<output_history>(capacity));
+		}
+
+		size_t get_visible_line_count()
+		{
+			return static_cast<size_t>(std::max(con.visible_line_count, 0));
+		}
+
+		size_t get_first_visible_line(const output_history& output)
+		{
+			return output.get_first_visible_line(get_visible_line_count());
+		}
+
+		void scroll_output(const int lines)
+		{
+			con.output.load()->scroll(lines, get_visible_line_count());
 		}
 
 		void toggle_console()
@@ -279,20 +334,22 @@ namespace game_console
 			}
 		}
 
-		void draw_output_scrollbar(const float x, float y, const float width, const float height, output_queue& output)
+		void draw_output_scrollbar(const float x, float y, const float width, const float height,
+		                           const output_history::snapshot& output)
 		{
 			const auto _x = (x + width) - 10.0f;
 			draw_box(_x, y, 10.0f, height, dvars::con_outputBarColor->current.vector);
 
 			auto _height = height;
-			if (output.size() > con.visible_line_count)
+			const auto visible_lines = static_cast<size_t>(std::max(con.visible_line_count, 0));
+			if (output.total > visible_lines)
 			{
-				const auto percentage = static_cast<float>(con.visible_line_count) / output.size();
+				const auto percentage = static_cast<float>(visible_lines) / output.total;
 				_height *= percentage;
 
 				const auto remainingSpace = height - _height;
-				const auto percentageAbove = static_cast<float>(con.display_line_offset) / (output.size() - con.
-					visible_line_count);
+				const auto percentageAbove = static_cast<float>(output.first - output.begin) / (output.total -
+					visible_lines);
 
 				y = y + (remainingSpace * percentageAbove);
 			}
@@ -300,46 +357,48 @@ namespace game_console
 			draw_box(_x, y, 10.0f, _height, dvars::con_outputSliderColor->current.vector);
 		}
 
-		void draw_output_text(const float x, float y, output_queue& output)
+		void draw_output_text(const float x, float y, const output_history::snapshot& output)
 		{
-			const auto offset = output.size() >= con.visible_line_count
+			const auto offset = output.lines.size() >= static_cast<size_t>(con.visible_line_count)
 				                    ? 0.0f
-				                    : (con.font_height * (con.visible_line_count - output.size()));
+				                    : (con.font_height * (con.visible_line_count - output.lines.size()));
 
-			for (auto i = 0; i < con.visible_line_count; i++)
+			for (const auto& [text_offset, length] : output.lines)
 			{
 				y = console_font->pixelHeight + y;
 
-				const auto index = i + con.display_line_offset;
-				if (index >= output.size())
-				{
-					break;
-				}
-
-				game::R_AddCmdDrawText(output.at(index).data(), 0x7FFF, console_font, x, y + offset, 1.0f, 1.0f,
-				                       0.0f, color_white, 0);
+				game::R_AddCmdDrawText(output.text.data() + text_offset, static_cast<int>(length), console_font, x,
+				                       y + offset, 1.0f, 1.0f, 0.0f, color_white, 0);
 			}
 		}
 
 		void draw_output_window()
 		{
-			con.output.access([](output_queue& output)
+			static output_history::snapshot snapshot{};
+			static output_history::snapshot scratch{};
+
+			// Keep showing the previous snapshot if writers are too busy to get a consistent copy
+			const auto output = con.output.load();
+			const auto first = get_first_visible_line(*output);
+			if (output->read(first, static_cast<size_t>(std::max(con.visible_line_count, 0)), scratch))
 			{
-				draw_box(con.screen_min[0], con.screen_min[1] + 32.0f, con.screen_max[0] - con.screen_min[0],
-				         (con.screen_max[1] - con.screen_min[1]) - 32.0f, dvars::con_outputWindowColor->current.vector);
+				std::swap(snapshot, scratch);
+			}
 
-				const auto x = con.screen_min[0] + 6.0f;
-				const auto y = (con.screen_min[1] + 32.0f) + 6.0f;
-				const auto width = (con.screen_max[0] - con.screen_min[0]) - 12.0f;
-				const auto height = ((con.screen_max[1] - con.screen_min[1]) - 32.0f) - 12.0f;
+			draw_box(con.screen_min[0], con.screen_min[1] + 32.0f, con.screen_max[0] - con.screen_min[0],
+			         (con.screen_max[1] - con.screen_min[1]) - 32.0f, dvars::con_outputWindowColor->current.vector);
 
-				game::R_AddCmdDrawText(game::Dvar_FindVar("version")->current.string, 0x7FFFFFFF, console_font, x,
-				                       ((height - 12.0f) + y) + console_font->pixelHeight, 1.0f, 1.0f, 0.0f, color_s1,
-				                       0);
+			const auto x = con.screen_min[0] + 6.0f;
+			const auto y = (con.screen_min[1] + 32.0f) + 6.0f;
+			const auto width = (con.screen_max[0] - con.screen_min[0]) - 12.0f;
+			const auto height = ((con.screen_max[1] - con.screen_min[1]) - 32.0f) - 12.0f;
 
-				draw_output_scrollbar(x, y, width, height, output);
-				draw_output_text(x, y, output);
-			});
+			game::R_AddCmdDrawText(game::Dvar_FindVar("version")->current.string, 0x7FFFFFFF, console_font, x,
+			                       ((height - 12.0f) + y) + console_font->pixelHeight, 1.0f, 1.0f, 0.0f, color_s1,
+			                       0);
+
+			draw_output_scrollbar(x, y, width, height, snapshot);
+			draw_output_text(x, y, snapshot);
 		}
 
 		void draw_console()
@@ -372,13 +431,7 @@ namespace game_console
 		vsnprintf(va_buffer, sizeof(va_buffer), fmt, ap);
 		va_end(ap);
 
-		const auto formatted = std::string(va_buffer);
-		const auto lines = utils::string::split(formatted, '\n');
-
-		for (const auto& line : lines)
-		{
-			print_internal(line);
-		}
+		print_lines({}, va_buffer);
 	}
 
 	void print(const int type, const std::string& data)
@@ -395,11 +448,14 @@ namespace game_console
 			return;
 		}
 
-		const auto lines = utils::string::split(data, '\n');
-		for (const auto& line : lines)
+		if (type == console::con_type_info)
 		{
-			print_internal(type == console::con_type_info ? line : "^"s.append(std::to_string(type)).append(line));
+			print_lines({}, data);
+			return;
 		}
+
+		const char prefix[] = {'^', static_cast<char>('0' + type % 10)};
+		print_lines({prefix, sizeof(prefix)}, data);
 	}
 
 	bool console_char_event(const int local_client_num, const int key)
@@ -456,11 +512,7 @@ namespace game_console
 			{
 				clear();
 				con.line_count = 0;
-				con.display_line_offset = 0;
-				con.output.access([](output_queue& output)
-				{
-					output.clear();
-				});
+				clear_output();
 				history_index = -1;
 				history.clear();
 
@@ -593,24 +645,11 @@ namespace game_console
 				//scroll through output
 				if (key == game::keyNum_t::K_MWHEELUP || key == game::keyNum_t::K_PGUP)
 				{
-					con.output.access([](output_queue& output)
-					{
-						if (output.size() > con.visible_line_count && con.display_line_offset > 0)
-						{
-							con.display_line_offset--;
-						}
-					});
+					scroll_output(-1);
 				}
 				else if (key == game::keyNum_t::K_MWHEELDOWN || key == game::keyNum_t::K_PGDN)
 				{
-					con.output.access([](output_queue& output)
-					{
-						if (output.size() > con.visible_line_count
-							&& con.display_line_offset < (output.size() - con.visible_line_count))
-						{
-							con.display_line_offset++;
-						}
-					});
+					scroll_output(1);
 				}
 
 				if (key == game::keyNum_t::K_ENTER)
@@ -718,7 +757,6 @@ namespace game_console
 			con.cursor = 0;
 			con.visible_line_count = 0;
 			con.output_visible = false;
-			con.display_line_offset = 0;
 			con.line_count = 0;
 			game::I_strncpyz(con.buffer, "", sizeof(con.buffer));
 
@@ -735,11 +773,7 @@ namespace game_console
 			{
 				clear();
 				con.line_count = 0;
-				con.display_line_offset = 0;
-				con.output.access([](output_queue& output)
-				{
-					output.clear();
-				});
+				clear_output();
 				history_index = -1;
 				history.clear();
 			});
@@ -770,6 +804,10 @@ namespace game_console
 			dvars::con_inputCmdMatchColor = game::Dvar_RegisterVec4("con_inputCmdMatchColor", 0.80f, 0.80f, 1.0f, 1.0f,
 			                                                        0.0f,
 			                                                        1.0f, game::DVAR_FLAG_SAVED);
+			dvars::con_outputMaxLines = game::Dvar_RegisterInt("con_outputMaxLines",
+			                                                   static_cast<int>(default_output_lines), 64,
+			                                                   static_cast<int>(max_output_lines),
+			                                                   game::DVAR_FLAG_SAVED);
 		}
 	};
 }
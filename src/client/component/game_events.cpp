@@ -0,0 +1,519 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "command.hpp"
+#include "console.hpp"
+#include "game_events.hpp"
+#include "scheduler.hpp"
+
+#include <utils/concurrency.hpp>
+#include <utils/string.hpp>
+#include <utils/thread.hpp>
+
+namespace game_events
+{
+	namespace
+	{
+		// Larger datagrams risk fragmentation, batches are split on line boundaries
+		constexpr std::size_t max_datagram_size = 1400;
+
+		struct event_chunk
+		{
+			uint16_t length;
+			char data[0xFE];
+		};
+
+		// Events are serialized on the server thread and written out by the writer thread
+		utils::concurrency::ring_queue<event_chunk, 0x4000> event_queue;
+
+		struct sink_config
+		{
+			std::string path;
+			std::optional<sockaddr> address;
+		};
+
+		utils::concurrency::container<sink_config> config;
+
+		const game::dvar_t* g_event_log;
+		const game::dvar_t* g_event_log_address;
+
+		std::atomic_bool enabled{false};
+		std::atomic_bool terminate_writer{false};
+		std::thread writer_thread;
+
+		std::atomic_uint64_t events_emitted{0};
+		std::atomic_uint64_t events_written{0};
+		std::atomic_uint64_t events_dropped{0};
+
+		using json_writer = rapidjson::Writer<rapidjson::StringBuffer>;
+
+		void emit(const rapidjson::StringBuffer& buffer)
+		{
+			std::string line(buffer.GetString(), buffer.GetSize());
+			line.push_back('\n');
+
+			if (utils::concurrency::push_chunked(event_queue, line))
+			{
+				++events_emitted;
+			}
+		}
+
+		void write_string(json_writer& writer, const std::string_view value)
+		{
+			writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+		}
+
+		void write_number(json_writer& writer, const std::string_view value)
+		{
+			auto number = 0;
+			const auto result = std::from_chars(value.data(), value.data() + value.size(), number);
+			if (result.ec == std::errc{} && result.ptr == value.data() + value.size())
+			{
+				writer.Int(number);
+			}
+			else
+			{
+				write_string(writer, value);
+			}
+		}
+
+		const char* get_dvar_string(const char* name)
+		{
+			const auto* dvar = game::Dvar_FindVar(name);
+			return dvar ? dvar->current.string : "";
+		}
+
+		void begin_event(json_writer& writer, const char* type)
+		{
+			writer.StartObject();
+			writer.Key("type");
+			writer.String(type);
+			writer.Key("time");
+			writer.Int(*game::level_time);
+		}
+
+		class log_fields final
+		{
+		public:
+			explicit log_fields(const std::string_view line)
+			{
+				for (const auto field : utils::string::split_view(line, ';'))
+				{
+					this->fields_.emplace_back(field);
+				}
+			}
+
+			[[nodiscard]] std::size_t size() const
+			{
+				return this->fields_.size();
+			}
+
+			// Trailing empty fields are not split off, so they read as empty here
+			std::string_view operator[](const std::size_t index) const
+			{
+				return index < this->fields_.size() ? this->fields_[index] : std::string_view{};
+			}
+
+		private:
+			std::vector<std::string_view> fields_;
+		};
+
+		void write_player(json_writer& writer, const char* key, const log_fields& fields, const std::size_t offset, const bool has_team)
+		{
+			writer.Key(key);
+			writer.StartObject();
+			writer.Key("guid");
+			write_string(writer, fields[offset]);
+			writer.Key("num");
+			write_number(writer, fields[offset + 1]);
+
+			if (has_team)
+			{
+				writer.Key("team");
+				write_string(writer, fields[offset + 2]);
+			}
+
+			writer.Key("name");
+			write_string(writer, fields[offset + (has_team ? 3 : 2)]);
+			writer.EndObject();
+		}
+
+		// K;victim guid;num;team;name;attacker guid;num;team;name;weapon;damage;means of death;hit location
+		void write_hit(json_writer& writer, const log_fields& fields)
+		{
+			write_player(writer, "victim", fields, 1, true);
+			write_player(writer, "attacker", fields, 5, true);
+
+			writer.Key("weapon");
+			write_string(writer, fields[9]);
+			writer.Key("damage");
+			write_number(writer, fields[10]);
+			writer.Key("mod");
+			write_string(writer, fields[11]);
+			writer.Key("hitloc");
+			write_string(writer, fields[12]);
+		}
+
+		void write_raw_fields(json_writer& writer, const log_fields& fields)
+		{
+			writer.Key("fields");
+			writer.StartArray();
+			for (std::size_t i = 1; i < fields.size(); ++i)
+			{
+				write_string(writer, fields[i]);
+			}
+
+			writer.EndArray();
+		}
+
+		class event_writer final
+		{
+		public:
+			event_writer()
+			{
+				// The writer can start before the game initialized Winsock
+				WSADATA wsa_data{};
+				this->wsa_started_ = WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0;
+
+				this->socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+				if (this->socket_ != INVALID_SOCKET)
+				{
+					// A consumer that can't keep up must not stall the writer
+					u_long non_blocking = 1;
+					ioctlsocket(this->socket_, FIONBIO, &non_blocking);
+				}
+			}
+
+			~event_writer()
+			{
+				if (this->socket_ != INVALID_SOCKET)
+				{
+					closesocket(this->socket_);
+				}
+
+				if (this->wsa_started_)
+				{
+					WSACleanup();
+				}
+			}
+
+			event_writer(const event_writer&) = delete;
+			event_writer& operator=(const event_writer&) = delete;
+
+			void flush()
+			{
+				this->batch_.clear();
+
+				event_queue.consume([this](const event_chunk& chunk)
+				{
+					this->batch_.append(chunk.data, chunk.length);
+				});
+
+				// Only these lines are events, the marker below isn't counted as one
+				this->event_bytes_ = this->batch_.size();
+				const auto event_count = static_cast<std::uint64_t>(std::ranges::count(this->batch_, '\n'));
+
+				if (const auto dropped = event_queue.take_dropped())
+				{
+					events_dropped += dropped;
+
+					// Lets consumers notice the gap in the stream
+					this->batch_.append(utils::string::va("{\"type\":\"dropped\",\"count\":%zu}\n", dropped));
+				}
+
+				if (this->batch_.empty())
+				{
+					return;
+				}
+
+				const auto current_config = config.access<sink_config>([](const sink_config& value)
+				{
+					return value;
+				});
+
+				// An event is written once any sink accepted it, and dropped when none did
+				auto accepted = this->write_file(current_config.path) ? event_count : 0;
+
+				if (current_config.address.has_value())
+				{
+					accepted = std::max(accepted, this->send_batch(*current_config.address));
+				}
+
+				events_written += accepted;
+				events_dropped += event_count - accepted;
+			}
+
+		private:
+			std::string batch_;
+			std::size_t event_bytes_{};
+			std::string file_path_;
+			std::ofstream file_;
+			SOCKET socket_{INVALID_SOCKET};
+			bool wsa_started_{};
+
+			bool write_file(const std::string& path)
+			{
+				if (path != this->file_path_)
+				{
+					this->file_.close();
+					this->file_path_ = path;
+
+					if (!path.empty())
+					{
+						std::error_code ec{};
+						std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+						this->file_.open(path, std::ios::binary | std::ios::app);
+					}
+				}
+
+				if (!this->file_.is_open())
+				{
+					return false;
+				}
+
+				this->file_.write(this->batch_.data(), static_cast<std::streamsize>(this->batch_.size()));
+				this->file_.flush();
+
+				if (!this->file_)
+				{
+					// Reopen on the next flush, the disk might have been full only for a moment
+					this->file_.close();
+					this->file_path_.clear();
+					return false;
+				}
+
+				return true;
+			}
+
+			// Returns how many events were handed to the network stack
+			std::uint64_t send_batch(const sockaddr& address)
+			{
+				if (this->socket_ == INVALID_SOCKET)
+				{
+					return 0;
+				}
+
+				std::uint64_t sent = 0;
+
+				std::string_view pending = this->batch_;
+				while (!pending.empty())
+				{
+					auto size = pending.size();
+					if (size > max_datagram_size)
+					{
+						// Lines longer than a datagram are sent on their own
+						const auto end = pending.rfind('\n', max_datagram_size - 1);
+						size = end != std::string_view::npos ? end + 1 : std::min(pending.find('\n'), pending.size() - 1) + 1;
+					}
+
+					const auto offset = this->batch_.size() - pending.size();
+					const auto datagram = pending.substr(0, size);
+					pending.remove_prefix(size);
+
+					if (sendto(this->socket_, datagram.data(), static_cast<int>(datagram.size()), 0, &address, sizeof(address)) >= 0)
+					{
+						const auto events = datagram.substr(0, this->event_bytes_ > offset ? this->event_bytes_ - offset : 0);
+						sent += static_cast<std::uint64_t>(std::ranges::count(events, '\n'));
+					}
+				}
+
+				return sent;
+			}
+		};
+
+		void writer_main()
+		{
+			event_writer writer{};
+
+			while (!terminate_writer)
+			{
+				writer.flush();
+				std::this_thread::sleep_for(20ms);
+			}
+
+			writer.flush();
+		}
+
+		void update_config()
+		{
+			sink_config new_config{};
+			new_config.path = g_event_log->current.string;
+
+			const std::string address = g_event_log_address->current.string;
+			if (!address.empty())
+			{
+				game::netadr_s netadr{};
+				if (game::NET_StringToAdr(address.data(), &netadr))
+				{
+					sockaddr sockaddr_value{};
+					game::NetadrToSockadr(&netadr, &sockaddr_value);
+					new_config.address = sockaddr_value;
+				}
+			}
+
+			enabled = !new_config.path.empty() || new_config.address.has_value();
+
+			config.access([&](sink_config& value)
+			{
+				value = std::move(new_config);
+			});
+		}
+
+		void print_stats()
+		{
+			console::info("Events emitted: %llu, written: %llu, dropped: %llu\n",
+				events_emitted.load(), events_written.load(), events_dropped.load());
+		}
+	}
+
+	void log_line(std::string_view line)
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+		{
+			line.remove_suffix(1);
+		}
+
+		const log_fields fields(line);
+		const auto tag = fields[0];
+
+		rapidjson::StringBuffer buffer{};
+		json_writer writer(buffer);
+
+		if ((tag == "K" || tag == "D") && fields.size() >= 12)
+		{
+			begin_event(writer, tag == "K" ? "kill" : "damage");
+			write_hit(writer, fields);
+		}
+		else if ((tag == "J" || tag == "Q") && fields.size() >= 3)
+		{
+			begin_event(writer, tag == "J" ? "join" : "quit");
+			write_player(writer, "player", fields, 1, false);
+		}
+		else if (tag == "W" || tag == "L")
+		{
+			begin_event(writer, tag == "W" ? "round_win" : "round_loss");
+			write_raw_fields(writer, fields);
+		}
+		else
+		{
+			begin_event(writer, "log");
+			writer.Key("text");
+			write_string(writer, line);
+		}
+
+		writer.EndObject();
+		emit(buffer);
+	}
+
+	void chat(const char* command, const char* guid, const int client_num, const char* name, const std::string_view message, const bool hidden)
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		rapidjson::StringBuffer buffer{};
+		json_writer writer(buffer);
+
+		begin_event(writer, "chat");
+		writer.Key("team");
+		writer.Bool(command == "say_team"s);
+		writer.Key("hidden");
+		writer.Bool(hidden);
+		writer.Key("player");
+		writer.StartObject();
+		writer.Key("guid");
+		writer.String(guid);
+		writer.Key("num");
+		writer.Int(client_num);
+		writer.Key("name");
+		writer.String(name);
+		writer.EndObject();
+		writer.Key("message");
+		write_string(writer, message);
+		writer.EndObject();
+
+		emit(buffer);
+	}
+
+	void game_init()
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		rapidjson::StringBuffer buffer{};
+		json_writer writer(buffer);
+
+		begin_event(writer, "init_game");
+		writer.Key("map");
+		writer.String(get_dvar_string("mapname"));
+		writer.Key("gametype");
+		writer.String(get_dvar_string("g_gametype"));
+		writer.EndObject();
+
+		emit(buffer);
+	}
+
+	void game_shutdown(const bool clear_scripts)
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		rapidjson::StringBuffer buffer{};
+		json_writer writer(buffer);
+
+		begin_event(writer, "shutdown_game");
+		writer.Key("restart");
+		writer.Bool(!clear_scripts);
+		writer.EndObject();
+
+		emit(buffer);
+	}
+
+	class component final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			if (game::environment::is_sp())
+			{
+				return;
+			}
+
+			scheduler::once([]
+			{
+				g_event_log = game::Dvar_RegisterString("g_eventLog", "", game::DVAR_FLAG_NONE);
+				g_event_log_address = game::Dvar_RegisterString("g_eventLogAddress", "", game::DVAR_FLAG_NONE);
+
+				update_config();
+				scheduler::loop(update_config, scheduler::pipeline::main, 1s);
+			}, scheduler::pipeline::main);
+
+			writer_thread = utils::thread::create_named_thread("Game Event Writer", writer_main);
+
+			command::add("g_eventStats", print_stats);
+		}
+
+		void pre_destroy() override
+		{
+			terminate_writer = true;
+
+			if (writer_thread.joinable())
+			{
+				writer_thread.join();
+			}
+		}
+	};
+}
+
+REGISTER_COMPONENT(game_events::component)
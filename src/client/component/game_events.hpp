@@ -0,0 +1,12 @@
+#pragma once
+
+namespace game_events
+{
+	// Stock kill, damage, join, quit and round lines become typed events, other lines are forwarded as raw log events
+	void log_line(std::string_view line);
+
+	void chat(const char* command, const char* guid, int client_num, const char* name, std::string_view message, bool hidden);
+
+	void game_init();
+	void game_shutdown(bool clear_scripts);
+}
@@ -6,6 +6,7 @@
 #include "scheduler.hpp"
 #include "scripting.hpp"
 #include "console.hpp"
+#include "game_events.hpp"
 #include "game_log.hpp"
 
 #include "gsc/script_extension.hpp"
@@ -37,6 +38,7 @@ namespace game_log
 			}
 
 			g_log_printf("%s", buf);
+			game_events::log_line(buf);
 		}
 	}
 
@@ -82,6 +84,8 @@ namespace game_log
 				console::info("gamename: S1\n");
 				console::info("gamedate: " __DATE__ "\n");
 
+				game_events::game_init();
+
 				const auto* log = dvars::g_log->current.string;
 				if (*log == '\0')
 				{
@@ -98,6 +102,8 @@ namespace game_log
 			{
 				console::info("==== ShutdownGame (%d) ====\n", clear_scripts);
 
+				game_events::game_shutdown(clear_scripts != 0);
+
 				g_log_printf("ShutdownGame:\n");
 				g_log_printf("------------------------------------------------------------\n");
 			});
@@ -0,0 +1,456 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "script_error.hpp"
+#include "script_extension.hpp"
+#include "script_value.hpp"
+
+#include <utils/string.hpp>
+
+namespace gsc
+{
+	namespace
+	{
+		bool is_number(const game::VariableValue& value)
+		{
+			return value.type == game::VAR_INTEGER || value.type == game::VAR_FLOAT;
+		}
+
+		double get_number(const game::VariableValue& value)
+		{
+			return value.type == game::VAR_INTEGER ? value.u.intValue : static_cast<double>(value.u.floatValue);
+		}
+
+		const char* get_string(const game::VariableValue& value)
+		{
+			return game::SL_ConvertToString(static_cast<game::scr_string_t>(value.u.stringValue));
+		}
+
+		bool is_string(const game::VariableValue& value)
+		{
+			return value.type == game::VAR_STRING || value.type == game::VAR_ISTRING;
+		}
+
+		bool values_equal(const game::VariableValue& a, const game::VariableValue& b)
+		{
+			if (is_number(a) && is_number(b))
+			{
+				return get_number(a) == get_number(b);
+			}
+
+			if (a.type != b.type)
+			{
+				return false;
+			}
+
+			if (a.type == game::VAR_VECTOR)
+			{
+				return std::memcmp(a.u.vectorValue, b.u.vectorValue, sizeof(float[3])) == 0;
+			}
+
+			// Strings are interned, so equal strings share the same id
+			return a.u.uintValue == b.u.uintValue;
+		}
+
+		struct value_hash
+		{
+			std::size_t operator()(const game::VariableValue& value) const
+			{
+				if (is_number(value))
+				{
+					return std::hash<double>{}(get_number(value));
+				}
+
+				if (value.type == game::VAR_VECTOR)
+				{
+					const std::string_view data{reinterpret_cast<const char*>(value.u.vectorValue), sizeof(float[3])};
+					return std::hash<std::string_view>{}(data);
+				}
+
+				return std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(value.type) << 32) | value.u.uintValue);
+			}
+		};
+
+		struct value_equal
+		{
+			bool operator()(const game::VariableValue& a, const game::VariableValue& b) const
+			{
+				return values_equal(a, b);
+			}
+		};
+
+		using value_set = std::unordered_set<game::VariableValue, value_hash, value_equal>;
+
+		// Orders numbers or strings, mixing both or using other types is an error
+		int compare_values(const game::VariableValue& a, const game::VariableValue& b)
+		{
+			if (is_number(a) && is_number(b))
+			{
+				const auto number_a = get_number(a);
+				const auto number_b = get_number(b);
+				return number_a < number_b ? -1 : (number_a > number_b ? 1 : 0);
+			}
+
+			if (is_string(a) && is_string(b))
+			{
+				return std::strcmp(get_string(a), get_string(b));
+			}
+
+			throw std::runtime_error(std::format("Can't compare {} with {}", get_var_type_name(a.type), get_var_type_name(b.type)));
+		}
+
+		game::VariableValue get_field(const game::VariableValue& object, const unsigned int field)
+		{
+			game::VariableValue value{};
+			value.type = game::VAR_UNDEFINED;
+
+			if (object.type != game::VAR_POINTER)
+			{
+				return value;
+			}
+
+			const auto id = game::FindVariable(object.u.pointerValue, field);
+			if (!id)
+			{
+				return value;
+			}
+
+			const auto& variable = get_child_variable(object.u.pointerValue, id);
+			value.type = variable.type;
+			value.u = variable.u.u;
+			return value;
+		}
+
+		unsigned int get_field_name(const unsigned int index)
+		{
+			return game::SL_GetCanonicalString(game::Scr_GetString(index));
+		}
+
+		bool get_optional_bool(const unsigned int index)
+		{
+			return index < game::Scr_GetNumParam() && game::Scr_GetInt(index);
+		}
+
+		void sort_values(std::vector<game::VariableValue>& values, const bool descending)
+		{
+			std::ranges::stable_sort(values, [&](const game::VariableValue& a, const game::VariableValue& b)
+			{
+				const auto result = compare_values(a, b);
+				return descending ? result > 0 : result < 0;
+			});
+		}
+
+		void array_sort()
+		{
+			auto values = get_array_values(get_array_param(0));
+			sort_values(values, get_optional_bool(1));
+
+			array_builder result{};
+			for (const auto& value : values)
+			{
+				result.add_copy(value);
+			}
+
+			result.push();
+		}
+
+		void array_sort_by_field()
+		{
+			const auto values = get_array_values(get_array_param(0));
+			const auto field = get_field_name(1);
+			const auto descending = get_optional_bool(2);
+
+			std::vector<std::pair<game::VariableValue, game::VariableValue>> entries;
+			entries.reserve(values.size());
+
+			for (const auto& value : values)
+			{
+				entries.emplace_back(get_field(value, field), value);
+			}
+
+			// Entries without the field always go last
+			std::ranges::stable_sort(entries, [&](const auto& a, const auto& b)
+			{
+				if (a.first.type == game::VAR_UNDEFINED || b.first.type == game::VAR_UNDEFINED)
+				{
+					return b.first.type == game::VAR_UNDEFINED && a.first.type != game::VAR_UNDEFINED;
+				}
+
+				const auto result = compare_values(a.first, b.first);
+				return descending ? result > 0 : result < 0;
+			});
+
+			array_builder result{};
+			for (const auto& value : entries | std::views::values)
+			{
+				result.add_copy(value);
+			}
+
+			result.push();
+		}
+
+		void array_binary_search()
+		{
+			const auto values = get_list_values(get_array_param(0));
+			const auto& target = get_param(1);
+
+			const auto itr = std::ranges::lower_bound(values, target, [](const game::VariableValue& a, const game::VariableValue& b)
+			{
+				return compare_values(a, b) < 0;
+			});
+
+			if (itr == values.end() || compare_values(*itr, target) != 0)
+			{
+				game::Scr_AddInt(-1);
+				return;
+			}
+
+			game::Scr_AddInt(static_cast<int>(itr - values.begin()));
+		}
+
+		void array_index_of()
+		{
+			const auto values = get_list_values(get_array_param(0));
+			const auto& target = get_param(1);
+
+			const auto itr = std::ranges::find_if(values, [&](const game::VariableValue& value)
+			{
+				return values_equal(value, target);
+			});
+
+			game::Scr_AddInt(itr == values.end() ? -1 : static_cast<int>(itr - values.begin()));
+		}
+
+		void array_contains()
+		{
+			const auto values = get_array_values(get_array_param(0));
+			const auto& target = get_param(1);
+
+			game::Scr_AddInt(std::ranges::any_of(values, [&](const game::VariableValue& value)
+			{
+				return values_equal(value, target);
+			}));
+		}
+
+		void array_unique()
+		{
+			const auto values = get_array_values(get_array_param(0));
+
+			value_set seen;
+			seen.reserve(values.size());
+
+			array_builder result{};
+			for (const auto& value : values)
+			{
+				if (seen.emplace(value).second)
+				{
+					result.add_copy(value);
+				}
+			}
+
+			result.push();
+		}
+
+		void filter_by_membership(const bool keep_members)
+		{
+			const auto values = get_array_values(get_array_param(0));
+			const auto other = get_array_values(get_array_param(1));
+
+			const value_set members(other.begin(), other.end());
+
+			array_builder result{};
+			for (const auto& value : values)
+			{
+				if (members.contains(value) == keep_members)
+				{
+					result.add_copy(value);
+				}
+			}
+
+			result.push();
+		}
+
+		void array_find_by_field()
+		{
+			const auto values = get_array_values(get_array_param(0));
+			const auto field = get_field_name(1);
+			const auto& target = get_param(2);
+
+			for (const auto& value : values)
+			{
+				const auto field_value = get_field(value, field);
+				if (field_value.type != game::VAR_UNDEFINED && values_equal(field_value, target))
+				{
+					push_copy(value);
+					return;
+				}
+			}
+
+			push_undefined();
+		}
+
+		void array_slice()
+		{
+			const auto values = get_list_values(get_array_param(0));
+			const auto size = static_cast<int>(values.size());
+
+			const auto resolve_index = [&](const int index)
+			{
+				return std::clamp(index < 0 ? size + index : index, 0, size);
+			};
+
+			const auto start = resolve_index(game::Scr_GetInt(1));
+			const auto end = game::Scr_GetNumParam() > 2 ? resolve_index(game::Scr_GetInt(2)) : size;
+
+			array_builder result{};
+			for (auto i = start; i < end; ++i)
+			{
+				result.add_copy(values[i]);
+			}
+
+			result.push();
+		}
+
+		void str_split()
+		{
+			const std::string_view string = game::Scr_GetString(0);
+			const std::string delimiter = game::Scr_GetString(1);
+
+			array_builder result{};
+			const auto add_part = [&](const std::string_view part)
+			{
+				game::VariableValue value{};
+				value.type = game::VAR_STRING;
+				value.u.stringValue = static_cast<unsigned int>(game::SL_GetString(std::string(part).data(), 0));
+				result.add(value);
+			};
+
+			if (delimiter.empty())
+			{
+				for (const auto character : string)
+				{
+					add_part({&character, 1});
+				}
+			}
+			else
+			{
+				std::size_t position = 0;
+				for (auto match = string.find(delimiter); match != std::string_view::npos; match = string.find(delimiter, position))
+				{
+					add_part(string.substr(position, match - position));
+					position = match + delimiter.size();
+				}
+
+				add_part(string.substr(position));
+			}
+
+			result.push();
+		}
+
+		void str_join()
+		{
+			const auto values = get_array_values(get_array_param(0));
+			const std::string separator = game::Scr_GetNumParam() > 1 ? game::Scr_GetString(1) : "";
+
+			std::string result;
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				if (i)
+				{
+					result.append(separator);
+				}
+
+				const auto& value = values[i];
+				if (is_string(value))
+				{
+					result.append(get_string(value));
+				}
+				else if (value.type == game::VAR_INTEGER)
+				{
+					result.append(std::to_string(value.u.intValue));
+				}
+				else if (value.type == game::VAR_FLOAT)
+				{
+					result.append(std::format("{}", value.u.floatValue));
+				}
+				else
+				{
+					throw std::runtime_error(std::format("Can't join a value of type {}", get_var_type_name(value.type)));
+				}
+			}
+
+			game::Scr_AddString(result.data());
+		}
+
+		void str_replace()
+		{
+			const std::string string = game::Scr_GetString(0);
+			const std::string_view what = game::Scr_GetString(1);
+			const std::string_view with = game::Scr_GetString(2);
+
+			if (what.empty())
+			{
+				game::Scr_AddString(string.data());
+				return;
+			}
+
+			std::string result;
+			result.reserve(string.size());
+
+			std::size_t position = 0;
+			for (auto match = string.find(what); match != std::string::npos; match = string.find(what, position))
+			{
+				result.append(string, position, match - position);
+				result.append(with);
+				position = match + what.size();
+			}
+
+			result.append(string, position);
+			game::Scr_AddString(result.data());
+		}
+
+		void str_to_lower()
+		{
+			auto string = std::string(game::Scr_GetString(0));
+			utils::string::to_lower_inplace(string);
+			game::Scr_AddString(string.data());
+		}
+	}
+
+	class collections final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			if (game::environment::is_sp())
+			{
+				return;
+			}
+
+			add_function("arraysort", array_sort);
+			add_function("arraysortbyfield", array_sort_by_field);
+			add_function("arraybinarysearch", array_binary_search);
+			add_function("arrayindexof", array_index_of);
+			add_function("arraycontains", array_contains);
+			add_function("arrayunique", array_unique);
+			add_function("arrayintersect", []
+			{
+				filter_by_membership(true);
+			});
+			add_function("arraydifference", []
+			{
+				filter_by_membership(false);
+			});
+			add_function("arrayfindbyfield", array_find_by_field);
+			add_function("arrayslice", array_slice);
+
+			add_function("strsplit", str_split);
+			add_function("strjoin", str_join);
+			add_function("strreplace", str_replace);
+			add_function("strtolower", str_to_lower);
+		}
+	};
+}
+
+REGISTER_COMPONENT(gsc::collections)
@@ -190,19 +190,7 @@ namespace gsc
 
 	std::optional<std::pair<std::string, std::string>> find_function(const char* pos)
 	{
-		for (const auto& file : scripting::script_function_table_sort)
-		{
-			for (auto i = file.second.begin(); i != file.second.end() && std::next(i) != file.second.end(); ++i)
-			{
-				const auto next = std::next(i);
-				if (pos >= i->second && pos < next->second)
-				{
-					return {std::make_pair(i->first, file.first)};
-				}
-			}
-		}
-
-		return {};
+		return scripting::find_function(pos);
 	}
 
 	void scr_get_vector(unsigned int index, float* vector_value)
@@ -299,6 +287,16 @@ namespace gsc
 		return nullptr;
 	}
 
+	const char* get_var_type_name(const int type)
+	{
+		if (type < 0 || static_cast<std::size_t>(type) >= var_typename.size())
+		{
+			return "unknown";
+		}
+
+		return var_typename[type];
+	}
+
 	class error final : public component_interface
 	{
 	public:
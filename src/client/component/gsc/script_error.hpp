@@ -10,4 +10,6 @@ namespace gsc
 	int scr_get_pointer_type(unsigned int index);
 	int scr_get_type(unsigned int index);
 	const char* scr_get_type_name(unsigned int index);
+
+	const char* get_var_type_name(int type);
 }
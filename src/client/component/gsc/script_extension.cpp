@@ -374,6 +374,13 @@ namespace gsc
 				command::execute(cmd);
 			});
 
+			// Steady clock for timing scripts, only differences are meaningful as the value wraps every 71 minutes
+			add_function("getmicroseconds", []
+			{
+				const auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch());
+				game::Scr_AddInt(static_cast<int>(static_cast<std::uint32_t>(now.count())));
+			});
+
 			utils::hook::set<std::uint32_t>(SELECT_VALUE(0x1403115BC, 0x1403EDAEC), 0x1000); // Scr_RegisterFunction
 
 			utils::hook::set<std::uint32_t>(SELECT_VALUE(0x1403115C2 + 4, 0x1403EDAF2 + 4), RVA(&func_table)); // Scr_RegisterFunction
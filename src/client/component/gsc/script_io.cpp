@@ -0,0 +1,505 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "component/scheduler.hpp"
+#include "component/scripting.hpp"
+
+#include "script_extension.hpp"
+#include "script_value.hpp"
+
+#include <utils/concurrency.hpp>
+#include <utils/io.hpp>
+#include <utils/thread.hpp>
+
+namespace gsc
+{
+	namespace
+	{
+		// Scripts can only touch files inside this folder
+		constexpr auto script_data_folder = "players2/scriptdata";
+		// Reads return at most this much, scripts pass an offset to read larger files in pieces
+		// Script strings are reference counted allocations of the string pool, which is meant for short strings
+		constexpr std::uintmax_t max_read_size = 0x4000;
+		constexpr auto max_json_depth = 32;
+
+		enum class file_operation
+		{
+			read,
+			write,
+			append,
+		};
+
+		struct file_request
+		{
+			int id;
+			unsigned int object;
+			std::uint64_t generation;
+			file_operation operation;
+			std::string path;
+			std::string data;
+			std::uintmax_t offset;
+		};
+
+		struct file_result
+		{
+			int id;
+			unsigned int object;
+			std::uint64_t generation;
+			file_operation operation;
+			bool success;
+			std::string data;
+			bool more;
+		};
+
+		std::mutex request_mutex;
+		std::condition_variable request_condition;
+		std::queue<file_request> requests;
+		bool kill_worker = false;
+		std::thread worker_thread;
+
+		utils::concurrency::container<std::vector<file_result>> results;
+
+		// Bumped when the scripts are cleared, results of older requests are dropped
+		std::atomic_uint64_t script_generation{0};
+		int next_request_id = 0;
+
+		std::optional<std::string> resolve_path(const std::string& path)
+		{
+			const auto relative = std::filesystem::path(path).lexically_normal();
+			if (relative.empty() || relative.has_root_name() || relative.has_root_directory())
+			{
+				return {};
+			}
+
+			if (*relative.begin() == "..")
+			{
+				return {};
+			}
+
+			return (std::filesystem::path(script_data_folder) / relative).generic_string();
+		}
+
+		file_result run_request(file_request& request)
+		{
+			file_result result{request.id, request.object, request.generation, request.operation, false, {}, false};
+
+			switch (request.operation)
+			{
+			case file_operation::read:
+			{
+				std::error_code ec{};
+				const auto size = std::filesystem::file_size(request.path, ec);
+				if (ec || request.offset > size)
+				{
+					break;
+				}
+
+				std::ifstream stream(request.path, std::ios::binary);
+				if (!stream.is_open())
+				{
+					break;
+				}
+
+				result.data.resize(static_cast<std::size_t>(std::min(size - request.offset, max_read_size)));
+				stream.seekg(static_cast<std::streamoff>(request.offset));
+				stream.read(result.data.data(), static_cast<std::streamsize>(result.data.size()));
+				result.data.resize(static_cast<std::size_t>(stream.gcount()));
+
+				// Script strings end at the first NUL, so only text can be read
+				result.success = result.data.find('\0') == std::string::npos;
+				result.more = result.success && request.offset + result.data.size() < size;
+
+				if (!result.success)
+				{
+					result.data.clear();
+				}
+
+				break;
+			}
+			case file_operation::write:
+				result.success = utils::io::write_file(request.path, request.data, false);
+				break;
+			case file_operation::append:
+				result.success = utils::io::write_file(request.path, request.data, true);
+				break;
+			}
+
+			return result;
+		}
+
+		void worker_main()
+		{
+			while (true)
+			{
+				std::unique_lock lock(request_mutex);
+				request_condition.wait(lock, []
+				{
+					return kill_worker || !requests.empty();
+				});
+
+				if (requests.empty())
+				{
+					return;
+				}
+
+				auto request = std::move(requests.front());
+				requests.pop();
+				lock.unlock();
+
+				auto result = run_request(request);
+				results.access([&](std::vector<file_result>& queue)
+				{
+					queue.emplace_back(std::move(result));
+				});
+			}
+		}
+
+		const char* get_notify_name(const file_operation operation)
+		{
+			switch (operation)
+			{
+			case file_operation::read:
+				return "file_read";
+			case file_operation::write:
+				return "file_write";
+			case file_operation::append:
+				return "file_append";
+			}
+
+			return "";
+		}
+
+		// Runs on the server thread, the only place where notifies can be sent
+		void deliver_results()
+		{
+			std::vector<file_result> completed;
+			results.access([&](std::vector<file_result>& queue)
+			{
+				completed.swap(queue);
+			});
+
+			for (const auto& result : completed)
+			{
+				if (result.generation != script_generation)
+				{
+					continue;
+				}
+
+				// Notify arguments are pushed in reverse
+				if (result.operation == file_operation::read)
+				{
+					game::Scr_AddInt(result.more);
+					game::Scr_AddString(result.data.data());
+				}
+
+				game::Scr_AddInt(result.success);
+				game::Scr_AddInt(result.id);
+
+				const auto name = game::SL_GetString(get_notify_name(result.operation), 0);
+				game::Scr_NotifyId(result.object, static_cast<unsigned int>(name), game::scr_VmPub->inparamcount);
+				game::RemoveRefToObject(result.object);
+			}
+		}
+
+		unsigned int get_notify_object(const unsigned int index)
+		{
+			if (index >= game::Scr_GetNumParam() || get_param(index).type == game::VAR_UNDEFINED)
+			{
+				return *game::levelEntityId;
+			}
+
+			const auto& value = get_param(index);
+			if (value.type != game::VAR_POINTER)
+			{
+				throw std::runtime_error(std::format("Parameter {} must be an entity or struct", index + 1));
+			}
+
+			return value.u.pointerValue;
+		}
+
+		void queue_request(const file_operation operation, const std::string& path, std::string data, const unsigned int object,
+			const std::uintmax_t offset = 0)
+		{
+			const auto resolved_path = resolve_path(path);
+			if (!resolved_path.has_value())
+			{
+				throw std::runtime_error(std::format("Path '{}' is outside of {}", path, script_data_folder));
+			}
+
+			const auto id = ++next_request_id;
+
+			// Keep the object alive until the notify was delivered
+			game::AddRefToObject(object);
+
+			{
+				std::lock_guard _(request_mutex);
+				requests.emplace(file_request{id, object, script_generation, operation, *resolved_path, std::move(data), offset});
+			}
+
+			request_condition.notify_one();
+			game::Scr_AddInt(id);
+		}
+
+		template <typename Writer>
+		void write_json(Writer& writer, const game::VariableValue& value, int depth);
+
+		template <typename Writer>
+		void write_json_object(Writer& writer, const unsigned int id, const int depth)
+		{
+			const auto type = game::GetObjectType(id);
+			if (type != game::VAR_ARRAY && type != game::VAR_OBJECT)
+			{
+				writer.Null();
+				return;
+			}
+
+			const auto entries = get_array_entries(id);
+
+			if (type == game::VAR_ARRAY && std::ranges::all_of(entries, &array_entry::is_index))
+			{
+				// Arrays indexed 0 to n - 1 become lists
+				std::vector<const game::VariableValue*> list(entries.size());
+				auto is_list = true;
+
+				for (const auto& entry : entries)
+				{
+					const auto index = entry.get_index();
+					if (index < 0 || static_cast<std::size_t>(index) >= list.size() || list[index])
+					{
+						is_list = false;
+						break;
+					}
+
+					list[index] = &entry.value;
+				}
+
+				if (is_list)
+				{
+					writer.StartArray();
+					for (const auto* element : list)
+					{
+						write_json(writer, *element, depth + 1);
+					}
+
+					writer.EndArray();
+					return;
+				}
+			}
+
+			writer.StartObject();
+			for (const auto& entry : entries)
+			{
+				std::string key;
+				if (type == game::VAR_OBJECT)
+				{
+					// Struct fields are named by canonical strings
+					key = scripting::get_token(entry.name);
+				}
+				else if (entry.is_index())
+				{
+					key = std::to_string(entry.get_index());
+				}
+				else
+				{
+					key = game::SL_ConvertToString(static_cast<game::scr_string_t>(entry.name));
+				}
+
+				writer.Key(key.data(), static_cast<rapidjson::SizeType>(key.size()));
+				write_json(writer, entry.value, depth + 1);
+			}
+
+			writer.EndObject();
+		}
+
+		template <typename Writer>
+		void write_json(Writer& writer, const game::VariableValue& value, const int depth)
+		{
+			if (depth > max_json_depth)
+			{
+				throw std::runtime_error("Value is nested too deeply or references itself");
+			}
+
+			switch (value.type)
+			{
+			case game::VAR_INTEGER:
+				writer.Int(value.u.intValue);
+				break;
+			case game::VAR_FLOAT:
+				writer.Double(value.u.floatValue);
+				break;
+			case game::VAR_STRING:
+			case game::VAR_ISTRING:
+				writer.String(game::SL_ConvertToString(static_cast<game::scr_string_t>(value.u.stringValue)));
+				break;
+			case game::VAR_VECTOR:
+				writer.StartArray();
+				for (auto i = 0; i < 3; ++i)
+				{
+					writer.Double(value.u.vectorValue[i]);
+				}
+
+				writer.EndArray();
+				break;
+			case game::VAR_POINTER:
+				write_json_object(writer, value.u.pointerValue, depth);
+				break;
+			default:
+				writer.Null();
+				break;
+			}
+		}
+
+		// The returned value owns one reference
+		game::VariableValue read_json(const rapidjson::Value& json, const int depth)
+		{
+			if (depth > max_json_depth)
+			{
+				throw std::runtime_error("JSON is nested too deeply");
+			}
+
+			game::VariableValue value{};
+			value.type = game::VAR_UNDEFINED;
+
+			if (json.IsBool())
+			{
+				value.type = game::VAR_INTEGER;
+				value.u.intValue = json.GetBool();
+			}
+			else if (json.IsInt())
+			{
+				value.type = game::VAR_INTEGER;
+				value.u.intValue = json.GetInt();
+			}
+			else if (json.IsNumber())
+			{
+				value.type = game::VAR_FLOAT;
+				value.u.floatValue = static_cast<float>(json.GetDouble());
+			}
+			else if (json.IsString())
+			{
+				value.type = game::VAR_STRING;
+				value.u.stringValue = static_cast<unsigned int>(game::SL_GetString(json.GetString(), 0));
+			}
+			else if (json.IsArray())
+			{
+				array_builder array{};
+				for (const auto& element : json.GetArray())
+				{
+					array.add(read_json(element, depth + 1));
+				}
+
+				value = array.release();
+			}
+			else if (json.IsObject())
+			{
+				// Scripts can't create structs from here, objects become string keyed arrays
+				array_builder array{};
+				for (const auto& member : json.GetObj())
+				{
+					array.add(std::string(member.name.GetString(), member.name.GetStringLength()), read_json(member.value, depth + 1));
+				}
+
+				value = array.release();
+			}
+
+			return value;
+		}
+
+		void json_encode()
+		{
+			rapidjson::StringBuffer buffer{};
+
+			if (game::Scr_GetNumParam() > 1 && game::Scr_GetInt(1))
+			{
+				rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+				write_json(writer, get_param(0), 0);
+			}
+			else
+			{
+				rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+				write_json(writer, get_param(0), 0);
+			}
+
+			game::Scr_AddString(buffer.GetString());
+		}
+
+		void json_decode()
+		{
+			rapidjson::Document doc{};
+			const rapidjson::ParseResult parse_result = doc.Parse(game::Scr_GetString(0));
+			if (!parse_result)
+			{
+				throw std::runtime_error(std::format("Invalid JSON at offset {}", parse_result.Offset()));
+			}
+
+			push_value(read_json(doc, 0));
+		}
+	}
+
+	class io final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			if (game::environment::is_sp())
+			{
+				return;
+			}
+
+			worker_thread = utils::thread::create_named_thread("GSC File IO", worker_main);
+
+			scheduler::loop(deliver_results, scheduler::pipeline::server);
+
+			scripting::on_shutdown([](const int clear_scripts)
+			{
+				if (clear_scripts)
+				{
+					++script_generation;
+				}
+			});
+
+			// Notifies "file_read" with the request id, whether it succeeded, the data and whether more data follows
+			add_function("fileread", []
+			{
+				const auto offset = game::Scr_GetNumParam() > 2 ? game::Scr_GetInt(2) : 0;
+				if (offset < 0)
+				{
+					throw std::runtime_error("Offset must not be negative");
+				}
+
+				queue_request(file_operation::read, game::Scr_GetString(0), {}, get_notify_object(1), static_cast<std::uintmax_t>(offset));
+			});
+
+			add_function("filewrite", []
+			{
+				queue_request(file_operation::write, game::Scr_GetString(0), game::Scr_GetString(1), get_notify_object(2));
+			});
+
+			add_function("fileappend", []
+			{
+				queue_request(file_operation::append, game::Scr_GetString(0), game::Scr_GetString(1), get_notify_object(2));
+			});
+
+			add_function("jsonencode", json_encode);
+			add_function("jsondecode", json_decode);
+		}
+
+		void pre_destroy() override
+		{
+			{
+				std::lock_guard _(request_mutex);
+				kill_worker = true;
+			}
+
+			request_condition.notify_all();
+
+			if (worker_thread.joinable())
+			{
+				worker_thread.join();
+			}
+		}
+	};
+}
+
+REGISTER_COMPONENT(gsc::io)
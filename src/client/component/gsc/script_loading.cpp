@@ -27,12 +27,27 @@ namespace gsc
 		std::unordered_map<std::string, game::ScriptFile*> loaded_scripts;
 		utils::memory::allocator script_allocator;
 
+		// Stock scripts are included by almost every custom script, so their stacks are only inflated once.
+		// Entries are matched by the compressed bytes rather than the asset, as a zone that was unloaded
+		// and loaded again can put a different script at the same addresses.
+		struct decompressed_script
+		{
+			std::string compressed;
+			std::string stack;
+		};
+
+		std::unordered_map<std::string, decompressed_script> decompressed_scripts;
+		std::size_t decompressed_script_misses = 0;
+		std::size_t decompressed_script_hits = 0;
+
 		void clear()
 		{
 			main_handles.clear();
 			init_handles.clear();
 			loaded_scripts.clear();
 			script_allocator.clear();
+			// Entries are checked against the asset before every use, this only releases their memory
+			decompressed_scripts.clear();
 			clear_devmap();
 		}
 
@@ -145,25 +160,39 @@ namespace gsc
 			return std::to_string(id);
 		}
 
-		std::pair<xsk::gsc::buffer, std::vector<std::uint8_t>> read_compiled_script_file(const std::string& name, const std::string& real_name)
+		const decompressed_script& decompress_script_file(const std::string& name, const std::string& real_name, const game::ScriptFile* script_file)
 		{
-			const auto* script_file = game::DB_FindXAssetHeader(game::ASSET_TYPE_SCRIPTFILE, name.data(), false).scriptfile;
-			if (!script_file)
+			if (const auto itr = decompressed_scripts.find(name); itr != decompressed_scripts.end())
 			{
-				throw std::runtime_error(std::format("Could not load scriptfile '{}'", real_name));
+				const auto& entry = itr->second;
+				if (entry.compressed == std::string_view(script_file->buffer, static_cast<std::uint32_t>(script_file->compressedLen)))
+				{
+					++decompressed_script_hits;
+					return entry;
+				}
 			}
 
 			console::info("Decompiling scriptfile '%s'\n", real_name.data());
+			++decompressed_script_misses;
 
-			const auto len = script_file->compressedLen;
-			const std::string stack{script_file->buffer, static_cast<std::uint32_t>(len)};
+			auto& entry = decompressed_scripts[name];
+			entry.compressed.assign(script_file->buffer, static_cast<std::uint32_t>(script_file->compressedLen));
+			entry.stack = utils::compression::zlib::decompress(entry.compressed, static_cast<size_t>(script_file->len));
 
-			const auto decompressed_stack = utils::compression::zlib::decompress(stack);
+			return entry;
+		}
 
-			std::vector<std::uint8_t> stack_data;
-			stack_data.assign(decompressed_stack.begin(), decompressed_stack.end());
+		std::pair<xsk::gsc::buffer, std::vector<std::uint8_t>> read_compiled_script_file(const std::string& name, const std::string& real_name)
+		{
+			const auto* script_file = game::DB_FindXAssetHeader(game::ASSET_TYPE_SCRIPTFILE, name.data(), false).scriptfile;
+			if (!script_file)
+			{
+				throw std::runtime_error(std::format("Could not load scriptfile '{}'", real_name));
+			}
 
-			return {{script_file->bytecode, static_cast<std::uint32_t>(script_file->bytecodeLen)}, stack_data};
+			// gsc-tool's include callback owns the stack it returns, so this is the only copy left
+			const auto& entry = decompress_script_file(name, real_name, script_file);
+			return {{script_file->bytecode, static_cast<std::uint32_t>(script_file->bytecodeLen)}, {entry.stack.begin(), entry.stack.end()}};
 		}
 
 		void load_script(const std::string& name)
@@ -392,6 +421,13 @@ namespace gsc
 			// Cleanup the compiler
 			gsc_ctx->cleanup();
 
+			if (decompressed_script_misses || decompressed_script_hits)
+			{
+				console::info("Decompressed %zu stock scripts, reused %zu from cache\n", decompressed_script_misses, decompressed_script_hits);
+				decompressed_script_misses = 0;
+				decompressed_script_hits = 0;
+			}
+
 			utils::hook::invoke<void>(SELECT_VALUE(0x140243780, 0x1403EDF90));
 		}
 	}
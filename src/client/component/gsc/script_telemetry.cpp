@@ -0,0 +1,370 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "component/command.hpp"
+#include "component/console.hpp"
+#include "component/scheduler.hpp"
+#include "component/scripting.hpp"
+
+#include "script_telemetry.hpp"
+
+#include <utils/concurrency.hpp>
+
+namespace gsc
+{
+	namespace
+	{
+		// A full pass over the variable pools is spread over this many server frames,
+		// about three seconds at the stock 20 ticks per second
+		constexpr std::uint32_t scan_frames = 64;
+		constexpr std::uint32_t objects_per_frame = (max_object_variables + scan_frames - 1) / scan_frames;
+		constexpr std::uint32_t children_per_frame = (max_child_variables + scan_frames - 1) / scan_frames;
+
+		constexpr std::size_t max_reported_locations = 10;
+
+		const game::dvar_t* scr_var_telemetry;
+		const game::dvar_t* scr_var_warn_percent;
+
+		struct scan_state
+		{
+			std::uint32_t next_object = 1;
+			std::uint32_t next_child = 1;
+			variable_usage usage{};
+			// One bit per string id held by a variable, cheaper than hashing every string slot
+			std::vector<std::uint64_t> strings;
+			// Code positions sleeping threads will resume at
+			std::unordered_map<const char*, std::uint32_t> thread_positions;
+		};
+
+		scan_state scan{};
+
+		utils::concurrency::container<variable_usage> published_usage{};
+
+		// Sleeping threads per "file::function", and the same counts when the baseline was taken.
+		// Published from the server thread, read and reset by the commands on the main thread
+		struct thread_locations
+		{
+			std::unordered_map<std::string, std::uint32_t> current;
+			std::unordered_map<std::string, std::uint32_t> baseline;
+			bool baseline_pending = true;
+		};
+
+		struct location_growth
+		{
+			std::string location;
+			std::uint32_t count;
+			std::int64_t delta;
+		};
+
+		utils::concurrency::container<thread_locations> locations{};
+
+		bool object_warning_active = false;
+		bool child_warning_active = false;
+
+		void reset_scan()
+		{
+			scan.next_object = 1;
+			scan.next_child = 1;
+			scan.usage = {};
+			std::ranges::fill(scan.strings, 0);
+			scan.thread_positions.clear();
+		}
+
+		void scan_objects(const std::uint32_t end)
+		{
+			for (auto id = scan.next_object; id < end; ++id)
+			{
+				const auto type = game::GetObjectType(id);
+				if (type == game::VAR_FREE)
+				{
+					continue;
+				}
+
+				++scan.usage.objects;
+
+				switch (type)
+				{
+				case game::VAR_ARRAY:
+					++scan.usage.arrays;
+					break;
+				case game::VAR_OBJECT:
+					++scan.usage.structs;
+					break;
+				case game::VAR_NOTIFY_THREAD:
+					++scan.usage.notify_threads;
+					++scan.usage.threads;
+					break;
+				case game::VAR_THREAD:
+				case game::VAR_TIME_THREAD:
+				case game::VAR_CHILD_THREAD:
+					++scan.usage.threads;
+					break;
+				default:
+					break;
+				}
+			}
+
+			scan.next_object = end;
+		}
+
+		void count_string(const unsigned int id)
+		{
+			const auto word = id / 64;
+			const auto bit = std::uint64_t{1} << (id % 64);
+
+			if (word >= scan.strings.size())
+			{
+				scan.strings.resize(word + 1);
+			}
+
+			if (!(scan.strings[word] & bit))
+			{
+				scan.strings[word] |= bit;
+				++scan.usage.strings;
+			}
+		}
+
+		void scan_children(const std::uint32_t end)
+		{
+			for (auto id = scan.next_child; id < end; ++id)
+			{
+				const auto& variable = game::scr_VarGlob->childVariableValue[id];
+				const auto type = static_cast<std::uint8_t>(variable.type);
+				if (type == game::VAR_FREE)
+				{
+					continue;
+				}
+
+				++scan.usage.children;
+
+				if (type == game::VAR_STRING || type == game::VAR_ISTRING)
+				{
+					count_string(variable.u.u.stringValue);
+				}
+				else if (type == game::VAR_STACK && variable.u.u.stackValue)
+				{
+					++scan.thread_positions[variable.u.u.stackValue->pos];
+				}
+			}
+
+			scan.next_child = end;
+		}
+
+		std::string get_location_name(const char* pos)
+		{
+			const auto function = scripting::find_function(pos);
+			if (!function.has_value())
+			{
+				return "<unknown>";
+			}
+
+			return std::format("{}::{}", function->second, function->first);
+		}
+
+		std::vector<location_growth> get_location_growth()
+		{
+			auto growth = locations.access<std::vector<location_growth>>([](const thread_locations& entries)
+			{
+				std::vector<location_growth> result;
+				result.reserve(entries.current.size());
+
+				for (const auto& [location, count] : entries.current)
+				{
+					const auto itr = entries.baseline.find(location);
+					const auto baseline = itr == entries.baseline.end() ? 0 : itr->second;
+					result.push_back({location, count, static_cast<std::int64_t>(count) - baseline});
+				}
+
+				return result;
+			});
+
+			std::ranges::sort(growth, std::greater{}, &location_growth::delta);
+			return growth;
+		}
+
+		void print_location_growth(const std::size_t limit)
+		{
+			const auto growth = get_location_growth();
+			for (std::size_t i = 0; i < std::min(limit, growth.size()); ++i)
+			{
+				const auto& [location, count, delta] = growth[i];
+				console::info("  %s: %u threads (%+lld)\n", location.data(), count, delta);
+			}
+		}
+
+		void check_threshold(const char* pool, const std::uint32_t used, const std::uint32_t capacity, bool& warning_active)
+		{
+			const auto percent = scr_var_warn_percent->current.integer;
+			if (percent <= 0)
+			{
+				warning_active = false;
+				return;
+			}
+
+			const auto usage_percent = static_cast<std::uint64_t>(used) * 100 / capacity;
+			if (usage_percent < static_cast<std::uint64_t>(percent))
+			{
+				// Re-arm once usage has clearly dropped, so a pool hovering at the limit doesn't spam
+				if (usage_percent + 5 < static_cast<std::uint64_t>(percent))
+				{
+					warning_active = false;
+				}
+
+				return;
+			}
+
+			if (warning_active)
+			{
+				return;
+			}
+
+			warning_active = true;
+			console::warn("Script %s variables at %u of %u (%llu%%), most grown sleeping threads:\n", pool, used, capacity, usage_percent);
+			print_location_growth(5);
+		}
+
+		void publish_scan()
+		{
+			auto& usage = scan.usage;
+
+			published_usage.access([&](variable_usage& published)
+			{
+				usage.peak_objects = std::max(published.peak_objects, usage.objects);
+				usage.peak_children = std::max(published.peak_children, usage.children);
+				usage.peak_threads = std::max(published.peak_threads, usage.threads);
+				usage.peak_strings = std::max(published.peak_strings, usage.strings);
+				published = usage;
+			});
+
+			// Function lookups stay outside the lock, the commands only wait for the swap
+			std::unordered_map<std::string, std::uint32_t> current;
+			for (const auto& [pos, count] : scan.thread_positions)
+			{
+				current[get_location_name(pos)] += count;
+			}
+
+			locations.access([&](thread_locations& entries)
+			{
+				entries.current = std::move(current);
+
+				if (entries.baseline_pending)
+				{
+					entries.baseline = entries.current;
+					entries.baseline_pending = false;
+				}
+			});
+
+			check_threshold("object", usage.objects, max_object_variables, object_warning_active);
+			check_threshold("child", usage.children, max_child_variables, child_warning_active);
+
+			reset_scan();
+		}
+
+		void sample_variables()
+		{
+			if (!scr_var_telemetry->current.enabled)
+			{
+				return;
+			}
+
+			scan_objects(std::min(scan.next_object + objects_per_frame, max_object_variables));
+			scan_children(std::min(scan.next_child + children_per_frame, max_child_variables));
+
+			if (scan.next_object == max_object_variables && scan.next_child == max_child_variables)
+			{
+				publish_scan();
+			}
+		}
+
+		void print_usage()
+		{
+			if (!scr_var_telemetry->current.enabled)
+			{
+				console::info("Variable telemetry is off, set scr_varTelemetry to 1 to sample the pools\n");
+				return;
+			}
+
+			const auto usage = get_variable_usage();
+
+			const auto print_pool = [](const char* name, const std::uint32_t live, const std::uint32_t peak, const std::uint32_t capacity)
+			{
+				console::print(peak * 10 >= capacity * 9 ? console::con_type_warning : console::con_type_info,
+					"%s variables: %u, peak %u, max %u\n", name, live, peak, capacity);
+			};
+
+			print_pool("Object", usage.objects, usage.peak_objects, max_object_variables);
+			print_pool("Child", usage.children, usage.peak_children, max_child_variables);
+
+			console::info("Arrays: %u, structs: %u\n", usage.arrays, usage.structs);
+			console::info("Threads: %u (%u waiting on a notify), peak %u\n", usage.threads, usage.notify_threads, usage.peak_threads);
+			console::info("Strings held by variables: %u, peak %u\n", usage.strings, usage.peak_strings);
+
+			const auto has_locations = locations.access<bool>([](const thread_locations& entries)
+			{
+				return !entries.current.empty();
+			});
+
+			if (has_locations)
+			{
+				console::info("Sleeping threads by function, growth since the last reset:\n");
+				print_location_growth(max_reported_locations);
+			}
+		}
+
+		void reset_usage()
+		{
+			published_usage.access([](variable_usage& published)
+			{
+				published.peak_objects = published.objects;
+				published.peak_children = published.children;
+				published.peak_threads = published.threads;
+				published.peak_strings = published.strings;
+			});
+
+			locations.access([](thread_locations& entries)
+			{
+				entries.baseline = entries.current;
+			});
+		}
+	}
+
+	variable_usage get_variable_usage()
+	{
+		return published_usage.access<variable_usage>([](const variable_usage& published)
+		{
+			return published;
+		});
+	}
+
+	class telemetry final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			scr_var_telemetry = game::Dvar_RegisterBool("scr_varTelemetry", false, game::DVAR_FLAG_NONE);
+			scr_var_warn_percent = game::Dvar_RegisterInt("scr_varWarnPercent", 85, 0, 100, game::DVAR_FLAG_NONE);
+
+			scheduler::loop(sample_variables, scheduler::pipeline::server);
+
+			scripting::on_shutdown([](const int clear_scripts)
+			{
+				// Code positions of the old scripts are about to become invalid
+				reset_scan();
+
+				if (clear_scripts)
+				{
+					locations.access([](thread_locations& entries)
+					{
+						entries = {};
+					});
+				}
+			});
+
+			command::add("scr_varUsage", print_usage);
+			command::add("scr_varUsageReset", reset_usage);
+		}
+	};
+}
+
+REGISTER_COMPONENT(gsc::telemetry)
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace gsc
+{
+	struct variable_usage
+	{
+		std::uint32_t objects;
+		std::uint32_t children;
+		std::uint32_t arrays;
+		std::uint32_t structs;
+		std::uint32_t threads;
+		std::uint32_t notify_threads;
+		std::uint32_t strings;
+
+		std::uint32_t peak_objects;
+		std::uint32_t peak_children;
+		std::uint32_t peak_threads;
+		std::uint32_t peak_strings;
+	};
+
+	constexpr std::uint32_t max_object_variables = std::extent_v<decltype(game::scrVarGlob_t::objectVariableValue)>;
+	constexpr std::uint32_t max_child_variables = std::extent_v<decltype(game::scrVarGlob_t::childVariableValue)>;
+
+	// Counts of the last complete scan of the variable pools
+	variable_usage get_variable_usage();
+}
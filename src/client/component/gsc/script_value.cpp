@@ -0,0 +1,210 @@
+#include <std_include.hpp>
+#include "game/game.hpp"
+
+#include "script_value.hpp"
+
+namespace gsc
+{
+	namespace
+	{
+		std::uint32_t get_variable_name(const game::ChildVariableValue& variable)
+		{
+			return static_cast<std::uint8_t>(variable.name_lo) + (static_cast<std::uint32_t>(variable.k.keys.name_hi) << 8);
+		}
+
+		void set_variable(const unsigned int parent_id, const unsigned int id, const game::VariableValue& value)
+		{
+			auto& variable = get_child_variable(parent_id, id);
+			variable.type = static_cast<char>(value.type);
+			variable.u.u = value.u;
+		}
+	}
+
+	game::ChildVariableValue& get_child_variable(const unsigned int parent_id, const unsigned int id)
+	{
+		const auto index = child_partition_size * (parent_id & 3) + id;
+		if (id >= child_partition_size || index >= std::extent_v<decltype(game::scrVarGlob_t::childVariableValue)>)
+		{
+			throw std::runtime_error(std::format("Child variable {} of object {} is out of range", id, parent_id));
+		}
+
+		// The hash keys name the owner, a mismatch means the layout isn't what this expects
+		auto& variable = game::scr_VarGlob->childVariableValue[index];
+		if (variable.k.keys.parentId != static_cast<std::uint16_t>(parent_id))
+		{
+			throw std::runtime_error(std::format("Child variable {} doesn't belong to object {}", id, parent_id));
+		}
+
+		return variable;
+	}
+
+	bool array_entry::is_index() const
+	{
+		return this->name >= max_string_name;
+	}
+
+	int array_entry::get_index() const
+	{
+		return static_cast<int>(this->name) - static_cast<int>(array_index_base);
+	}
+
+	const game::VariableValue& get_param(const unsigned int index)
+	{
+		if (index >= game::scr_VmPub->outparamcount)
+		{
+			throw std::runtime_error(std::format("Parameter {} does not exist", index + 1));
+		}
+
+		return game::scr_VmPub->top[-static_cast<int>(index)];
+	}
+
+	bool is_array(const game::VariableValue& value)
+	{
+		return value.type == game::VAR_POINTER && game::GetObjectType(value.u.pointerValue) == game::VAR_ARRAY;
+	}
+
+	unsigned int get_array_param(const unsigned int index)
+	{
+		const auto& value = get_param(index);
+		if (!is_array(value))
+		{
+			throw std::runtime_error(std::format("Parameter {} is not an array", index + 1));
+		}
+
+		return value.u.pointerValue;
+	}
+
+	std::vector<array_entry> get_array_entries(const unsigned int id)
+	{
+		std::vector<array_entry> entries;
+
+		auto child = game::scr_VarGlob->objectVariableChildren[id].firstChild;
+		while (child)
+		{
+			const auto& variable = get_child_variable(id, child);
+			child = variable.nextSibling;
+
+			if (variable.type == game::VAR_UNDEFINED)
+			{
+				continue;
+			}
+
+			game::VariableValue value{};
+			value.type = variable.type;
+			value.u = variable.u.u;
+
+			entries.emplace_back(array_entry{get_variable_name(variable), value});
+		}
+
+		return entries;
+	}
+
+	std::vector<game::VariableValue> get_array_values(const unsigned int id)
+	{
+		auto entries = get_array_entries(id);
+
+		const auto named = std::ranges::stable_partition(entries, &array_entry::is_index);
+		std::ranges::sort(entries.begin(), named.begin(), {}, &array_entry::get_index);
+
+		std::vector<game::VariableValue> values;
+		values.reserve(entries.size());
+
+		for (const auto& entry : entries)
+		{
+			values.emplace_back(entry.value);
+		}
+
+		return values;
+	}
+
+	std::vector<game::VariableValue> get_list_values(const unsigned int id)
+	{
+		const auto entries = get_array_entries(id);
+		std::vector<game::VariableValue> values(entries.size());
+
+		// Keys are unique, so all of them being in range means none is missing
+		for (const auto& entry : entries)
+		{
+			const auto index = entry.is_index() ? entry.get_index() : -1;
+			if (index < 0 || static_cast<std::size_t>(index) >= values.size())
+			{
+				throw std::runtime_error("Array must only have the keys 0 to size - 1");
+			}
+
+			values[index] = entry.value;
+		}
+
+		return values;
+	}
+
+	void push_value(const game::VariableValue& value)
+	{
+		// Let the engine grow the stack, then put the actual value into the new slot
+		game::Scr_AddInt(0);
+
+		auto* top = game::scr_VmPub->top;
+		top->type = value.type;
+		top->u = value.u;
+	}
+
+	void push_copy(const game::VariableValue& value)
+	{
+		game::AddRefToValue(value.type, value.u);
+		push_value(value);
+	}
+
+	void push_undefined()
+	{
+		game::VariableValue value{};
+		value.type = game::VAR_UNDEFINED;
+		push_value(value);
+	}
+
+	array_builder::array_builder()
+		: id_(game::Scr_AllocArray())
+	{
+	}
+
+	array_builder::~array_builder()
+	{
+		if (!this->released_)
+		{
+			game::RemoveRefToObject(this->id_);
+		}
+	}
+
+	void array_builder::add(const game::VariableValue& value)
+	{
+		set_variable(this->id_, game::GetVariable(this->id_, array_index_base + this->size_), value);
+		++this->size_;
+	}
+
+	void array_builder::add(const std::string& key, const game::VariableValue& value)
+	{
+		// The key keeps its reference for as long as the variable exists
+		const auto name = game::SL_GetString(key.data(), 0);
+		set_variable(this->id_, game::GetVariable(this->id_, static_cast<unsigned int>(name)), value);
+	}
+
+	void array_builder::add_copy(const game::VariableValue& value)
+	{
+		game::AddRefToValue(value.type, value.u);
+		this->add(value);
+	}
+
+	game::VariableValue array_builder::release()
+	{
+		game::scr_VarGlob->objectVariableValue[this->id_].u.o.u.size = static_cast<std::uint16_t>(this->size_);
+		this->released_ = true;
+
+		game::VariableValue value{};
+		value.type = game::VAR_POINTER;
+		value.u.pointerValue = this->id_;
+		return value;
+	}
+
+	void array_builder::push()
+	{
+		push_value(this->release());
+	}
+}
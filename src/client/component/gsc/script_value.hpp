@@ -0,0 +1,67 @@
+#pragma once
+
+namespace gsc
+{
+	// Integer array keys are stored with this bias, anything below the string range is a string key
+	constexpr std::uint32_t array_index_base = 0x800000;
+	constexpr std::uint32_t max_string_name = 0x40000;
+
+	struct array_entry
+	{
+		std::uint32_t name;
+		game::VariableValue value;
+
+		[[nodiscard]] bool is_index() const;
+		[[nodiscard]] int get_index() const;
+	};
+
+	// Child links and the ids FindVariable and GetVariable return are 16 bit and relative to the
+	// partition of the pool that holds the parent's children, the partition follows from the parent id
+	constexpr std::uint32_t child_partition_size = 0xFA00;
+
+	// Throws if the child can't be resolved or belongs to another object
+	game::ChildVariableValue& get_child_variable(unsigned int parent_id, unsigned int id);
+
+	const game::VariableValue& get_param(unsigned int index);
+
+	bool is_array(const game::VariableValue& value);
+	unsigned int get_array_param(unsigned int index);
+
+	// Children of an object in link order
+	std::vector<array_entry> get_array_entries(unsigned int id);
+	// Values of an array in index order, string keyed entries follow in their link order
+	std::vector<game::VariableValue> get_array_values(unsigned int id);
+	// Values of an array whose keys are exactly 0 to size - 1, throws for any other array
+	std::vector<game::VariableValue> get_list_values(unsigned int id);
+
+	// Pushes the value as the return value, the caller's reference is handed over to the VM stack
+	void push_value(const game::VariableValue& value);
+	void push_copy(const game::VariableValue& value);
+	void push_undefined();
+
+	class array_builder final
+	{
+	public:
+		array_builder();
+		~array_builder();
+
+		array_builder(const array_builder&) = delete;
+		array_builder& operator=(const array_builder&) = delete;
+
+		// Both take over one reference of the value
+		void add(const game::VariableValue& value);
+		void add(const std::string& key, const game::VariableValue& value);
+
+		void add_copy(const game::VariableValue& value);
+
+		// Hands the array over as a value owning the only reference,
+		// an array that is never released is freed with everything added so far
+		game::VariableValue release();
+		void push();
+
+	private:
+		unsigned int id_;
+		std::uint32_t size_{};
+		bool released_{false};
+	};
+}
@@ -2,13 +2,17 @@
 #include "loader/component_loader.hpp"
 #include "game/game.hpp"
 
+#include "game/dvars.hpp"
+
 #include "command.hpp"
 #include "console.hpp"
 #include "scheduler.hpp"
 #include "map_rotation.hpp"
+#include "mods.hpp"
 
 #include <utils/hook.hpp>
 #include <utils/string.hpp>
+#include <utils/thread.hpp>
 
 namespace map_rotation
 {
@@ -19,6 +23,185 @@ namespace map_rotation
 		const game::dvar_t* sv_map_rotation;
 		const game::dvar_t* sv_map_rotation_current;
 		const game::dvar_t* sv_random_map_rotation;
+		const game::dvar_t* sv_map_prefetch;
+		const game::dvar_t* sv_map_prefetch_budget;
+
+		struct prefetch_job
+		{
+			std::string map_name;
+			std::atomic_bool cancelled{false};
+			std::atomic_size_t bytes_read{0};
+			std::thread thread;
+		};
+
+		// Only touched from the main thread
+		std::unique_ptr<prefetch_job> current_prefetch;
+
+		struct map_change
+		{
+			std::string map_name;
+			std::chrono::steady_clock::time_point start;
+			std::size_t prefetched_bytes;
+			bool unloaded;
+		};
+
+		std::optional<map_change> pending_map_change;
+
+		std::vector<std::filesystem::path> get_map_zone_files(const std::string& mapname)
+		{
+			const auto base_path = std::filesystem::current_path();
+
+			// Same locations DB_BuildOSPath_FromSource resolves zones from
+			std::vector<std::filesystem::path> directories;
+			if (mods::is_using_mods())
+			{
+				directories.emplace_back(base_path / (*dvars::fs_gameDirVar)->current.string);
+			}
+
+			directories.emplace_back(base_path / "usermaps" / mapname);
+			directories.emplace_back(base_path);
+
+			const std::string file_names[] =
+			{
+				mapname + ".ff",
+				mapname + "_load.ff",
+				mapname + ".pak",
+			};
+
+			std::vector<std::filesystem::path> files;
+			for (const auto& directory : directories)
+			{
+				for (const auto& file_name : file_names)
+				{
+					std::error_code ec;
+					auto path = directory / file_name;
+					if (std::filesystem::is_regular_file(path, ec))
+					{
+						files.emplace_back(std::move(path));
+					}
+				}
+			}
+
+			return files;
+		}
+
+		// Reads the files once so the following zone load is served from the OS page cache
+		void run_prefetch(prefetch_job& job, const std::vector<std::filesystem::path>& files, const std::size_t budget)
+		{
+			SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+			const auto _ = gsl::finally([]()
+			{
+				SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+			});
+
+			std::vector<char> buffer(1024 * 1024);
+
+			for (const auto& file : files)
+			{
+				std::ifstream stream(file, std::ios::binary);
+				while (stream && !job.cancelled)
+				{
+					const auto remaining = budget - job.bytes_read;
+					if (!remaining)
+					{
+						return;
+					}
+
+					stream.read(buffer.data(), static_cast<std::streamsize>(std::min(buffer.size(), remaining)));
+					job.bytes_read += static_cast<std::size_t>(stream.gcount());
+				}
+
+				if (job.cancelled)
+				{
+					return;
+				}
+			}
+		}
+
+		std::size_t cancel_prefetch()
+		{
+			if (!current_prefetch)
+			{
+				return 0;
+			}
+
+			current_prefetch->cancelled = true;
+			if (current_prefetch->thread.joinable())
+			{
+				current_prefetch->thread.join();
+			}
+
+			const std::size_t bytes_read = current_prefetch->bytes_read;
+			current_prefetch = {};
+
+			return bytes_read;
+		}
+
+		void start_prefetch(const std::string& mapname)
+		{
+			cancel_prefetch();
+
+			auto files = get_map_zone_files(mapname);
+			if (files.empty())
+			{
+				return;
+			}
+
+			const auto budget = static_cast<std::size_t>(sv_map_prefetch_budget->current.integer) * 1024 * 1024;
+
+			current_prefetch = std::make_unique<prefetch_job>();
+			current_prefetch->map_name = mapname;
+
+			auto& job = *current_prefetch;
+			job.thread = utils::thread::create_named_thread("Map Prefetch", [&job, budget, files = std::move(files)]
+			{
+				run_prefetch(job, files, budget);
+			});
+
+			console::info("map_rotation: prefetching '%s'\n", mapname.data());
+		}
+
+		void track_map_change()
+		{
+			if (!pending_map_change.has_value())
+			{
+				return;
+			}
+
+			auto& change = *pending_map_change;
+			const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - change.start);
+
+			// The map was restarted in place or never loaded
+			if (duration > 5min)
+			{
+				pending_map_change = {};
+				return;
+			}
+
+			if (!game::SV_Loaded())
+			{
+				change.unloaded = true;
+				return;
+			}
+
+			auto* mapname = game::Dvar_FindVar("mapname");
+			if (!change.unloaded || !mapname || change.map_name != mapname->current.string)
+			{
+				return;
+			}
+
+			if (change.prefetched_bytes)
+			{
+				console::info("map_rotation: changing to '%s' took %lld msec (%zu MB prefetched)\n",
+					change.map_name.data(), duration.count(), change.prefetched_bytes / (1024 * 1024));
+			}
+			else
+			{
+				console::info("map_rotation: changing to '%s' took %lld msec (not prefetched)\n", change.map_name.data(), duration.count());
+			}
+
+			pending_map_change = {};
+		}
 
 		void set_gametype(const std::string& gametype)
 		{
@@ -32,6 +215,12 @@ namespace map_rotation
 		{
 			assert(!mapname.empty());
 
+			// Don't compete with the engine for disk bandwidth while it loads the map
+			const auto is_prefetched = current_prefetch && current_prefetch->map_name == mapname;
+			const auto prefetched_bytes = cancel_prefetch();
+
+			pending_map_change = map_change{mapname, std::chrono::steady_clock::now(), is_prefetched ? prefetched_bytes : 0, false};
+
 			command::execute(utils::string::va("map %s", mapname.data()), false);
 		}
 
@@ -95,6 +284,15 @@ namespace map_rotation
 			}
 		}
 
+		void randomize_map_rotation()
+		{
+			if (sv_random_map_rotation->current.enabled)
+			{
+				console::info("Randomizing the map rotation\n");
+				dedicated_rotation.randomize();
+			}
+		}
+
 		void load_rotation(const std::string& data)
 		{
 			static auto loaded = false;
@@ -112,6 +310,8 @@ namespace map_rotation
 			{
 				console::error("%s: %s contains invalid data!\n", ex.what(), sv_map_rotation->name);
 			}
+
+			randomize_map_rotation();
 #ifdef _DEBUG
 			console::info("dedicated_rotation size after parsing is '%zu'\n", dedicated_rotation.get_entries_size());
 #endif
@@ -156,15 +356,6 @@ namespace map_rotation
 			apply_rotation(rotation_current);
 		}
 
-		void randomize_map_rotation()
-		{
-			if (sv_random_map_rotation->current.enabled)
-			{
-				console::info("Randomizing the map rotation\n");
-				dedicated_rotation.randomize();
-			}
-		}
-
 		void perform_map_rotation()
 		{
 			if (game::Live_SyncOnlineDataFlags(0) != 0)
@@ -194,9 +385,65 @@ namespace map_rotation
 				return;
 			}
 
+			apply_rotation(dedicated_rotation);
+
+			// Shuffle for the next rotation right away so the upcoming map is known while the match runs
 			randomize_map_rotation();
+		}
 
-			apply_rotation(dedicated_rotation);
+		std::optional<std::string> get_upcoming_map()
+		{
+			if (!sv_map_rotation || !sv_map_rotation_current)
+			{
+				return {};
+			}
+
+			const std::string map_rotation_current = sv_map_rotation_current->current.string;
+			if (!map_rotation_current.empty())
+			{
+				rotation_data rotation_current;
+
+				try
+				{
+					rotation_current.parse(map_rotation_current);
+				}
+				catch (const std::exception&)
+				{
+					return {};
+				}
+
+				return rotation_current.peek_next_map();
+			}
+
+			load_map_rotation();
+			return dedicated_rotation.peek_next_map();
+		}
+
+		void update_prefetch()
+		{
+			if (!sv_map_prefetch->current.enabled || !sv_map_prefetch_budget->current.integer)
+			{
+				cancel_prefetch();
+				return;
+			}
+
+			if (!game::SV_Loaded() || pending_map_change.has_value())
+			{
+				return;
+			}
+
+			const auto upcoming_map = get_upcoming_map();
+			if (!upcoming_map.has_value() || !game::SV_MapExists(upcoming_map->data()))
+			{
+				cancel_prefetch();
+				return;
+			}
+
+			// Restart when the rotation changed since the last prefetch
+			if (!current_prefetch || current_prefetch->map_name != *upcoming_map)
+			{
+				start_prefetch(*upcoming_map);
+			}
 		}
 
 		void trigger_map_rotation()
@@ -258,6 +505,21 @@ namespace map_rotation
 		return this->rotation_entries_.at(index);
 	}
 
+	std::optional<std::string> rotation_data::peek_next_map() const
+	{
+		const auto size = this->rotation_entries_.size();
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			const auto& entry = this->rotation_entries_[(this->index_ + i) % size];
+			if (entry.first == "map"s)
+			{
+				return entry.second;
+			}
+		}
+
+		return {};
+	}
+
 	void rotation_data::parse(const std::string& data)
 	{
 		const auto tokens = utils::string::split(data, ' ');
@@ -294,11 +556,21 @@ namespace map_rotation
 			}, scheduler::pipeline::main);
 
 			sv_random_map_rotation = game::Dvar_RegisterBool("sv_randomMapRotation", false, game::DVAR_FLAG_NONE);
+			sv_map_prefetch = game::Dvar_RegisterBool("sv_mapPrefetch", true, game::DVAR_FLAG_NONE);
+			sv_map_prefetch_budget = game::Dvar_RegisterInt("sv_mapPrefetchBudget", 1024, 0, 16384, game::DVAR_FLAG_NONE);
 
 			command::add("map_rotate", &perform_map_rotation);
 
 			// Hook GScr_ExitLevel 
 			utils::hook::jump(0x14032E490, &trigger_map_rotation);
+
+			scheduler::loop(track_map_change, scheduler::pipeline::main);
+			scheduler::loop(update_prefetch, scheduler::pipeline::main, 5s);
+		}
+
+		void pre_destroy() override
+		{
+			cancel_prefetch();
 		}
 	};
 }
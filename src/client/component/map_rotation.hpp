@@ -25,6 +25,9 @@ namespace map_rotation
 		[[nodiscard]] std::size_t get_entries_size() const noexcept;
 		[[nodiscard]] rotation_entry& get_next_entry();
 
+		// Returns the map the next rotation will load without advancing it
+		[[nodiscard]] std::optional<std::string> peek_next_map() const;
+
 		void parse(const std::string& data);
 
 	private:
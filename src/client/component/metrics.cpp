@@ -0,0 +1,279 @@
+#include <std_include.hpp>
+#include "loader/component_loader.hpp"
+#include "game/game.hpp"
+
+#include "console.hpp"
+#include "metrics.hpp"
+#include "scheduler.hpp"
+
+#include "gsc/script_telemetry.hpp"
+
+#include <utils/concurrency.hpp>
+#include <utils/http_server.hpp>
+#include <utils/io.hpp>
+#include <utils/thread.hpp>
+
+namespace metrics
+{
+	namespace
+	{
+		utils::metrics::registry& get_registry()
+		{
+			static utils::metrics::registry registry{};
+			return registry;
+		}
+
+		const game::dvar_t* sv_metrics_address;
+		const game::dvar_t* sv_metrics_allow_remote;
+		const game::dvar_t* sv_metrics_file;
+		const game::dvar_t* sv_metrics_file_interval;
+
+		struct exporter_config
+		{
+			std::string address;
+			bool allow_remote{};
+			std::string file;
+			std::chrono::seconds file_interval{};
+		};
+
+		utils::concurrency::container<exporter_config> config;
+
+		std::atomic_bool terminate_exporter{false};
+		std::thread exporter_thread;
+
+		utils::http_server::response handle_request(const std::string_view path)
+		{
+			if (path != "/metrics" && path != "/")
+			{
+				return {404, "text/plain; charset=utf-8", "Not Found\n"};
+			}
+
+			return {200, "text/plain; version=0.0.4; charset=utf-8", render()};
+		}
+
+		void start_listener(utils::http_server& server, const exporter_config& current_config)
+		{
+			server.close();
+
+			if (current_config.address.empty())
+			{
+				return;
+			}
+
+			try
+			{
+				server.listen(current_config.address, current_config.allow_remote);
+				console::info("Serving metrics on http://%s/metrics\n", current_config.address.data());
+
+				if (current_config.allow_remote)
+				{
+					console::warn("sv_metricsAllowRemote is set, anyone who can reach %s can read the metrics\n", current_config.address.data());
+				}
+			}
+			catch (const std::exception& e)
+			{
+				console::warn("Failed to serve metrics: %s\n", e.what());
+			}
+		}
+
+		void exporter_main()
+		{
+			utils::http_server server(handle_request);
+			exporter_config listen_config{};
+			auto last_file_write = std::chrono::steady_clock::now();
+
+			while (!terminate_exporter)
+			{
+				const auto current_config = config.access<exporter_config>([](const exporter_config& value)
+				{
+					return value;
+				});
+
+				if (current_config.address != listen_config.address || current_config.allow_remote != listen_config.allow_remote)
+				{
+					listen_config = current_config;
+					start_listener(server, listen_config);
+				}
+
+				// Scrapers are served without blocking, so this returns in time for the file writes
+				server.run_frame(250ms);
+
+				const auto now = std::chrono::steady_clock::now();
+				if (!current_config.file.empty() && now - last_file_write >= current_config.file_interval)
+				{
+					last_file_write = now;
+					utils::io::write_file(current_config.file, render(), false);
+				}
+			}
+		}
+
+		void update_config()
+		{
+			config.access([](exporter_config& value)
+			{
+				value.address = sv_metrics_address->current.string;
+				value.allow_remote = sv_metrics_allow_remote->current.enabled;
+				value.file = sv_metrics_file->current.string;
+				value.file_interval = std::chrono::seconds(sv_metrics_file_interval->current.integer);
+			});
+		}
+
+		struct server_metrics
+		{
+			gauge& clients = get_gauge("sv_clients", "Connected clients, including bots");
+			gauge& bots = get_gauge("sv_bots", "Connected bots");
+			counter& reliable_commands = get_counter("sv_reliable_commands_total", "Reliable server commands queued for clients");
+
+			gauge& script_objects = get_gauge("scr_object_variables", "Live script object variables");
+			gauge& script_children = get_gauge("scr_child_variables", "Live script child variables");
+			gauge& script_threads = get_gauge("scr_threads", "Live script threads");
+			gauge& script_notify_threads = get_gauge("scr_notify_threads", "Script threads waiting on a notify");
+			gauge& script_strings = get_gauge("scr_strings", "Distinct strings held by script variables");
+		};
+
+		server_metrics& get_server_metrics()
+		{
+			static server_metrics server{};
+			return server;
+		}
+
+		// Only touched by the server thread, which owns svs_clients
+		std::array<int, 32> last_reliable_sequence{};
+		std::array<bool, 32> known_client{};
+
+		// Set by the main thread while no server runs, the server pipeline doesn't run then
+		std::atomic_bool server_stopped{true};
+
+		void check_server_running()
+		{
+			const auto* sv_running = game::Dvar_FindVar("sv_running");
+			if (!sv_running || !sv_running->current.enabled)
+			{
+				auto& server = get_server_metrics();
+				server.clients.set(0);
+				server.bots.set(0);
+				server_stopped = true;
+			}
+		}
+
+		void sample_server()
+		{
+			auto& server = get_server_metrics();
+
+			// Sequences of the previous server's clients mean nothing anymore
+			if (server_stopped.exchange(false))
+			{
+				known_client = {};
+			}
+
+			const auto* sv_maxclients = game::Dvar_FindVar("sv_maxclients");
+			if (!sv_maxclients)
+			{
+				return;
+			}
+
+			auto client_count = 0;
+			auto bot_count = 0;
+
+			const auto max_clients = std::min(sv_maxclients->current.integer, static_cast<int>(known_client.size()));
+			for (auto i = 0; i < max_clients; ++i)
+			{
+				const auto& client = game::mp::svs_clients[i];
+				const auto& self = game::mp::g_entities[i];
+
+				if (client.header.state >= 1 && self.client)
+				{
+					++client_count;
+					if (game::SV_BotIsBot(i))
+					{
+						++bot_count;
+					}
+				}
+
+				// The sequence restarts with every connection, only count the growth of known clients
+				if (client.header.state < 1)
+				{
+					known_client[i] = false;
+					continue;
+				}
+
+				if (known_client[i] && client.reliableSequence >= last_reliable_sequence[i])
+				{
+					server.reliable_commands.increment(static_cast<std::uint64_t>(client.reliableSequence - last_reliable_sequence[i]));
+				}
+
+				known_client[i] = true;
+				last_reliable_sequence[i] = client.reliableSequence;
+			}
+
+			server.clients.set(client_count);
+			server.bots.set(bot_count);
+
+			const auto usage = gsc::get_variable_usage();
+			server.script_objects.set(usage.objects);
+			server.script_children.set(usage.children);
+			server.script_threads.set(usage.threads);
+			server.script_notify_threads.set(usage.notify_threads);
+			server.script_strings.set(usage.strings);
+		}
+	}
+
+	counter& get_counter(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return get_registry().get_counter(name, help, metric_label);
+	}
+
+	gauge& get_gauge(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return get_registry().get_gauge(name, help, metric_label);
+	}
+
+	histogram& get_histogram(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return get_registry().get_histogram(name, help, metric_label);
+	}
+
+	std::string render()
+	{
+		return get_registry().render();
+	}
+
+	class component final : public component_interface
+	{
+	public:
+		void post_unpack() override
+		{
+			if (game::environment::is_sp())
+			{
+				return;
+			}
+
+			sv_metrics_address = game::Dvar_RegisterString("sv_metricsAddress", "", game::DVAR_FLAG_NONE);
+			sv_metrics_allow_remote = game::Dvar_RegisterBool("sv_metricsAllowRemote", false, game::DVAR_FLAG_NONE);
+			sv_metrics_file = game::Dvar_RegisterString("sv_metricsFile", "", game::DVAR_FLAG_NONE);
+			sv_metrics_file_interval = game::Dvar_RegisterInt("sv_metricsFileInterval", 10, 1, 3600, game::DVAR_FLAG_NONE);
+
+			scheduler::loop([]
+			{
+				update_config();
+				check_server_running();
+			}, scheduler::pipeline::main, 1s);
+
+			scheduler::loop(sample_server, scheduler::pipeline::server, 1s);
+
+			exporter_thread = utils::thread::create_named_thread("Metrics Exporter", exporter_main);
+		}
+
+		void pre_destroy() override
+		{
+			terminate_exporter = true;
+
+			if (exporter_thread.joinable())
+			{
+				exporter_thread.join();
+			}
+		}
+	};
+}
+
+REGISTER_COMPONENT(metrics::component)
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <utils/metrics.hpp>
+
+namespace metrics
+{
+	// Updating a metric never locks, only looking one up does, so callers should keep the reference
+	using utils::metrics::counter;
+	using utils::metrics::gauge;
+	using utils::metrics::histogram;
+	using utils::metrics::label;
+
+	counter& get_counter(const std::string& name, const std::string& help, const label& metric_label = {});
+	gauge& get_gauge(const std::string& name, const std::string& help, const label& metric_label = {});
+	histogram& get_histogram(const std::string& name, const std::string& help, const label& metric_label = {});
+
+	// All metrics in the Prometheus text format
+	std::string render();
+}
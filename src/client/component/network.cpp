@@ -5,7 +5,9 @@
 #include "command.hpp"
 #include "console.hpp"
 #include "dvars.hpp"
+#include "metrics.hpp"
 #include "network.hpp"
+#include "network_commands.hpp"
 #include "party.hpp"
 
 #include <utils/hook.hpp>
@@ -15,29 +17,48 @@ namespace network
 {
 	namespace
 	{
-		std::unordered_map<std::string, callback>& get_callbacks()
+		struct command_handler
 		{
-			static std::unordered_map<std::string, callback> callbacks{};
+			callback function;
+			metrics::counter* packets;
+		};
+
+		command_table<command_handler>& get_callbacks()
+		{
+			static command_table<command_handler> callbacks{};
 			return callbacks;
 		}
 
-		bool handle_command(game::netadr_s* address, const char* command, game::msg_t* message)
+		bool dispatch_command(game::netadr_s* address, const char* command, game::msg_t* message)
 		{
-			const auto cmd_string = utils::string::to_lower(command);
-			auto& callbacks = get_callbacks();
-			const auto handler = callbacks.find(cmd_string);
-			const auto offset = cmd_string.size() + 5;
-			if (message->cursize < offset || handler == callbacks.end())
+			size_t length{};
+			const auto* handler = get_callbacks().find(command, &length);
+			const auto offset = length + 5;
+			if (!handler || message->cursize < 0 || static_cast<size_t>(message->cursize) < offset)
 			{
 				return false;
 			}
 
-			const std::string data(message->data + offset, message->cursize - offset);
+			const std::string_view data(message->data + offset, message->cursize - offset);
 
-			handler->second(*address, data);
+			handler->packets->increment();
+			handler->function(*address, data);
 			return true;
 		}
 
+		bool handle_command(game::netadr_s* address, const char* command, game::msg_t* message)
+		{
+			if (dispatch_command(address, command, message))
+			{
+				return true;
+			}
+
+			// Commands are sent by anyone, only the registered ones get their own label
+			static auto& other_packets = metrics::get_counter("net_oob_packets_total", "Out of band packets per command", {"command", "other"});
+			other_packets.increment();
+			return false;
+		}
+
 		void handle_command_stub(utils::hook::assembler& a)
 		{
 			const auto return_unhandled = a.newLabel();
@@ -106,7 +127,9 @@ namespace network
 
 	void on(const std::string& command, const callback& callback)
 	{
-		get_callbacks()[utils::string::to_lower(command)] = callback;
+		const auto name = utils::string::to_lower(command);
+		auto& packets = metrics::get_counter("net_oob_packets_total", "Out of band packets per command", {"command", name});
+		get_callbacks().add(name, {callback, &packets});
 	}
 
 	int dw_send_to_stub(const int size, const char* src, game::netadr_s* a3)
@@ -116,14 +139,10 @@ namespace network
 		return sendto(*game::query_socket, src, size, 0, &s, 16) >= 0;
 	}
 
-	void send(const game::netadr_s& address, const std::string& command, const std::string& data, const char separator)
+	void send(const game::netadr_s& address, const std::string_view& command, const std::string_view& data,
+	          const char separator)
 	{
-		std::string packet = "\xFF\xFF\xFF\xFF";
-		packet.append(command);
-		packet.push_back(separator);
-		packet.append(data);
-
-		send_data(address, packet);
+		send_data(address, {"\xFF\xFF\xFF\xFF"sv, command, {&separator, 1}, data});
 	}
 
 	void send_data(const game::netadr_s& address, const std::string& data)
@@ -146,6 +165,42 @@ namespace network
 		}
 	}
 
+	void send_data(const game::netadr_s& address, const std::initializer_list<std::string_view>& buffers)
+	{
+		constexpr auto max_buffers = 8;
+
+		// Loopback and the sp socket can only take a contiguous packet
+		if (address.type == game::NA_LOOPBACK || game::environment::is_sp() || buffers.size() > max_buffers)
+		{
+			static thread_local std::string packet{};
+			packet.clear();
+
+			for (const auto& buffer : buffers)
+			{
+				packet.append(buffer);
+			}
+
+			send_data(address, packet);
+			return;
+		}
+
+		WSABUF wsa_buffers[max_buffers]{};
+		DWORD count = 0;
+
+		for (const auto& buffer : buffers)
+		{
+			wsa_buffers[count].buf = const_cast<char*>(buffer.data());
+			wsa_buffers[count].len = static_cast<ULONG>(buffer.size());
+			++count;
+		}
+
+		sockaddr s = {};
+		game::NetadrToSockadr(const_cast<game::netadr_s*>(&address), &s);
+
+		DWORD sent{};
+		WSASendTo(*game::query_socket, wsa_buffers, count, &sent, 0, &s, sizeof(s), nullptr, nullptr);
+	}
+
 	bool are_addresses_equal(const game::netadr_s& a, const game::netadr_s& b)
 	{
 		return net_compare_address(&a, &b);
@@ -283,14 +338,14 @@ namespace network
 				if (!game::environment::is_dedi())
 				{
 					// we need this on the client for RCon
-					on("print", [](const game::netadr_s& address, const std::string& message)
+					on("print", [](const game::netadr_s& address, const std::string_view& message)
 					{
 						if (address != party::get_target())
 						{
 							return;
 						}
 
-						console::info("%s", message.data());
+						console::info("%.*s", static_cast<int>(message.size()), message.data());
 					});
 				}
 
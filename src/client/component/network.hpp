@@ -2,11 +2,13 @@
 
 namespace network
 {
-	using callback = std::function<void(const game::netadr_s&, const std::string&)>;
+	// The payload points into the received message and is only valid during the callback
+	using callback = std::function<void(const game::netadr_s&, const std::string_view&)>;
 
 	void on(const std::string& command, const callback& callback);
-	void send(const game::netadr_s& address, const std::string& command, const std::string& data = {}, char separator = ' ');
+	void send(const game::netadr_s& address, const std::string_view& command, const std::string_view& data = {}, char separator = ' ');
 	void send_data(const game::netadr_s& address, const std::string& data);
+	void send_data(const game::netadr_s& address, const std::initializer_list<std::string_view>& buffers);
 
 	bool are_addresses_equal(const game::netadr_s& a, const game::netadr_s& b);
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace network
+{
+	using command_hash = std::uint64_t;
+
+	inline char to_lower_ascii(const char c)
+	{
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	// Case-insensitive FNV-1a, computes the length alongside so incoming commands are walked only once
+	inline command_hash hash_command(const char* command, size_t* length)
+	{
+		command_hash hash = 0xCBF29CE484222325;
+
+		size_t i = 0;
+		for (; command[i]; ++i)
+		{
+			hash ^= static_cast<std::uint8_t>(to_lower_ascii(command[i]));
+			hash *= 0x100000001B3;
+		}
+
+		*length = i;
+		return hash;
+	}
+
+	// OOB handlers keyed by the hash of their command. The lowercase name is kept and compared
+	// on lookup, so a command that only shares the hash never reaches a handler, and registering
+	// a different command with the same hash throws instead of replacing the first one.
+	template <typename Handler, command_hash (*Hash)(const char*, size_t*) = hash_command>
+	class command_table final
+	{
+	public:
+		// Registering the same command again replaces its handler
+		void add(const std::string& command, Handler handler)
+		{
+			size_t length{};
+			const auto hash = Hash(command.data(), &length);
+
+			std::string name(command.data(), length);
+			for (auto& c : name)
+			{
+				c = to_lower_ascii(c);
+			}
+
+			const auto entry = this->handlers_.find(hash);
+			if (entry != this->handlers_.end() && entry->second.name != name)
+			{
+				throw std::runtime_error("OOB command '" + name + "' has the same hash as '" + entry->second.name + "'");
+			}
+
+			this->handlers_.insert_or_assign(hash, command_entry{std::move(name), std::move(handler)});
+		}
+
+		// Returns null for unknown commands, the length of the command is returned either way
+		const Handler* find(const char* command, size_t* length) const
+		{
+			const auto hash = Hash(command, length);
+
+			const auto entry = this->handlers_.find(hash);
+			if (entry == this->handlers_.end())
+			{
+				return nullptr;
+			}
+
+			const auto& name = entry->second.name;
+			if (name.size() != *length)
+			{
+				return nullptr;
+			}
+
+			for (size_t i = 0; i < *length; ++i)
+			{
+				if (name[i] != to_lower_ascii(command[i]))
+				{
+					return nullptr;
+				}
+			}
+
+			return &entry->second.handler;
+		}
+
+		size_t size() const
+		{
+			return this->handlers_.size();
+		}
+
+	private:
+		struct command_entry
+		{
+			std::string name;
+			Handler handler;
+		};
+
+		std::unordered_map<command_hash, command_entry> handlers_;
+	};
+}
@@ -6,6 +6,7 @@
 #include "scheduler.hpp"
 #include "notifies.hpp"
 #include "scripting.hpp"
+#include "game_events.hpp"
 #include "game_log.hpp"
 
 #include <utils/hook.hpp>
@@ -61,7 +62,7 @@ namespace notifies
 					message.erase(message.begin());
 				}
 
-				scheduler::once([params, message, msg_index, client_num]
+				scheduler::once([params, message, msg_index, client_num, hidden]
 				{
 					const auto* guid = game::SV_GetGuid(client_num);
 					const auto* name = game::mp::svs_clients[client_num].name;
@@ -74,6 +75,8 @@ namespace notifies
 						message.data()
 					);
 
+					game_events::chat(params[0], guid, client_num, name, message, hidden);
+
 				}, scheduler::pipeline::server);
 
 				if (hidden)
@@ -436,20 +436,20 @@ namespace party
 
 			utils::hook::call(0x14048811C, didyouknow_stub); // allow custom didyouknow based on sv_motd
 
-			network::on("getInfo", [](const game::netadr_s& target, const std::string& data)
+			network::on("getInfo", [](const game::netadr_s& target, const std::string_view& data)
 			{
 				utils::info_string info = get_info();
-				info.set("challenge", data);
+				info.set("challenge", std::string{data});
 
 				network::send(target, "infoResponse", info.build(), '\n');
 			});
 
-			network::on("getStatus", [](const game::netadr_s& target, const std::string& data)
+			network::on("getStatus", [](const game::netadr_s& target, const std::string_view& data)
 			{
 				std::string player_list;
 
 				utils::info_string info = get_info();
-				info.set("challenge", data);
+				info.set("challenge", std::string{data});
 
 				const auto* sv_running = game::Dvar_FindVar("sv_running");
 				if (!sv_running || !sv_running->current.enabled)
@@ -492,7 +492,7 @@ namespace party
 				return;
 			}
 
-			network::on("infoResponse", [](const game::netadr_s& target, const std::string& data)
+			network::on("infoResponse", [](const game::netadr_s& target, const std::string_view& data)
 			{
 				const utils::info_string info(data);
 				server_list::handle_info_response(target, info);
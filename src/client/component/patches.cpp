@@ -206,6 +206,8 @@ namespace patches
 			// Register dvars
 			com_register_dvars_hook.create(SELECT_VALUE(0x1402F86F0, 0x1403CF7F0), &com_register_dvars_stub);
 
+			utils::hook::transaction patches{};
+
 			// Unlock fps in main menu
 			utils::hook::set<BYTE>(SELECT_VALUE(0x140144F5B, 0x140213C3B), 0xEB);
 
@@ -229,6 +231,9 @@ namespace patches
 
 			// Fix mouse lag
 			utils::hook::nop(SELECT_VALUE(0x14038FAFF, 0x1404DB1AF), 6);
+
+			patches.commit();
+
 			scheduler::loop([]()
 			{
 				SetThreadExecutionState(ES_DISPLAY_REQUIRED);
@@ -266,6 +271,8 @@ namespace patches
 			dvars::aimassist_enabled = game::Dvar_RegisterBool("aimassist_enabled", true, game::DVAR_FLAG_SAVED);
 			utils::hook::call(0x140003609, aim_assist_add_to_target_list);
 
+			utils::hook::transaction patches{};
+
 			// isProfanity
 			utils::hook::set(0x14023BDC0, 0xC3C033);
 
@@ -302,6 +309,8 @@ namespace patches
 			dvars::override::register_float("safeArea_horizontal", 1, 0, 1, game::DVAR_FLAG_SAVED);
 			dvars::override::register_float("safeArea_vertical", 1, 0, 1, game::DVAR_FLAG_SAVED);
 
+			patches.commit();
+
 			// move chat position on the screen above menu splashes
 			dvars::override::register_vector2("cg_hudChatPosition", 5, 170, 0, 640, game::DVAR_FLAG_SAVED);
 
@@ -65,17 +65,9 @@ namespace redirect
 	class component final : public component_interface
 	{
 	public:
-		void* load_import(const std::string& library, const std::string& function) override
+		void post_start() override
 		{
-			if (library == "SHELL32.dll")
-			{
-				if (function == "ShellExecuteA")
-				{
-					return shell_execute_a;
-				}
-			}
-
-			return nullptr;
+			component_loader::register_import("SHELL32.dll", "ShellExecuteA", shell_execute_a);
 		}
 	};
 }
@@ -45,24 +45,9 @@ namespace resources
 			icon = LoadIconA(self.get_handle(), MAKEINTRESOURCEA(ID_ICON));
 			logo = LoadImageA(self.get_handle(), MAKEINTRESOURCEA(IMAGE_LOGO), 0, 0, 0, LR_COPYFROMRESOURCE);
 			splash = LoadImageA(self.get_handle(), MAKEINTRESOURCEA(IMAGE_SPLASH), 0, 0, 0, LR_COPYFROMRESOURCE);
-		}
-
-		void* load_import(const std::string& library, const std::string& function) override
-		{
-			if (library == "USER32.dll")
-			{
-				if (function == "LoadIconA")
-				{
-					return load_icon_a;
-				}
-
-				if (function == "LoadImageA")
-				{
-					return load_image_a;
-				}
-			}
 
-			return nullptr;
+			component_loader::register_import("USER32.dll", "LoadIconA", load_icon_a);
+			component_loader::register_import("USER32.dll", "LoadImageA", load_image_a);
 		}
 	};
 }
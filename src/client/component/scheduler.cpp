@@ -2,6 +2,7 @@
 #include "loader/component_loader.hpp"
 #include "game/game.hpp"
 
+#include "metrics.hpp"
 #include "scheduler.hpp"
 
 #include <utils/concurrency.hpp>
@@ -86,9 +87,34 @@ namespace scheduler
 		task_pipeline pipelines[pipeline::count];
 		utils::hook::detour r_end_frame_hook;
 
+		const char* pipeline_names[pipeline::count] = {"async", "renderer", "server", "main"};
+
+		// Every pipeline only runs on one thread, so these are never shared
+		metrics::histogram* frame_times[pipeline::count]{};
+		std::chrono::steady_clock::time_point last_frames[pipeline::count]{};
+
+		void record_frame_time(const pipeline type)
+		{
+			auto& frame_time = frame_times[type];
+			if (!frame_time)
+			{
+				frame_time = &metrics::get_histogram("scheduler_frame_seconds", "Time between two frames of a scheduler pipeline",
+					{"pipeline", pipeline_names[type]});
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (last_frames[type] != std::chrono::steady_clock::time_point{})
+			{
+				frame_time->observe(now - last_frames[type]);
+			}
+
+			last_frames[type] = now;
+		}
+
 		void execute(const pipeline type)
 		{
 			assert(type >= 0 && type < pipeline::count);
+			record_frame_time(type);
 			pipelines[type].execute();
 		}
 
@@ -13,10 +13,6 @@
 
 namespace scripting
 {
-	std::unordered_map<std::string, std::unordered_map<std::string, const char*>> script_function_table;
-	std::unordered_map<std::string, std::vector<std::pair<std::string, const char*>>> script_function_table_sort;
-	std::unordered_map<const char*, std::pair<std::string, std::string>> script_function_table_rev;
-
 	std::string current_file;
 
 	namespace
@@ -34,6 +30,103 @@ namespace scripting
 
 		std::unordered_map<unsigned int, std::string> canonical_string_table;
 
+		// Functions of the script currently being processed, finalized once the whole file was linked
+		struct script_file_builder
+		{
+			std::string script_name;
+			std::uint32_t file_id;
+			std::string file_name;
+			std::vector<std::pair<unsigned int, const char*>> functions;
+		};
+
+		struct script_function_range
+		{
+			const char* start;
+			const char* end;
+			unsigned int id;
+			std::uint32_t file_index;
+		};
+
+		// Kept across files so their function buffers don't have to be reallocated
+		std::vector<script_file_builder> script_file_builders;
+		std::size_t script_file_depth = 0;
+
+		std::vector<std::string> script_file_names;
+		std::unordered_map<std::string, std::uint32_t> script_file_indices;
+
+		std::vector<script_function_range> script_function_ranges;
+		bool script_function_ranges_sorted = true;
+
+		void clear_function_tables()
+		{
+			script_file_depth = 0;
+			script_file_names.clear();
+			script_file_indices.clear();
+			script_function_ranges.clear();
+			script_function_ranges_sorted = true;
+		}
+
+		std::uint32_t get_file_index(const std::string& file_name)
+		{
+			const auto [itr, inserted] = script_file_indices.try_emplace(file_name, static_cast<std::uint32_t>(script_file_names.size()));
+			if (inserted)
+			{
+				script_file_names.emplace_back(file_name);
+			}
+
+			return itr->second;
+		}
+
+		script_file_builder& begin_script_file(const char* script_name)
+		{
+			if (script_file_depth == script_file_builders.size())
+			{
+				script_file_builders.emplace_back();
+				script_file_builders.back().functions.reserve(256);
+			}
+
+			auto& builder = script_file_builders[script_file_depth++];
+			builder.script_name = script_name;
+			builder.file_id = current_file_id;
+			builder.file_name = current_file;
+			builder.functions.clear();
+
+			return builder;
+		}
+
+		void finalize_script_file(script_file_builder& builder)
+		{
+			if (builder.functions.empty())
+			{
+				return;
+			}
+
+			const auto file_index = get_file_index(builder.file_id ? get_token(builder.file_id) : builder.file_name);
+
+			const char* end = nullptr;
+			if (const auto* script = gsc::find_script(game::ASSET_TYPE_SCRIPTFILE, builder.script_name.data(), false))
+			{
+				end = reinterpret_cast<const char*>(&script->bytecode[script->bytecodeLen]);
+			}
+
+			std::ranges::sort(builder.functions, {}, &std::pair<unsigned int, const char*>::second);
+
+			for (std::size_t i = 0; i < builder.functions.size(); ++i)
+			{
+				const auto [id, pos] = builder.functions[i];
+				const auto* function_end = i + 1 < builder.functions.size() ? builder.functions[i + 1].second : end;
+
+				// Without the end of the bytecode the last function can't be bounded
+				if (function_end)
+				{
+					script_function_ranges.emplace_back(script_function_range{pos, function_end, id, file_index});
+				}
+			}
+
+			script_function_ranges_sorted = false;
+			builder.functions.clear();
+		}
+
 		std::vector<std::function<void(int)>> shutdown_callbacks;
 		std::vector<std::function<void()>> init_callbacks;
 
@@ -53,9 +146,7 @@ namespace scripting
 		{
 			if (clear_scripts)
 			{
-				script_function_table_sort.clear();
-				script_function_table.clear();
-				script_function_table_rev.clear();
+				clear_function_tables();
 				canonical_string_table.clear();
 			}
 
@@ -82,51 +173,29 @@ namespace scripting
 				current_file = filename;
 			}
 
-			process_script_hook.invoke<void>(filename);
-		}
-
-		void add_function_sort(unsigned int id, const char* pos)
-		{
-			std::string filename = current_file;
-			if (current_file_id)
-			{
-				filename = get_token(current_file_id);
-			}
-
-			if (!script_function_table_sort.contains(filename))
-			{
-				const auto script = gsc::find_script(game::ASSET_TYPE_SCRIPTFILE, current_script_file.data(), false);
-				if (script)
-				{
-					const auto* end = &script->bytecode[script->bytecodeLen];
-					script_function_table_sort[filename].emplace_back("__end__", reinterpret_cast<const char*>(end));
-				}
-			}
+			// Includes are processed recursively and may grow the builder list, so only hold on to the index
+			const auto depth = script_file_depth;
+			begin_script_file(filename);
 
-			const auto name = scripting::get_token(id);
-			auto& itr = script_function_table_sort[filename];
-			itr.insert(itr.end() - 1, {name, pos});
-		}
+			process_script_hook.invoke<void>(filename);
 
-		void add_function(const std::string& file, unsigned int id, const char* pos)
-		{
-			const auto name = get_token(id);
-			script_function_table[file][name] = pos;
-			script_function_table_rev[pos] = {file, name};
+			finalize_script_file(script_file_builders[depth]);
+			script_file_depth = depth;
 		}
 
 		void scr_set_thread_position_stub(unsigned int thread_name, const char* code_pos)
 		{
-			add_function_sort(thread_name, code_pos);
-
-			if (current_file_id)
+			if (script_file_depth)
 			{
-				const auto name = get_token(current_file_id);
-				add_function(name, thread_name, code_pos);
+				script_file_builders[script_file_depth - 1].functions.emplace_back(thread_name, code_pos);
 			}
 			else
 			{
-				add_function(current_file, thread_name, code_pos);
+				auto& builder = begin_script_file(current_script_file.data());
+				builder.functions.emplace_back(thread_name, code_pos);
+
+				finalize_script_file(builder);
+				script_file_depth = 0;
 			}
 
 			scr_set_thread_position_hook.invoke<void>(thread_name, code_pos);
@@ -150,6 +219,29 @@ namespace scripting
 		return find_token(id);
 	}
 
+	std::optional<std::pair<std::string, std::string>> find_function(const char* pos)
+	{
+		if (!script_function_ranges_sorted)
+		{
+			std::ranges::sort(script_function_ranges, {}, &script_function_range::start);
+			script_function_ranges_sorted = true;
+		}
+
+		const auto itr = std::ranges::upper_bound(script_function_ranges, pos, {}, &script_function_range::start);
+		if (itr == script_function_ranges.begin())
+		{
+			return {};
+		}
+
+		const auto& range = *std::prev(itr);
+		if (pos >= range.end)
+		{
+			return {};
+		}
+
+		return {std::make_pair(get_token(range.id), script_file_names[range.file_index])};
+	}
+
 	void on_shutdown(const std::function<void(int)>& callback)
 	{
 		shutdown_callbacks.push_back(callback);
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace server_list
+{
+	enum class sort_key
+	{
+		players,
+		ping,
+		host_name,
+		map_name,
+		game_type,
+		count,
+	};
+
+	struct browser_options
+	{
+		sort_key sort = sort_key::players;
+		bool hide_full = false;
+		bool hide_empty = false;
+
+		bool operator==(const browser_options&) const = default;
+	};
+
+	// Servers need clients, max_clients, ping, host_name, map_name, game_type and order members
+	template <typename Server>
+	bool compare_servers(const Server& a, const Server& b, const sort_key key)
+	{
+		switch (key)
+		{
+		case sort_key::ping:
+			if (a.ping != b.ping)
+			{
+				return a.ping < b.ping;
+			}
+			break;
+		case sort_key::host_name:
+			if (a.host_name != b.host_name)
+			{
+				return a.host_name < b.host_name;
+			}
+			break;
+		case sort_key::map_name:
+			if (a.map_name != b.map_name)
+			{
+				return a.map_name < b.map_name;
+			}
+			break;
+		case sort_key::game_type:
+			if (a.game_type != b.game_type)
+			{
+				return a.game_type < b.game_type;
+			}
+			break;
+		default:
+			if (a.clients != b.clients)
+			{
+				return a.clients > b.clients;
+			}
+
+			if (a.ping != b.ping)
+			{
+				return a.ping < b.ping;
+			}
+			break;
+		}
+
+		// Arrival order breaks ties, which keeps insertion stable
+		return a.order < b.order;
+	}
+
+	template <typename Server>
+	bool is_visible(const Server& server, const browser_options& options)
+	{
+		if (options.hide_full && server.clients >= server.max_clients)
+		{
+			return false;
+		}
+
+		if (options.hide_empty && server.clients <= 0)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// Every server in arrival order, and the visible ones kept sorted by binary-search insertion.
+	// Not synchronized, the owner publishes snapshots of the visible list.
+	template <typename Server>
+	class browser_model final
+	{
+	public:
+		using entry = std::shared_ptr<const Server>;
+		using view = std::vector<entry>;
+
+		void clear()
+		{
+			this->servers_.clear();
+			this->visible_.clear();
+			this->next_order_ = 0;
+			this->dirty_ = true;
+		}
+
+		void insert(Server&& server)
+		{
+			server.order = this->next_order_++;
+
+			auto server_entry = std::make_shared<const Server>(std::move(server));
+			this->servers_.push_back(server_entry);
+
+			if (!is_visible(*server_entry, this->options_))
+			{
+				return;
+			}
+
+			const auto key = this->options_.sort;
+			const auto position = std::ranges::upper_bound(this->visible_, server_entry,
+				[key](const entry& a, const entry& b)
+				{
+					return compare_servers(*a, *b, key);
+				});
+
+			this->visible_.insert(position, std::move(server_entry));
+			this->dirty_ = true;
+		}
+
+		// Filters and sorts all servers again if the options changed
+		void set_options(const browser_options& options)
+		{
+			if (options == this->options_)
+			{
+				return;
+			}
+
+			this->options_ = options;
+			this->visible_.clear();
+
+			for (const auto& server : this->servers_)
+			{
+				if (is_visible(*server, this->options_))
+				{
+					this->visible_.push_back(server);
+				}
+			}
+
+			const auto key = this->options_.sort;
+			std::ranges::sort(this->visible_, [key](const entry& a, const entry& b)
+			{
+				return compare_servers(*a, *b, key);
+			});
+
+			this->dirty_ = true;
+		}
+
+		const browser_options& get_options() const
+		{
+			return this->options_;
+		}
+
+		const view& get_servers() const
+		{
+			return this->servers_;
+		}
+
+		const view& get_visible() const
+		{
+			return this->visible_;
+		}
+
+		// Returns whether the visible list changed since the last call
+		bool consume_changes()
+		{
+			return std::exchange(this->dirty_, false);
+		}
+
+	private:
+		view servers_;
+		view visible_;
+		browser_options options_{};
+		uint64_t next_order_ = 0;
+		bool dirty_ = false;
+	};
+}
@@ -3,6 +3,7 @@
 #include "game/game.hpp"
 
 #include "server_list.hpp"
+#include "server_browser.hpp"
 #include "localized_strings.hpp"
 #include "network.hpp"
 #include "scheduler.hpp"
@@ -31,8 +32,15 @@ namespace server_list
 			game::CodPlayMode play_mode;
 			char in_game;
 			game::netadr_s address;
+
+			// Set when the server is inserted
+			uint64_t order;
+			std::string clients_text;
+			std::string ping_text;
 		};
 
+		using server_view = browser_model<server_info>::view;
+
 		struct
 		{
 			game::netadr_s address{};
@@ -41,16 +49,26 @@ namespace server_list
 		} master_state;
 
 		std::mutex mutex;
-		std::vector<server_info> servers;
+		browser_model<server_info> model{};
+		std::atomic<std::shared_ptr<const server_view>> snapshot{std::make_shared<const server_view>()};
+
+		const game::dvar_t* ui_server_list_sort;
+		const game::dvar_t* ui_server_list_hide_full;
+		const game::dvar_t* ui_server_list_hide_empty;
 
 		size_t server_list_page = 0;
 		volatile bool update_server_list = false;
 		std::chrono::high_resolution_clock::time_point last_scroll{};
 
+		std::shared_ptr<const server_view> get_snapshot()
+		{
+			return snapshot.load(std::memory_order_acquire);
+		}
+
 		size_t get_page_count()
 		{
-			const auto count = servers.size() / server_limit;
-			return count + (servers.size() % server_limit > 0);
+			const auto count = get_snapshot()->size();
+			return count / server_limit + (count % server_limit > 0);
 		}
 
 		size_t get_page_base_index()
@@ -58,13 +76,52 @@ namespace server_list
 			return server_list_page * server_limit;
 		}
 
+		browser_options get_browser_options()
+		{
+			browser_options options{};
+			if (!ui_server_list_sort)
+			{
+				return options;
+			}
+
+			options.sort = static_cast<sort_key>(ui_server_list_sort->current.integer);
+			options.hide_full = ui_server_list_hide_full->current.enabled;
+			options.hide_empty = ui_server_list_hide_empty->current.enabled;
+			return options;
+		}
+
+		void trigger_refresh()
+		{
+			update_server_list = true;
+		}
+
+		// Must be called with the mutex held
+		void publish_snapshot()
+		{
+			if (!model.consume_changes())
+			{
+				return;
+			}
+
+			snapshot.store(std::make_shared<const server_view>(model.get_visible()), std::memory_order_release);
+
+			const auto page_count = get_page_count();
+			if (server_list_page && server_list_page >= page_count)
+			{
+				server_list_page = page_count ? page_count - 1 : 0;
+			}
+
+			trigger_refresh();
+		}
+
 		void refresh_server_list()
 		{
 			{
 				std::lock_guard<std::mutex> _(mutex);
-				servers.clear();
+				model.clear();
 				master_state.queued_servers.clear();
 				server_list_page = 0;
+				publish_snapshot();
 			}
 
 			party::reset_connect_state();
@@ -78,11 +135,13 @@ namespace server_list
 
 		void join_server(int, int, const int index)
 		{
-			std::lock_guard<std::mutex> _(mutex);
+			const auto servers = get_snapshot();
 
 			const auto i = static_cast<size_t>(index) + get_page_base_index();
-			if (i < servers.size())
+			if (i < servers->size())
 			{
+				const auto& server = *(*servers)[i];
+
 				static auto last_index = ~0ull;
 				if (last_index != i)
 				{
@@ -90,26 +149,20 @@ namespace server_list
 				}
 				else
 				{
-					printf("Connecting to (%d - %zu): %s\n", index, i, servers[i].host_name.data());
-					party::connect(servers[i].address);
+					printf("Connecting to (%d - %zu): %s\n", index, i, server.host_name.data());
+					party::connect(server.address);
 				}
 			}
 		}
 
-		void trigger_refresh()
-		{
-			update_server_list = true;
-		}
-
 		int ui_feeder_count()
 		{
-			std::lock_guard<std::mutex> _(mutex);
 			if (update_server_list)
 			{
 				update_server_list = false;
 				return 0;
 			}
-			const auto count = static_cast<int>(servers.size());
+			const auto count = static_cast<int>(get_snapshot()->size());
 			const auto index = get_page_base_index();
 			const auto diff = count - index;
 			return diff > server_limit ? server_limit : static_cast<int>(diff);
@@ -118,67 +171,57 @@ namespace server_list
 		const char* ui_feeder_item_text(int /*localClientNum*/, void* /*a2*/, void* /*a3*/, const int index,
 		                                const int column)
 		{
-			std::lock_guard<std::mutex> _(mutex);
+			// Keeps the returned strings alive until the next call
+			static thread_local std::shared_ptr<const server_view> servers{};
+			servers = get_snapshot();
 
 			const auto i = get_page_base_index() + index;
 
-			if (i >= servers.size())
+			if (i >= servers->size())
 			{
 				return "";
 			}
 
-			if (column == 0)
-			{
-				return servers[i].host_name.empty() ? "" : utils::string::va("%s", servers[i].host_name.data());
-			}
-
-			if (column == 1)
-			{
-				return servers[i].map_name.empty() ? "" : utils::string::va("%s", servers[i].map_name.data());
-			}
-
-			if (column == 2)
-			{
-				return servers[i].game_type.empty() ? "" : utils::string::va("%s", servers[i].game_type.data());
-			}
-
-			if (column == 3)
-			{
-				return utils::string::va("%d/%d [%d]", servers[i].clients, servers[i].max_clients,
-					servers[i].bots);
-			}
+			const auto& server = *(*servers)[i];
 
-			if (column == 4)
+			switch (column)
 			{
-				return servers[i].ping ? utils::string::va("%d", servers[i].ping) : "";
+			case 0:
+				return server.host_name.data();
+			case 1:
+				return server.map_name.data();
+			case 2:
+				return server.game_type.data();
+			case 3:
+				return server.clients_text.data();
+			case 4:
+				return server.ping_text.data();
+			default:
+				return "";
 			}
-
-			return "";
 		}
 
-		void sort_serverlist()
+		void insert_server(server_info&& server)
 		{
-			std::ranges::stable_sort(servers, [](const server_info& a, const server_info& b)
-			{
-				if (a.clients == b.clients)
-				{
-					return a.ping < b.ping;
-				}
+			server.clients_text = std::format("{}/{} [{}]", server.clients, server.max_clients, server.bots);
+			server.ping_text = server.ping ? std::to_string(server.ping) : std::string{};
 
-				return a.clients > b.clients;
-			});
+			std::lock_guard<std::mutex> _(mutex);
+			model.insert(std::move(server));
 		}
 
-		void insert_server(server_info&& server)
+		void update_browser()
 		{
 			std::lock_guard<std::mutex> _(mutex);
-			servers.emplace_back(std::move(server));
-			sort_serverlist();
-			trigger_refresh();
+
+			model.set_options(get_browser_options());
+			publish_snapshot();
 		}
 
 		void do_frame_work()
 		{
+			update_browser();
+
 			auto& queue = master_state.queued_servers;
 			if (queue.empty())
 			{
@@ -257,7 +300,7 @@ namespace server_list
 
 		void resize_host_name(std::string& name)
 		{
-			name = utils::string::split(name, '\n').front();
+			name.resize(std::min(name.find('\n'), name.size()));
 
 			game::Font_s* font;
 			if (game::Com_GetCurrentCoDPlayMode() == game::CODPLAYMODE_ZOMBIES)
@@ -268,13 +311,32 @@ namespace server_list
 			{
 				font = game::R_RegisterFont("fonts/bodyFont");
 			}
-			auto text_size = game::UI_TextWidth(name.data(), 32, font, 1.0f);
 
-			while (text_size > 450)
+			constexpr auto max_width = 450;
+
+			// The width of a prefix only grows with its length, so search for the longest one that fits
+			const auto max_chars = static_cast<int>(std::min(name.size(), static_cast<size_t>(INT_MAX)));
+			if (game::UI_TextWidth(name.data(), max_chars, font, 1.0f) <= max_width)
+			{
+				return;
+			}
+
+			auto low = 0;
+			auto high = max_chars;
+			while (low < high)
 			{
-				text_size = game::UI_TextWidth(name.data(), 32, font, 1.0f);
-				name.pop_back();
+				const auto mid = low + (high - low + 1) / 2;
+				if (game::UI_TextWidth(name.data(), mid, font, 1.0f) <= max_width)
+				{
+					low = mid;
+				}
+				else
+				{
+					high = mid - 1;
+				}
 			}
+
+			name.resize(static_cast<size_t>(low));
 		}
 
 		void lui_open_menu_stub(int /*controllerIndex*/, const char* /*menu*/, int /*a3*/, int /*a4*/,
@@ -381,6 +443,11 @@ namespace server_list
 			utils::hook::call(0x1400F5B55, &ui_feeder_count);
 			utils::hook::call(0x1400F5D35, &ui_feeder_item_text);
 
+			ui_server_list_sort = game::Dvar_RegisterInt("ui_serverListSort", 0, 0,
+			                                             static_cast<int>(sort_key::count) - 1, game::DVAR_FLAG_SAVED);
+			ui_server_list_hide_full = game::Dvar_RegisterBool("ui_serverListHideFull", false, game::DVAR_FLAG_SAVED);
+			ui_server_list_hide_empty = game::Dvar_RegisterBool("ui_serverListHideEmpty", false, game::DVAR_FLAG_SAVED);
+
 			scheduler::loop(do_frame_work, scheduler::pipeline::main);
 
 			network::on("getServersResponse", [](const game::netadr_s& target, const std::string_view& data)
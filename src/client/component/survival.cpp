@@ -31,14 +31,9 @@ namespace survival
 	class component final : public component_interface
 	{
 	public:
-		void* load_import(const std::string& library, const std::string& function) override
+		void post_start() override
 		{
-			if (function == "GetCommandLineA")
-			{
-				return get_commandline_stub;
-			}
-
-			return nullptr;
+			component_loader::register_import({}, "GetCommandLineA", get_commandline_stub);
 		}
 	};
 }
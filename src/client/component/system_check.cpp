@@ -11,40 +11,172 @@ namespace system_check
 {
 	namespace
 	{
-		std::string read_zone(const std::string& name)
+		constexpr auto hash_cache_file = "players2/system_check.json";
+
+		struct file_stamp
 		{
-			std::string data{};
-			if (utils::io::read_file(name, &data))
+			std::uint64_t size{};
+			std::int64_t write_time{};
+
+			bool operator==(const file_stamp&) const = default;
+		};
+
+		struct cached_hash
+		{
+			file_stamp stamp{};
+			std::string hash{};
+		};
+
+		using hash_cache = std::unordered_map<std::string, cached_hash>;
+
+		std::string resolve_zone(const std::string& name)
+		{
+			if (utils::io::file_exists(name))
 			{
-				return data;
+				return name;
 			}
 
-			if (utils::io::read_file("zone/" + name, &data))
+			auto path = "zone/" + name;
+			if (utils::io::file_exists(path))
 			{
-				return data;
+				return path;
 			}
 
 			return {};
 		}
 
-		std::string hash_zone(const std::string& name)
+		std::optional<file_stamp> get_file_stamp(const std::string& path)
+		{
+			std::error_code ec{};
+			const auto size = std::filesystem::file_size(path, ec);
+			if (ec)
+			{
+				return {};
+			}
+
+			const auto write_time = std::filesystem::last_write_time(path, ec);
+			if (ec)
+			{
+				return {};
+			}
+
+			return file_stamp{size, static_cast<std::int64_t>(write_time.time_since_epoch().count())};
+		}
+
+		hash_cache load_hash_cache()
+		{
+			std::string data{};
+			if (!utils::io::read_file(hash_cache_file, &data))
+			{
+				return {};
+			}
+
+			rapidjson::Document doc{};
+			const rapidjson::ParseResult parse_result = doc.Parse(data);
+			if (!parse_result || !doc.IsObject())
+			{
+				return {};
+			}
+
+			hash_cache cache{};
+			for (const auto& entry : doc.GetObj())
+			{
+				const auto& value = entry.value;
+				if (!value.IsObject() || !value.HasMember("size") || !value["size"].IsUint64()
+					|| !value.HasMember("time") || !value["time"].IsInt64()
+					|| !value.HasMember("hash") || !value["hash"].IsString())
+				{
+					continue;
+				}
+
+				auto& cached = cache[entry.name.GetString()];
+				cached.stamp.size = value["size"].GetUint64();
+				cached.stamp.write_time = value["time"].GetInt64();
+				cached.hash = value["hash"].GetString();
+			}
+
+			return cache;
+		}
+
+		void save_hash_cache(const hash_cache& cache)
 		{
-			const auto data = read_zone(name);
-			return utils::cryptography::sha256::compute(data, true);
+			rapidjson::Document doc{};
+			doc.SetObject();
+
+			auto& allocator = doc.GetAllocator();
+			for (const auto& [path, cached] : cache)
+			{
+				rapidjson::Value value{};
+				value.SetObject();
+				value.AddMember("size", cached.stamp.size, allocator);
+				value.AddMember("time", cached.stamp.write_time, allocator);
+				value.AddMember("hash", rapidjson::Value(cached.hash.data(), allocator), allocator);
+
+				doc.AddMember(rapidjson::Value(path.data(), allocator), value, allocator);
+			}
+
+			rapidjson::StringBuffer buffer{};
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+			doc.Accept(writer);
+
+			utils::io::write_file(hash_cache_file, std::string(buffer.GetString(), buffer.GetLength()));
 		}
 
 		bool verify_hashes(const std::unordered_map<std::string, std::string>& zone_hashes)
 		{
+			struct pending_hash
+			{
+				std::string path;
+				file_stamp stamp;
+				std::string expected_hash;
+				std::future<std::string> hash;
+			};
+
+			auto cache = load_hash_cache();
+			std::vector<pending_hash> pending{};
+			auto valid = true;
+
 			for (const auto& zone_hash : zone_hashes)
 			{
-				const auto hash = hash_zone(zone_hash.first);
-				if (hash != zone_hash.second)
+				const auto path = resolve_zone(zone_hash.first);
+				const auto stamp = path.empty() ? std::optional<file_stamp>{} : get_file_stamp(path);
+				if (!stamp)
+				{
+					valid = false;
+					continue;
+				}
+
+				// Unchanged files are never rehashed
+				const auto cached = cache.find(path);
+				if (cached != cache.end() && cached->second.stamp == *stamp)
+				{
+					valid &= cached->second.hash == zone_hash.second;
+					continue;
+				}
+
+				pending.emplace_back(path, *stamp, zone_hash.second, std::async(std::launch::async, [path]()
+				{
+					return utils::cryptography::sha256::compute_file(path, true);
+				}));
+			}
+
+			for (auto& entry : pending)
+			{
+				const auto hash = entry.hash.get();
+				valid &= hash == entry.expected_hash;
+
+				if (!hash.empty())
 				{
-					return false;
+					cache[entry.path] = {entry.stamp, hash};
 				}
 			}
 
-			return true;
+			if (!pending.empty())
+			{
+				save_hash_cache(cache);
+			}
+
+			return valid;
 		}
 
 		bool is_system_valid()
@@ -61,7 +193,14 @@ namespace system_check
 				{"patch_common_zm_mp.ff", "DA16B546B7233BBC4F48E1E9084B49218CB9271904EA7120A0EB4CB8723C19CF"},
 			};
 
-			return verify_hashes(mp_zone_hashes) && (game::environment::is_dedi() || verify_hashes(sp_zone_hashes));
+			// Verify everything in one go so the files are hashed in parallel
+			auto zone_hashes = mp_zone_hashes;
+			if (!game::environment::is_dedi())
+			{
+				zone_hashes.insert(sp_zone_hashes.begin(), sp_zone_hashes.end());
+			}
+
+			return verify_hashes(zone_hashes);
 		}
 
 		void verify_binary_version()
@@ -15,6 +15,7 @@
 
 #include "ui_scripting.hpp"
 
+#include <utils/cryptography.hpp>
 #include <utils/hook.hpp>
 #include <utils/io.hpp>
 
@@ -28,38 +29,40 @@ namespace ui_scripting
 		utils::hook::detour hks_shutdown_hook;
 		utils::hook::detour hks_package_require_hook;
 
-		struct script
-		{
-			std::string name;
-			std::string root;
-		};
+		// Cached bytecode is loaded into the VM as is, and malformed bytecode can do anything the
+		// client can. The hashes only catch stale or corrupted entries, so this folder must not be
+		// writable by anyone who isn't trusted to run code on this machine.
+		constexpr auto bytecode_cache_folder = "players2/cache/ui_scripts/";
+
+		// Magic, source hash, payload length, payload hash, payload
+		constexpr std::string_view bytecode_cache_magic = "S1HKSC02";
 
 		struct globals
 		{
 			std::string in_require_script;
-			std::vector<script> loaded_scripts;
+			std::unordered_map<std::string, std::string> loaded_scripts;
 			bool load_raw_script{};
 			std::string raw_script_name{};
+			size_t cached_scripts{};
 		};
 
 		globals globals{};
 
+		// The VM may reference loaded bytecode in place, so the buffers are kept until it shuts down
+		// Each one is allocated separately, as moving a std::string can move its characters as well
+		std::vector<std::unique_ptr<std::string>> bytecode_buffers;
+
 		bool is_loaded_script(const std::string& name)
 		{
-			return std::ranges::any_of(globals.loaded_scripts, [name](const auto& loaded_script)
-			{
-				return loaded_script.name == name;
-			});
+			return globals.loaded_scripts.contains(name);
 		}
 
 		std::string get_root_script(const std::string& name)
 		{
-			for (const auto& loaded_script : globals.loaded_scripts)
+			const auto loaded_script = globals.loaded_scripts.find(name);
+			if (loaded_script != globals.loaded_scripts.end())
 			{
-				if (loaded_script.name == name)
-				{
-					return loaded_script.root;
-				}
+				return loaded_script->second;
 			}
 
 			return {};
@@ -106,24 +109,149 @@ namespace ui_scripting
 			return game::hks::hksi_hksL_loadbuffer(state, &compiler_settings, data.data(), data.size(), name.data());
 		}
 
-		void load_script(const std::string& name, const std::string& data)
+		std::optional<function> load_chunk(const std::string& name, const std::string& data, std::string* error)
+		{
+			const auto state = *game::hks::lua_state;
+			const auto top = state->m_apistack.top;
+			const auto _0 = gsl::finally([&]()
+			{
+				state->m_apistack.top = top;
+			});
+
+			const auto result = load_buffer(name, data);
+			if (state->m_apistack.top == top)
+			{
+				return {};
+			}
+
+			const auto value = get_return_value(0);
+			if (result == 0 && value.is<function>())
+			{
+				return value.as<function>();
+			}
+
+			if (error && value.is<std::string>())
+			{
+				*error = value.as<std::string>();
+			}
+
+			return {};
+		}
+
+		std::string get_bytecode_cache_path(const std::string& name)
 		{
-			globals.loaded_scripts.push_back({name, name});
+			return bytecode_cache_folder + utils::cryptography::sha1::compute(name, true) + ".hksc";
+		}
+
+		std::optional<std::string> read_cached_bytecode(const std::string& name, const std::string& source_hash)
+		{
+			std::string data{};
+			if (!utils::io::read_file(get_bytecode_cache_path(name), &data))
+			{
+				return {};
+			}
+
+			const auto length_offset = bytecode_cache_magic.size() + source_hash.size();
+			const auto hash_offset = length_offset + sizeof(uint64_t);
+			const auto header_size = hash_offset + source_hash.size();
+
+			if (data.size() <= header_size || !data.starts_with(bytecode_cache_magic)
+				|| data.compare(bytecode_cache_magic.size(), source_hash.size(), source_hash) != 0)
+			{
+				return {};
+			}
+
+			uint64_t length{};
+			std::memcpy(&length, data.data() + length_offset, sizeof(length));
+			if (length != data.size() - header_size)
+			{
+				return {};
+			}
+
+			auto bytecode = data.substr(header_size);
+			if (data.compare(hash_offset, source_hash.size(), utils::cryptography::sha1::compute(bytecode)) != 0)
+			{
+				return {};
+			}
+
+			return bytecode;
+		}
 
+		void write_cached_bytecode(const std::string& name, const std::string& source_hash, const function& chunk)
+		{
 			const auto lua = get_globals();
-			const auto load_results = lua["loadstring"](data, name);
+			if (!lua["string"].is<table>() || !lua["string"]["dump"].is<function>())
+			{
+				return;
+			}
+
+			// Bytecode contains null bytes, so the length has to come from the VM along with the dump
+			const std::string dumper_source = "return function(f) local s = string.dump(f) return s, #s end";
+			const auto dumper = lua["loadstring"](dumper_source)[0]()[0];
+			const auto results = dumper(chunk);
+			if (results.size() < 2 || !results[0].is<std::string>())
+			{
+				return;
+			}
+
+			const auto& bytecode = results[0].get_raw().v.str;
+			const auto length = static_cast<uint64_t>(results[1].as<int>());
+			const std::string payload(bytecode->m_data, static_cast<size_t>(length));
+
+			std::string data{};
+			data.reserve(bytecode_cache_magic.size() + source_hash.size() * 2 + sizeof(length) + payload.size());
+			data.append(bytecode_cache_magic);
+			data.append(source_hash);
+			data.append(reinterpret_cast<const char*>(&length), sizeof(length));
+			data.append(utils::cryptography::sha1::compute(payload));
+			data.append(payload);
+
+			utils::io::write_file(get_bytecode_cache_path(name), data);
+		}
+
+		std::optional<function> compile_script(const std::string& name, const std::string& data)
+		{
+			const auto source_hash = utils::cryptography::sha1::compute(data);
 
-			if (load_results[0].is<function>())
+			if (auto bytecode = read_cached_bytecode(name, source_hash))
 			{
-				const auto results = lua["pcall"](load_results);
-				if (!results[0].as<bool>())
+				const auto& buffer = *bytecode_buffers.emplace_back(std::make_unique<std::string>(std::move(*bytecode)));
+				if (auto chunk = load_chunk(name, buffer, nullptr))
 				{
-					print_error(results[1].as<std::string>());
+					++globals.cached_scripts;
+					return chunk;
 				}
+
+				bytecode_buffers.pop_back();
 			}
-			else if (load_results[1].is<std::string>())
+
+			std::string error{};
+			auto chunk = load_chunk(name, data, &error);
+			if (!chunk)
 			{
-				print_error(load_results[1].as<std::string>());
+				print_error(error);
+				return {};
+			}
+
+			write_cached_bytecode(name, source_hash, *chunk);
+			return chunk;
+		}
+
+		void load_script(const std::string& name, const std::string& data)
+		{
+			globals.loaded_scripts.emplace(name, name);
+
+			const auto chunk = compile_script(name, data);
+			if (!chunk)
+			{
+				return;
+			}
+
+			const auto lua = get_globals();
+			const auto results = lua["pcall"](*chunk);
+			if (!results[0].as<bool>())
+			{
+				print_error(results[1].as<std::string>());
 			}
 		}
 
@@ -230,8 +358,15 @@ namespace ui_scripting
 			lua["table"]["unpack"] = lua["unpack"];
 			lua["luiglobals"] = lua;
 
+			const auto start_time = std::chrono::high_resolution_clock::now();
+
 			load_scripts(game_module::get_host_module().get_folder() + "/data/ui_scripts/");
 			load_scripts("s1/ui_scripts/");
+
+			const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::high_resolution_clock::now() - start_time);
+			console::info("Loaded %zu LUI scripts (%zu from cache) in %lld ms\n", globals.loaded_scripts.size(),
+			              globals.cached_scripts, duration.count());
 		}
 
 		void try_start()
@@ -255,8 +390,11 @@ namespace ui_scripting
 		void hks_shutdown_stub()
 		{
 			converted_functions.clear();
+			clear_notify_cache();
 			globals = {};
-			return hks_shutdown_hook.invoke<void>();
+
+			hks_shutdown_hook.invoke<void>();
+			bytecode_buffers.clear();
 		}
 
 		void* hks_package_require_stub(game::hks::lua_State* state)
@@ -300,7 +438,7 @@ namespace ui_scripting
 			if (globals.load_raw_script)
 			{
 				globals.load_raw_script = false;
-				globals.loaded_scripts.push_back({globals.raw_script_name, globals.in_require_script});
+				globals.loaded_scripts.emplace(globals.raw_script_name, globals.in_require_script);
 				return load_buffer(globals.raw_script_name, utils::io::read_file(globals.raw_script_name));
 			}
 
@@ -2,6 +2,8 @@
 #include <utils/string.hpp>
 #include "servers/service_server.hpp"
 
+#include <component/metrics.hpp>
+
 namespace demonware
 {
 	class service
@@ -13,6 +15,7 @@ namespace demonware
 		std::mutex mutex_;
 		uint8_t task_id_;
 		std::map<uint8_t, callback_t> tasks_;
+		metrics::counter* requests_;
 
 	public:
 		virtual ~service() = default;
@@ -20,7 +23,8 @@ namespace demonware
 		service(const service&) = delete;
 		service& operator=(const service&) = delete;
 
-		service(const uint8_t id, std::string name) : id_(id), name_(std::move(name)), task_id_(0)
+		service(const uint8_t id, std::string name) : id_(id), name_(std::move(name)), task_id_(0),
+			requests_(&metrics::get_counter("dw_requests_total", "Demonware service requests", {"service", this->name_}))
 		{
 		}
 
@@ -43,6 +47,8 @@ namespace demonware
 		{
 			std::lock_guard<std::mutex> _(this->mutex_);
 
+			this->requests_->increment();
+
 			byte_buffer buffer(data);
 
 			buffer.read_byte(&this->task_id_);
@@ -16,6 +16,7 @@ namespace dvars
 	game::dvar_t* con_inputDvarValueColor = nullptr;
 	game::dvar_t* con_inputDvarInactiveValueColor = nullptr;
 	game::dvar_t* con_inputCmdMatchColor = nullptr;
+	game::dvar_t* con_outputMaxLines = nullptr;
 
 	game::dvar_t* g_playerEjection = nullptr;
 	game::dvar_t* g_playerCollision = nullptr;
@@ -33,6 +33,40 @@ namespace ui_scripting
 
 			game::hks::hks_obj_settable(state, &obj, &key.get_raw(), &value.get_raw());
 		}
+
+		// Lives until the LUI VM shuts down, see clear_notify_cache
+		struct event_dispatcher
+		{
+			userdata root;
+			function process_event;
+		};
+
+		std::optional<event_dispatcher> dispatcher{};
+
+		const event_dispatcher& get_event_dispatcher(game::hks::lua_State* state)
+		{
+			if (dispatcher.has_value())
+			{
+				return *dispatcher;
+			}
+
+			// Only the root and the dispatch function outlive this call, so the lookups don't need references
+			const auto globals = table(state->globals.v.table, borrowed_reference);
+			const auto engine_value = globals.get("Engine");
+			if (!engine_value.is<table>())
+			{
+				throw std::runtime_error("Engine is not a table");
+			}
+
+			const auto engine = table(engine_value.get_raw().v.table, borrowed_reference);
+			const auto get_lui_root = engine.get("GetLuiRoot").as<function>();
+
+			auto root = get_lui_root()[0].as<userdata>();
+			auto process_event = root.get("processEvent").as<function>();
+
+			dispatcher = event_dispatcher{std::move(root), std::move(process_event)};
+			return *dispatcher;
+		}
 	}
 
 	void push_value(const script_value& value)
@@ -108,11 +142,9 @@ namespace ui_scripting
 
 		try
 		{
-			const auto globals = table((*::game::hks::lua_state)->globals.v.table);
-			const auto engine = globals.get("Engine").as<table>();
-			const auto root = engine.get("GetLuiRoot")()[0].as<userdata>();
-			const auto process_event = root.get("processEvent");
+			const auto& dispatch = get_event_dispatcher(state);
 
+			// Handlers may keep the event table, so every event gets a new one
 			table event{};
 			event.set("name", name);
 			event.set("dispatchChildren", true);
@@ -122,7 +154,7 @@ namespace ui_scripting
 				event.set(arg.first, arg.second);
 			}
 
-			process_event(root, event);
+			dispatch.process_event(dispatch.root, event);
 			return true;
 		}
 		catch (const std::exception& e)
@@ -133,6 +165,11 @@ namespace ui_scripting
 		return false;
 	}
 
+	void clear_notify_cache()
+	{
+		dispatcher.reset();
+	}
+
 	arguments call_script_function(const function& function, const arguments& arguments)
 	{
 		const auto state = *game::hks::lua_state;
@@ -23,6 +23,12 @@ namespace ui_scripting
 		this->add();
 	}
 
+	userdata::userdata(void* ptr_, borrowed_reference_t)
+		: ptr(ptr_)
+		, borrowed(true)
+	{
+	}
+
 	userdata::userdata(const userdata& other)
 	{
 		this->operator=(other);
@@ -32,6 +38,7 @@ namespace ui_scripting
 	{
 		this->ptr = other.ptr;
 		this->ref = other.ref;
+		this->borrowed = other.borrowed;
 		other.ref = 0;
 	}
 
@@ -47,6 +54,7 @@ namespace ui_scripting
 			this->release();
 			this->ptr = other.ptr;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			this->add();
 		}
 
@@ -60,6 +68,7 @@ namespace ui_scripting
 			this->release();
 			this->ptr = other.ptr;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			other.ref = 0;
 		}
 
@@ -68,6 +77,12 @@ namespace ui_scripting
 
 	void userdata::add()
 	{
+		if (this->borrowed)
+		{
+			this->ref = 0;
+			return;
+		}
+
 		game::hks::HksObject value{};
 		value.v.ptr = this->ptr;
 		value.t = game::hks::TUSERDATA;
@@ -139,6 +154,12 @@ namespace ui_scripting
 		this->add();
 	}
 
+	table::table(game::hks::HashTable* ptr_, borrowed_reference_t)
+		: ptr(ptr_)
+		, borrowed(true)
+	{
+	}
+
 	table::table(const table& other)
 	{
 		this->operator=(other);
@@ -148,6 +169,7 @@ namespace ui_scripting
 	{
 		this->ptr = other.ptr;
 		this->ref = other.ref;
+		this->borrowed = other.borrowed;
 		other.ref = 0;
 	}
 
@@ -163,6 +185,7 @@ namespace ui_scripting
 			this->release();
 			this->ptr = other.ptr;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			this->add();
 		}
 
@@ -176,6 +199,7 @@ namespace ui_scripting
 			this->release();
 			this->ptr = other.ptr;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			other.ref = 0;
 		}
 
@@ -184,6 +208,12 @@ namespace ui_scripting
 
 	void table::add()
 	{
+		if (this->borrowed)
+		{
+			this->ref = 0;
+			return;
+		}
+
 		game::hks::HksObject value{};
 		value.v.table = this->ptr;
 		value.t = game::hks::TTABLE;
@@ -268,6 +298,13 @@ namespace ui_scripting
 		this->add();
 	}
 
+	function::function(game::hks::cclosure* ptr_, game::hks::HksObjectType type_, borrowed_reference_t)
+		: ptr(ptr_)
+		, type(type_)
+		, borrowed(true)
+	{
+	}
+
 	function::function(const function& other)
 	{
 		this->operator=(other);
@@ -278,6 +315,7 @@ namespace ui_scripting
 		this->ptr = other.ptr;
 		this->type = other.type;
 		this->ref = other.ref;
+		this->borrowed = other.borrowed;
 		other.ref = 0;
 	}
 
@@ -294,6 +332,7 @@ namespace ui_scripting
 			this->ptr = other.ptr;
 			this->type = other.type;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			this->add();
 		}
 
@@ -308,6 +347,7 @@ namespace ui_scripting
 			this->ptr = other.ptr;
 			this->type = other.type;
 			this->ref = other.ref;
+			this->borrowed = other.borrowed;
 			other.ref = 0;
 		}
 
@@ -316,6 +356,12 @@ namespace ui_scripting
 
 	void function::add()
 	{
+		if (this->borrowed)
+		{
+			this->ref = 0;
+			return;
+		}
+
 		game::hks::HksObject value{};
 		value.v.cClosure = this->ptr;
 		value.t = this->type;
@@ -5,6 +5,14 @@
 
 namespace ui_scripting
 {
+	// Wrappers constructed with this tag don't take a registry reference, which makes
+	// them cheap for temporaries. The object must stay reachable from Lua while they live.
+	struct borrowed_reference_t
+	{
+	};
+
+	inline constexpr borrowed_reference_t borrowed_reference{};
+
 	class lightuserdata
 	{
 	public:
@@ -18,6 +26,7 @@ namespace ui_scripting
 	{
 	public:
 		userdata(void*);
+		userdata(void*, borrowed_reference_t);
 
 		userdata(const userdata& other);
 		userdata(userdata&& other) noexcept;
@@ -39,6 +48,7 @@ namespace ui_scripting
 		void release();
 
 		int ref{};
+		bool borrowed{};
 	};
 
 	class userdata_value : public script_value
@@ -59,6 +69,7 @@ namespace ui_scripting
 	public:
 		table();
 		table(game::hks::HashTable* ptr_);
+		table(game::hks::HashTable* ptr_, borrowed_reference_t);
 
 		table(const table& other);
 		table(table&& other) noexcept;
@@ -80,6 +91,7 @@ namespace ui_scripting
 		void release();
 
 		int ref{};
+		bool borrowed{};
 	};
 
 	class table_value : public script_value
@@ -100,6 +112,7 @@ namespace ui_scripting
 	public:
 		function(game::hks::lua_function);
 		function(game::hks::cclosure*, game::hks::HksObjectType);
+		function(game::hks::cclosure*, game::hks::HksObjectType, borrowed_reference_t);
 
 		template <typename F>
 		function(F f)
@@ -136,5 +149,6 @@ namespace ui_scripting
 		void release();
 
 		int ref{};
+		bool borrowed{};
 	};
 }
@@ -23,11 +23,6 @@ public:
 	{
 	}
 
-	virtual void* load_import([[maybe_unused]] const std::string& library, [[maybe_unused]] const std::string& function)
-	{
-		return nullptr;
-	}
-
 	virtual bool is_supported()
 	{
 		return true;
@@ -91,16 +91,42 @@ void component_loader::clean()
 	}
 }
 
+void component_loader::register_import(const std::string& library, const std::string& function, void* function_ptr)
+{
+	auto& overrides = get_imports()[function];
+	for (auto& entry : overrides)
+	{
+		if (entry.library == library)
+		{
+			entry.function = function_ptr;
+			return;
+		}
+	}
+
+	overrides.emplace_back(library, function_ptr);
+}
+
 void* component_loader::load_import(const std::string& library, const std::string& function)
 {
+	auto& imports = get_imports();
+	const auto overrides = imports.find(function);
+	if (overrides == imports.end())
+	{
+		return nullptr;
+	}
+
 	void* function_ptr = nullptr;
 
-	for (const auto& component_ : get_components())
+	for (const auto& entry : overrides->second)
 	{
-		auto* const component_function_ptr = component_->load_import(library, function);
-		if (component_function_ptr)
+		if (entry.library == library)
 		{
-			function_ptr = component_function_ptr;
+			return entry.function;
+		}
+
+		if (entry.library.empty())
+		{
+			function_ptr = entry.function;
 		}
 	}
 
@@ -112,6 +138,12 @@ void component_loader::trigger_premature_shutdown()
 	throw premature_shutdown_trigger();
 }
 
+component_loader::import_table& component_loader::get_imports()
+{
+	static import_table imports{};
+	return imports;
+}
+
 std::vector<std::unique_ptr<component_interface>>& component_loader::get_components()
 {
 	using component_vector = std::vector<std::unique_ptr<component_interface>>;
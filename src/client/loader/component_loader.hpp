@@ -46,12 +46,24 @@ public:
 	static void pre_destroy();
 	static void clean();
 
+	// Import overrides must be registered before the binary is loaded (e.g. in post_start)
+	// An empty library name matches the function in any library
+	static void register_import(const std::string& library, const std::string& function, void* function_ptr);
 	static void* load_import(const std::string& library, const std::string& function);
 
 	static void trigger_premature_shutdown();
 
 private:
+	struct import_override
+	{
+		std::string library;
+		void* function;
+	};
+
+	using import_table = std::unordered_map<std::string, std::vector<import_override>>;
+
 	static std::vector<std::unique_ptr<component_interface>>& get_components();
+	static import_table& get_imports();
 };
 
 #define REGISTER_COMPONENT(name)                          \
@@ -15,10 +15,19 @@ FARPROC loader::load(const utils::nt::library& library, const std::string& buffe
 	const utils::nt::library source(HMODULE(buffer.data()));
 	if (!source) return nullptr;
 
+	auto start = std::chrono::high_resolution_clock::now();
 	this->load_sections(library, source);
+	this->timings_.mapping = std::chrono::high_resolution_clock::now() - start;
+
+	start = std::chrono::high_resolution_clock::now();
 	this->load_imports(library, source);
+	this->timings_.imports = std::chrono::high_resolution_clock::now() - start;
+
 	this->load_exception_table(library, source);
+
+	start = std::chrono::high_resolution_clock::now();
 	this->load_tls(library, source);
+	this->timings_.tls = std::chrono::high_resolution_clock::now() - start;
 
 	DWORD old_protect;
 	VirtualProtect(library.get_nt_headers(), 0x1000, PAGE_EXECUTE_READWRITE, &old_protect);
@@ -35,7 +44,10 @@ FARPROC loader::load(const utils::nt::library& library, const std::string& buffe
 
 FARPROC loader::load_library(const std::string& filename) const
 {
+	auto start = std::chrono::high_resolution_clock::now();
 	const auto target = utils::nt::library::load(filename);
+	this->timings_.mapping = std::chrono::high_resolution_clock::now() - start;
+
 	if (!target)
 	{
 		throw std::runtime_error{"Failed to map binary!"};
@@ -47,8 +59,13 @@ FARPROC loader::load_library(const std::string& filename) const
 		throw std::runtime_error{utils::string::va("Binary was mapped at 0x%llX (instead of 0x%llX). Something is severely broken :(", base, 0x140000000)};
 	}
 
+	start = std::chrono::high_resolution_clock::now();
 	this->load_imports(target, target);
+	this->timings_.imports = std::chrono::high_resolution_clock::now() - start;
+
+	start = std::chrono::high_resolution_clock::now();
 	this->load_tls(target, target);
+	this->timings_.tls = std::chrono::high_resolution_clock::now() - start;
 
 	return FARPROC(target.get_ptr() + target.get_relative_entry_point());
 }
@@ -58,6 +75,11 @@ void loader::set_import_resolver(const std::function<void*(const std::string&, c
 	this->import_resolver_ = resolver;
 }
 
+const loader::load_timings& loader::get_timings() const
+{
+	return this->timings_;
+}
+
 void loader::load_section(const utils::nt::library& target, const utils::nt::library& source,
                           IMAGE_SECTION_HEADER* section)
 {
@@ -92,60 +114,81 @@ void loader::load_imports(const utils::nt::library& target, const utils::nt::lib
 
 	auto* descriptor = PIMAGE_IMPORT_DESCRIPTOR(target.get_ptr() + import_directory->VirtualAddress);
 
+	// The address tables of all descriptors usually share a few pages,
+	// the transaction unprotects each of them once when everything is resolved
+	utils::hook::transaction address_tables{};
+
 	while (descriptor->Name)
 	{
-		std::string name = LPSTR(target.get_ptr() + descriptor->Name);
+		const std::string name = LPSTR(target.get_ptr() + descriptor->Name);
 
 		auto* name_table_entry = reinterpret_cast<uintptr_t*>(target.get_ptr() + descriptor->OriginalFirstThunk);
-		auto* address_table_entry = reinterpret_cast<uintptr_t*>(target.get_ptr() + descriptor->FirstThunk);
+		auto* const address_table = reinterpret_cast<uintptr_t*>(target.get_ptr() + descriptor->FirstThunk);
 
 		if (!descriptor->OriginalFirstThunk)
 		{
-			name_table_entry = reinterpret_cast<uintptr_t*>(target.get_ptr() + descriptor->FirstThunk);
+			name_table_entry = address_table;
 		}
 
-		while (*name_table_entry)
+		size_t entry_count = 0;
+		while (name_table_entry[entry_count])
+		{
+			++entry_count;
+		}
+
+		// The library is only loaded once, and only if something isn't overridden
+		std::vector<uintptr_t> functions(entry_count);
+		std::optional<utils::nt::library> library{};
+		std::string function_name{};
+
+		for (size_t i = 0; i < entry_count; ++i)
 		{
 			FARPROC function = nullptr;
-			std::string function_name;
 			const char* function_procname;
 
-			if (IMAGE_SNAP_BY_ORDINAL(*name_table_entry))
+			if (IMAGE_SNAP_BY_ORDINAL(name_table_entry[i]))
 			{
-				function_name = "#" + std::to_string(IMAGE_ORDINAL(*name_table_entry));
-				function_procname = MAKEINTRESOURCEA(IMAGE_ORDINAL(*name_table_entry));
+				function_name = "#" + std::to_string(IMAGE_ORDINAL(name_table_entry[i]));
+				function_procname = MAKEINTRESOURCEA(IMAGE_ORDINAL(name_table_entry[i]));
 			}
 			else
 			{
-				auto* import = PIMAGE_IMPORT_BY_NAME(target.get_ptr() + *name_table_entry);
+				auto* import = PIMAGE_IMPORT_BY_NAME(target.get_ptr() + name_table_entry[i]);
 				function_name = import->Name;
-				function_procname = function_name.data();
+				function_procname = import->Name;
 			}
 
 			if (this->import_resolver_) function = FARPROC(this->import_resolver_(name, function_name));
 			if (!function)
 			{
-				auto library = utils::nt::library::load(name);
-				if (library)
+				if (!library)
 				{
-					function = GetProcAddress(library, function_procname);
+					library.emplace(utils::nt::library::load(name));
+				}
+
+				if (*library)
+				{
+					function = GetProcAddress(*library, function_procname);
 				}
 			}
 
 			if (!function)
 			{
+				// Nothing is written when the load fails
+				address_tables.rollback();
 				throw std::runtime_error(utils::string::va("Unable to load import '%s' from library '%s'",
 				                                           function_name.data(), name.data()));
 			}
 
-			utils::hook::set(address_table_entry, reinterpret_cast<uintptr_t>(function));
-
-			name_table_entry++;
-			address_table_entry++;
+			functions[i] = reinterpret_cast<uintptr_t>(function);
 		}
 
+		address_tables.write(address_table, functions.data(), entry_count * sizeof(uintptr_t));
+
 		descriptor++;
 	}
+
+	address_tables.commit();
 }
 
 void loader::load_exception_table(const utils::nt::library& target, const utils::nt::library& source) const
@@ -4,13 +4,23 @@
 class loader final
 {
 public:
+	struct load_timings
+	{
+		std::chrono::high_resolution_clock::duration mapping{};
+		std::chrono::high_resolution_clock::duration imports{};
+		std::chrono::high_resolution_clock::duration tls{};
+	};
+
 	FARPROC load(const utils::nt::library& library, const std::string& buffer) const;
 	FARPROC load_library(const std::string& filename) const;
 
 	void set_import_resolver(const std::function<void*(const std::string&, const std::string&)>& resolver);
 
+	const load_timings& get_timings() const;
+
 private:
 	std::function<void*(const std::string&, const std::string&)> import_resolver_;
+	mutable load_timings timings_{};
 
 	static void load_section(const utils::nt::library& target, const utils::nt::library& source,
 	                         IMAGE_SECTION_HEADER* section);
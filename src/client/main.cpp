@@ -4,6 +4,8 @@
 #include "loader/component_loader.hpp"
 #include "game/game.hpp"
 
+#include "component/console.hpp"
+
 #include <utils/string.hpp>
 #include <utils/flags.hpp>
 #include <utils/io.hpp>
@@ -127,29 +129,21 @@ launcher::mode detect_mode_from_arguments()
 }
 
 
-FARPROC load_binary(const launcher::mode mode)
+FARPROC load_binary(const launcher::mode mode, loader::load_timings& timings)
 {
 	loader loader;
 	utils::nt::library self;
 
+	component_loader::register_import({}, "ExitProcess", exit_hook);
+	component_loader::register_import({}, "SystemParametersInfoA", system_parameters_info_a);
+	component_loader::register_import({}, "GetProcAddress", get_proc_address);
+
 	loader.set_import_resolver([self](const std::string& library, const std::string& function) -> void*
 	{
 		if (library == "steam_api64.dll")
 		{
 			return self.get_proc<FARPROC>(function);
 		}
-		else if (function == "ExitProcess")
-		{
-			return exit_hook;
-		}
-		else if (function == "SystemParametersInfoA")
-		{
-			return system_parameters_info_a;
-		}
-		else if (function == "GetProcAddress")
-		{
-			return get_proc_address;
-		}
 
 		return component_loader::load_import(library, function);
 	});
@@ -171,8 +165,13 @@ FARPROC load_binary(const launcher::mode mode)
 		throw std::runtime_error("Invalid game mode!");
 	}
 
+#ifdef INJECT_HOST_AS_LIB
+	// The binary is mapped by the system loader, there is no need to read it into memory
+	if (!utils::io::file_exists(binary))
+#else
 	std::string data;
 	if (!utils::io::read_file(binary, &data))
+#endif
 	{
 		throw std::runtime_error(utils::string::va(
 			"Failed to read game binary (%s)!\nPlease select the correct path in the launcher settings.",
@@ -180,10 +179,13 @@ FARPROC load_binary(const launcher::mode mode)
 	}
 
 #ifdef INJECT_HOST_AS_LIB
-	return loader.load_library(binary);
+	const auto entry_point = loader.load_library(binary);
 #else
-	return loader.load(self, data);
+	const auto entry_point = loader.load(self, data);
 #endif
+
+	timings = loader.get_timings();
+	return entry_point;
 }
 
 void remove_crash_file()
@@ -275,7 +277,9 @@ int main()
 			apply_environment();
 			remove_crash_file();
 
+			auto start = std::chrono::high_resolution_clock::now();
 			if (!component_loader::post_start()) return 0;
+			const auto post_start_time = std::chrono::high_resolution_clock::now() - start;
 
 			auto mode = detect_mode_from_arguments();
 			if (mode == launcher::mode::none)
@@ -287,13 +291,22 @@ int main()
 
 			game::environment::set_mode(mode);
 
-			entry_point = load_binary(mode);
+			loader::load_timings timings{};
+			entry_point = load_binary(mode, timings);
 			if (!entry_point)
 			{
 				throw std::runtime_error("Unable to load binary into memory");
 			}
 
+			start = std::chrono::high_resolution_clock::now();
 			if (!component_loader::post_load()) return 0;
+			const auto post_load_time = std::chrono::high_resolution_clock::now() - start;
+
+			using milliseconds = std::chrono::duration<double, std::milli>;
+			console::info("Startup: mapping %.2fms, imports %.2fms, tls %.2fms, post_start %.2fms, post_load %.2fms\n",
+			              milliseconds(timings.mapping).count(), milliseconds(timings.imports).count(),
+			              milliseconds(timings.tls).count(), milliseconds(post_start_time).count(),
+			              milliseconds(post_load_time).count());
 
 			premature_shutdown = false;
 		}
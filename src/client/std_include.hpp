@@ -46,12 +46,17 @@
 #include <cassert>
 #include <cstring>
 
+#include <array>
 #include <atomic>
+#include <bit>
+#include <charconv>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
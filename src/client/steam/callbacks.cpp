@@ -0,0 +1,260 @@
+#include <std_include.hpp>
+#include "callbacks.hpp"
+
+namespace steam
+{
+	std::atomic<uint64_t> callbacks::call_id_ = 0;
+	std::atomic<bool> callbacks::running_ = false;
+	bool callbacks::dispatching_ = false;
+	bool callbacks::removals_pending_ = false;
+	std::recursive_mutex callbacks::mutex_;
+	std::unordered_map<uint64_t, callbacks::base*> callbacks::result_handlers_;
+	std::unordered_map<int, std::vector<callbacks::base*>> callbacks::callback_list_;
+	utils::concurrency::ring_queue<callbacks::result, 0x4000> callbacks::results_;
+	std::mutex callbacks::overflow_mutex_;
+	std::vector<callbacks::result> callbacks::overflow_results_;
+	std::mutex callbacks::pool_mutex_;
+	std::array<std::vector<void*>, callbacks::pool_size_classes> callbacks::pool_;
+
+	namespace
+	{
+		size_t get_class_capacity(const size_t size_class)
+		{
+			return static_cast<size_t>(64) << size_class;
+		}
+	}
+
+	uint64_t callbacks::register_call()
+	{
+		return ++call_id_;
+	}
+
+	void callbacks::register_callback(base* handler, const int callback)
+	{
+		std::lock_guard<std::recursive_mutex> _(mutex_);
+		handler->set_i_callback(callback);
+		callback_list_[callback].push_back(handler);
+	}
+
+	void callbacks::unregister_callback(base* handler)
+	{
+		std::lock_guard<std::recursive_mutex> _(mutex_);
+		const auto i = callback_list_.find(handler->get_i_callback());
+		if (i == callback_list_.end())
+		{
+			return;
+		}
+
+		auto& handlers = i->second;
+
+		// Erasing would shift the handlers that are still to be dispatched, so they are only cleared for now
+		if (dispatching_)
+		{
+			std::replace(handlers.begin(), handlers.end(), handler, static_cast<base*>(nullptr));
+			removals_pending_ = true;
+			return;
+		}
+
+		handlers.erase(std::remove(handlers.begin(), handlers.end(), handler), handlers.end());
+	}
+
+	void callbacks::register_call_result(const uint64_t call, base* result)
+	{
+		std::lock_guard<std::recursive_mutex> _(mutex_);
+		result_handlers_[call] = result;
+	}
+
+	void callbacks::unregister_call_result(const uint64_t call, base* /*result*/)
+	{
+		std::lock_guard<std::recursive_mutex> _(mutex_);
+		result_handlers_.erase(call);
+	}
+
+	void* callbacks::allocate_result(const size_t size)
+	{
+		const auto total_size = size + pool_header_size;
+
+		size_t size_class = 0;
+		while (size_class < pool_size_classes && get_class_capacity(size_class) < total_size)
+		{
+			++size_class;
+		}
+
+		void* buffer = nullptr;
+		auto capacity = total_size;
+
+		if (size_class < pool_size_classes)
+		{
+			capacity = get_class_capacity(size_class);
+
+			std::lock_guard<std::mutex> _(pool_mutex_);
+			auto& free_buffers = pool_[size_class];
+			if (!free_buffers.empty())
+			{
+				buffer = free_buffers.back();
+				free_buffers.pop_back();
+			}
+		}
+
+		if (!buffer)
+		{
+			buffer = malloc(capacity);
+			if (!buffer)
+			{
+				throw std::bad_alloc();
+			}
+		}
+
+		std::memset(buffer, 0, capacity);
+		*static_cast<size_t*>(buffer) = size_class;
+
+		return static_cast<uint8_t*>(buffer) + pool_header_size;
+	}
+
+	void callbacks::free_result(void* data)
+	{
+		if (!data)
+		{
+			return;
+		}
+
+		release_results(&data, 1);
+	}
+
+	void callbacks::release_results(void* const* data, const size_t count)
+	{
+		std::lock_guard<std::mutex> _(pool_mutex_);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto* const buffer = static_cast<uint8_t*>(data[i]) - pool_header_size;
+			const auto size_class = *reinterpret_cast<size_t*>(buffer);
+
+			if (size_class < pool_size_classes && pool_[size_class].size() < pool_max_free)
+			{
+				pool_[size_class].push_back(buffer);
+			}
+			else
+			{
+				free(buffer);
+			}
+		}
+	}
+
+	void callbacks::return_call(void* data, const int size, const int type, const uint64_t call)
+	{
+		result result{};
+		result.call = call;
+		result.data = data;
+		result.size = size;
+		result.type = type;
+
+		if (!results_.try_push(result))
+		{
+			std::lock_guard<std::mutex> _(overflow_mutex_);
+			overflow_results_.emplace_back(result);
+		}
+	}
+
+	void callbacks::dispatch_result(const result& result)
+	{
+		const auto handler = result_handlers_.find(result.call);
+		if (handler != result_handlers_.end())
+		{
+			handler->second->run(result.data, false, result.call);
+		}
+
+		const auto entry = callback_list_.find(result.type);
+		if (entry == callback_list_.end())
+		{
+			return;
+		}
+
+		// Handlers may register or unregister others while running, removed ones are cleared
+		// until the dispatch is over and ones added are only called for the next result
+		const auto& handlers = entry->second;
+		const auto count = handlers.size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (handlers[i])
+			{
+				handlers[i]->run(result.data, false, 0);
+			}
+		}
+	}
+
+	void callbacks::remove_cleared_handlers()
+	{
+		if (!removals_pending_)
+		{
+			return;
+		}
+
+		removals_pending_ = false;
+
+		for (auto& [_, handlers] : callback_list_)
+		{
+			handlers.erase(std::remove(handlers.begin(), handlers.end(), nullptr), handlers.end());
+		}
+	}
+
+	void callbacks::run_callbacks()
+	{
+		if (running_.exchange(true))
+		{
+			return;
+		}
+
+		const auto _ = gsl::finally([]
+		{
+			running_ = false;
+		});
+
+		static thread_local std::vector<void*> released{};
+		static thread_local std::vector<result> overflow{};
+
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+			dispatching_ = true;
+			const auto dispatch_end = gsl::finally([]
+			{
+				dispatching_ = false;
+				remove_cleared_handlers();
+			});
+
+			results_.consume([](const result& result)
+			{
+				dispatch_result(result);
+
+				if (result.data)
+				{
+					released.push_back(result.data);
+				}
+			});
+
+			{
+				std::lock_guard<std::mutex> overflow_lock(overflow_mutex_);
+				overflow.swap(overflow_results_);
+			}
+
+			for (const auto& result : overflow)
+			{
+				dispatch_result(result);
+
+				if (result.data)
+				{
+					released.push_back(result.data);
+				}
+			}
+
+			overflow.clear();
+		}
+
+		if (!released.empty())
+		{
+			release_results(released.data(), released.size());
+			released.clear();
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <utils/concurrency.hpp>
+
+namespace steam
+{
+	class callbacks
+	{
+	public:
+		class base
+		{
+		public:
+			base() : flags_(0), callback_(0)
+			{
+			}
+
+			virtual void run(void* pv_param) = 0;
+			virtual void run(void* pv_param, bool failure, uint64_t handle) = 0;
+			virtual int get_callback_size_bytes() = 0;
+
+			int get_i_callback() const { return callback_; }
+			void set_i_callback(const int i_callback) { callback_ = i_callback; }
+
+		protected:
+			~base() = default;
+
+			unsigned char flags_;
+			int callback_;
+		};
+
+		struct result final
+		{
+			void* data{};
+			int size{};
+			int type{};
+			uint64_t call{};
+		};
+
+		static uint64_t register_call();
+
+		static void register_callback(base* handler, int callback);
+		static void unregister_callback(base* handler);
+
+		static void register_call_result(uint64_t call, base* result);
+		static void unregister_call_result(uint64_t call, base* result);
+
+		// Returns zeroed storage for a call result, which is released after the result was dispatched
+		static void* allocate_result(size_t size);
+		static void free_result(void* data);
+
+		static void return_call(void* data, int size, int type, uint64_t call);
+		static void run_callbacks();
+
+	private:
+		static constexpr size_t pool_size_classes = 8;
+		static constexpr size_t pool_header_size = 16;
+		static constexpr size_t pool_max_free = 256;
+
+		static std::atomic<uint64_t> call_id_;
+		static std::atomic<bool> running_;
+		// Only accessed while holding mutex_
+		static bool dispatching_;
+		static bool removals_pending_;
+		static std::recursive_mutex mutex_;
+		static std::unordered_map<uint64_t, base*> result_handlers_;
+		static std::unordered_map<int, std::vector<base*>> callback_list_;
+
+		static utils::concurrency::ring_queue<result, 0x4000> results_;
+		static std::mutex overflow_mutex_;
+		static std::vector<result> overflow_results_;
+
+		static std::mutex pool_mutex_;
+		static std::array<std::vector<void*>, pool_size_classes> pool_;
+
+		static void release_results(void* const* data, size_t count);
+		static void dispatch_result(const result& result);
+		static void remove_cleared_handlers();
+	};
+}
@@ -78,7 +78,7 @@ namespace steam
 	unsigned long long matchmaking::CreateLobby(int eLobbyType, int cMaxMembers)
 	{
 		const auto result = callbacks::register_call();
-		auto retvals = static_cast<lobby_created*>(calloc(1, sizeof(lobby_created)));
+		auto retvals = static_cast<lobby_created*>(callbacks::allocate_result(sizeof(lobby_created)));
 		//::Utils::Memory::AllocateArray<LobbyCreated>();
 		steam_id id;
 
@@ -100,7 +100,7 @@ namespace steam
 	unsigned long long matchmaking::JoinLobby(steam_id steamIDLobby)
 	{
 		const auto result = callbacks::register_call();
-		auto* retvals = static_cast<lobby_enter*>(calloc(1, sizeof(lobby_enter)));
+		auto* retvals = static_cast<lobby_enter*>(callbacks::allocate_result(sizeof(lobby_enter)));
 		//::Utils::Memory::AllocateArray<LobbyEnter>();
 		retvals->m_b_locked = false;
 		retvals->m_e_chat_room_enter_response = 1;
@@ -91,14 +91,16 @@ namespace steam
 		*pcbTicket = 1;
 
 		const auto result = callbacks::register_call();
-		auto* response = static_cast<get_auth_session_ticket_response*>(calloc(
-			1, sizeof(get_auth_session_ticket_response)));
-		response->m_h_auth_ticket = ++ticket;
+		auto* response = static_cast<get_auth_session_ticket_response*>(callbacks::allocate_result(
+			sizeof(get_auth_session_ticket_response)));
+		const auto ticket_handle = ++ticket;
+		response->m_h_auth_ticket = ticket_handle;
 		response->m_e_result = 1; // k_EResultOK;
 
+		// The response is owned by the callback queue once returned
 		callbacks::return_call(response, sizeof(get_auth_session_ticket_response),
 		                       get_auth_session_ticket_response::callback_id, result);
-		return response->m_h_auth_ticket;
+		return ticket_handle;
 	}
 
 	int user::BeginAuthSession(const void* pAuthTicket, int cbAuthTicket, steam_id steamID)
@@ -140,7 +142,7 @@ namespace steam
 
 		// Create the call response
 		const auto result = callbacks::register_call();
-		const auto retvals = static_cast<encrypted_app_ticket_response*>(calloc(1, sizeof(encrypted_app_ticket_response)));
+		const auto retvals = static_cast<encrypted_app_ticket_response*>(callbacks::allocate_result(sizeof(encrypted_app_ticket_response)));
 		//::Utils::Memory::AllocateArray<EncryptedAppTicketResponse>();
 		retvals->m_e_result = 1;
 
@@ -1,13 +1,17 @@
 #include "memory.hpp"
 #include "compression.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
 #include <zlib.h>
 #include <zip.h>
 
 #include <gsl/gsl>
 
-#include "io.hpp"
-
 namespace utils::compression
 {
 	namespace zlib
@@ -54,46 +58,97 @@ namespace utils::compression
 
 		std::string decompress(const std::string& data)
 		{
-			std::string buffer{};
+			// The output is rarely smaller than the input, so this never allocates more than needed up front
+			// and the buffer grows geometrically from there
+			return decompress(data, data.size());
+		}
+
+		std::string decompress(const std::string& data, const size_t size_hint)
+		{
 			zlib_stream stream_container{};
 			if (!stream_container.is_valid())
 			{
 				return {};
 			}
 
-			int ret{};
-			size_t offset = 0;
-			static thread_local uint8_t dest[CHUNK] = {0};
 			auto& stream = stream_container.get();
 
-			do
+			std::string buffer{};
+			buffer.resize(std::max(size_hint, static_cast<size_t>(64)));
+
+			static thread_local uint8_t spill[CHUNK] = {0};
+
+			size_t offset = 0;
+			size_t produced = 0;
+
+			while (true)
 			{
-				const auto input_size = std::min(sizeof(dest), data.size() - offset);
-				stream.avail_in = static_cast<uInt>(input_size);
-				stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
-				offset += stream.avail_in;
+				if (stream.avail_in == 0 && offset < data.size())
+				{
+					const auto input_size = std::min(data.size() - offset, static_cast<size_t>(UINT32_MAX));
+					stream.avail_in = static_cast<uInt>(input_size);
+					stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
+					offset += input_size;
+				}
 
-				do
+				// Once the buffer is full, inflate into a small chunk first,
+				// with an exact hint all that is left is the end of the stream
+				const auto room = buffer.size() - produced;
+				if (room)
 				{
-					stream.avail_out = sizeof(dest);
-					stream.next_out = dest;
+					stream.next_out = reinterpret_cast<Bytef*>(buffer.data()) + produced;
+					stream.avail_out = static_cast<uInt>(std::min(room, static_cast<size_t>(UINT32_MAX)));
+				}
+				else
+				{
+					stream.next_out = spill;
+					stream.avail_out = sizeof(spill);
+				}
 
-					ret = inflate(&stream, Z_NO_FLUSH);
-					if (ret != Z_OK && ret != Z_STREAM_END)
-					{
-						return {};
-					}
+				const auto available = stream.avail_out;
+				const auto ret = inflate(&stream, Z_NO_FLUSH);
+				const size_t written = available - stream.avail_out;
 
-					buffer.insert(buffer.end(), dest, dest + sizeof(dest) - stream.avail_out);
+				if (room)
+				{
+					produced += written;
+				}
+				else if (written)
+				{
+					buffer.resize(std::max(buffer.size() * 2, produced + written));
+					std::memcpy(buffer.data() + produced, spill, written);
+					produced += written;
+				}
+
+				if (ret == Z_STREAM_END)
+				{
+					break;
+				}
+
+				// No progress without more input means the data was truncated
+				if (ret == Z_BUF_ERROR && stream.avail_in == 0 && offset >= data.size())
+				{
+					return {};
+				}
+
+				if (ret != Z_OK && ret != Z_BUF_ERROR)
+				{
+					return {};
 				}
-				while (stream.avail_out == 0);
 			}
-			while (ret != Z_STREAM_END);
+
+			buffer.resize(produced);
+
+			// Growing or a large hint can leave up to twice the output allocated
+			if (buffer.capacity() - produced > std::max(static_cast<size_t>(CHUNK), produced / 4))
+			{
+				buffer.shrink_to_fit();
+			}
 
 			return buffer;
 		}
 
-		std::string compress(const std::string& data)
+		std::string compress(const std::string& data, const int level)
 		{
 			std::string result{};
 			auto length = compressBound(static_cast<uLong>(data.size()));
@@ -101,7 +156,7 @@ namespace utils::compression
 
 			if (compress2(reinterpret_cast<Bytef*>(result.data()), &length,
 			              reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()),
-			              Z_BEST_COMPRESSION) != Z_OK)
+			              level) != Z_OK)
 			{
 				return {};
 			}
@@ -109,28 +164,620 @@ namespace utils::compression
 			result.resize(length);
 			return result;
 		}
+
+		deflate_stream::deflate_stream(writer output, const int level)
+			: stream_(std::make_unique<z_stream>()), buffer_(CHUNK), output_(std::move(output))
+		{
+			this->valid_ = deflateInit(this->stream_.get(), level) == Z_OK;
+		}
+
+		deflate_stream::~deflate_stream()
+		{
+			if (this->valid_)
+			{
+				deflateEnd(this->stream_.get());
+			}
+		}
+
+		bool deflate_stream::is_valid() const
+		{
+			return this->valid_;
+		}
+
+		bool deflate_stream::write(const void* data, const size_t size)
+		{
+			return this->process(static_cast<const uint8_t*>(data), size, Z_NO_FLUSH);
+		}
+
+		bool deflate_stream::finish()
+		{
+			return this->process(nullptr, 0, Z_FINISH);
+		}
+
+		bool deflate_stream::pump(const reader& input)
+		{
+			std::vector<uint8_t> chunk(CHUNK);
+
+			while (true)
+			{
+				const auto size = input(chunk.data(), chunk.size());
+				if (!size)
+				{
+					return this->finish();
+				}
+
+				if (!this->write(chunk.data(), size))
+				{
+					return false;
+				}
+			}
+		}
+
+		bool deflate_stream::process(const uint8_t* data, size_t size, const int flush)
+		{
+			if (!this->valid_)
+			{
+				return false;
+			}
+
+			auto& stream = *this->stream_;
+
+			do
+			{
+				const auto input_size = std::min(size, static_cast<size_t>(UINT32_MAX));
+				stream.next_in = const_cast<Bytef*>(data);
+				stream.avail_in = static_cast<uInt>(input_size);
+				data += input_size;
+				size -= input_size;
+
+				const auto current_flush = size ? Z_NO_FLUSH : flush;
+
+				int ret{};
+				do
+				{
+					stream.next_out = this->buffer_.data();
+					stream.avail_out = static_cast<uInt>(this->buffer_.size());
+
+					ret = deflate(&stream, current_flush);
+					if (ret == Z_STREAM_ERROR)
+					{
+						return false;
+					}
+
+					const auto produced = this->buffer_.size() - stream.avail_out;
+					if (produced && !this->output_(this->buffer_.data(), produced))
+					{
+						return false;
+					}
+				}
+				while (stream.avail_out == 0 || (current_flush == Z_FINISH && ret != Z_STREAM_END));
+			}
+			while (size);
+
+			return true;
+		}
+
+		inflate_stream::inflate_stream(writer output)
+			: stream_(std::make_unique<z_stream>()), buffer_(CHUNK), output_(std::move(output))
+		{
+			this->valid_ = inflateInit(this->stream_.get()) == Z_OK;
+		}
+
+		inflate_stream::~inflate_stream()
+		{
+			if (this->valid_)
+			{
+				inflateEnd(this->stream_.get());
+			}
+		}
+
+		bool inflate_stream::is_valid() const
+		{
+			return this->valid_;
+		}
+
+		bool inflate_stream::is_finished() const
+		{
+			return this->finished_;
+		}
+
+		bool inflate_stream::write(const void* data, size_t size)
+		{
+			if (!this->valid_)
+			{
+				return false;
+			}
+
+			auto& stream = *this->stream_;
+			const auto* input = static_cast<const uint8_t*>(data);
+
+			while (size && !this->finished_)
+			{
+				const auto input_size = std::min(size, static_cast<size_t>(UINT32_MAX));
+				stream.next_in = input;
+				stream.avail_in = static_cast<uInt>(input_size);
+
+				do
+				{
+					stream.next_out = this->buffer_.data();
+					stream.avail_out = static_cast<uInt>(this->buffer_.size());
+
+					const auto ret = inflate(&stream, Z_NO_FLUSH);
+					if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+					{
+						return false;
+					}
+
+					const auto produced = this->buffer_.size() - stream.avail_out;
+					if (produced && !this->output_(this->buffer_.data(), produced))
+					{
+						return false;
+					}
+
+					if (ret == Z_STREAM_END)
+					{
+						this->finished_ = true;
+						break;
+					}
+				}
+				while (stream.avail_out == 0);
+
+				const auto consumed = input_size - stream.avail_in;
+				input += consumed;
+				size -= consumed;
+
+				if (!consumed && !this->finished_)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool inflate_stream::pump(const reader& input)
+		{
+			std::vector<uint8_t> chunk(CHUNK);
+
+			while (!this->finished_)
+			{
+				const auto size = input(chunk.data(), chunk.size());
+				if (!size || !this->write(chunk.data(), size))
+				{
+					break;
+				}
+			}
+
+			return this->finished_;
+		}
 	}
 
 	namespace zip
 	{
 		namespace
 		{
-			bool add_file(zipFile& zip_file, const std::string& filename, const std::string& data)
+			// Compressed output is handed to the archive in blocks of this size
+			constexpr size_t block_size = CHUNK * 16;
+
+			// An entry's worker waits once this much of its output hasn't been written yet
+			constexpr size_t max_buffered_bytes = block_size * 16;
+
+			// Sizes that might not fit the 32 bit fields once compressed
+			constexpr uint64_t zip_64_threshold = 0xFFFF0000;
+		}
+
+		struct archive_writer::entry
+		{
+			std::string name;
+
+			// Exactly one of these provides the input
+			std::string data;
+			std::string path;
+			zlib::reader input;
+
+			// Exact length of the reader's input, if the caller knows it
+			std::optional<uint64_t> input_size;
+
+			// Compressed blocks waiting to be written, their total size is kept below max_buffered_bytes
+			std::deque<std::string> blocks;
+			size_t buffered{};
+
+			uint64_t size{};
+			uLong crc{};
+			bool zip_64{false};
+			bool opened{false};
+			bool failed{false};
+			bool done{false};
+			bool ok{false};
+		};
+
+		archive_writer::archive_writer(const std::string& filename, const int level, size_t threads)
+			: level_(level)
+		{
+			const auto directory = std::filesystem::path(filename).parent_path();
+			if (!directory.empty())
+			{
+				std::error_code error{};
+				std::filesystem::create_directories(directory, error);
+			}
+
+			this->zip_file_ = zipOpen64(filename.data(), 0);
+			if (!this->zip_file_)
+			{
+				this->finished_ = true;
+				return;
+			}
+
+			if (!threads)
+			{
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			}
+
+			this->max_pending_ = threads * 2;
+
+			for (size_t i = 0; i < threads; ++i)
 			{
-				const auto zip_64 = data.size() > 0xffffffff ? 1 : 0;
-				if (ZIP_OK != zipOpenNewFileInZip64(zip_file, filename.data(), nullptr, nullptr, 0, nullptr, 0, nullptr,
-				                                    Z_DEFLATED, Z_BEST_COMPRESSION, zip_64))
+				this->workers_.emplace_back([this]()
+				{
+					this->work();
+				});
+			}
+		}
+
+		archive_writer::~archive_writer()
+		{
+			try
+			{
+				this->finish();
+			}
+			catch (...)
+			{
+				// Only finish can report errors of the input callbacks
+			}
+		}
+
+		bool archive_writer::is_open() const
+		{
+			return this->zip_file_ != nullptr;
+		}
+
+		void archive_writer::add(std::string filename, std::string data)
+		{
+			auto entry = std::make_shared<archive_writer::entry>();
+			entry->name = std::move(filename);
+			entry->data = std::move(data);
+			this->enqueue(std::move(entry));
+		}
+
+		void archive_writer::add(std::string filename, zlib::reader input)
+		{
+			auto entry = std::make_shared<archive_writer::entry>();
+			entry->name = std::move(filename);
+			entry->input = std::move(input);
+			this->enqueue(std::move(entry));
+		}
+
+		void archive_writer::add(std::string filename, zlib::reader input, const uint64_t size)
+		{
+			auto entry = std::make_shared<archive_writer::entry>();
+			entry->name = std::move(filename);
+			entry->input = std::move(input);
+			entry->input_size = size;
+			this->enqueue(std::move(entry));
+		}
+
+		void archive_writer::add_file(std::string filename, std::string path)
+		{
+			auto entry = std::make_shared<archive_writer::entry>();
+			entry->name = std::move(filename);
+			entry->path = std::move(path);
+			this->enqueue(std::move(entry));
+		}
+
+		bool archive_writer::finish(const std::string& comment)
+		{
+			std::unique_lock lock(this->mutex_);
+			if (this->finished_)
+			{
+				return !this->failed_ && this->zip_file_ != nullptr;
+			}
+
+			this->progress_.wait(lock, [this]()
+			{
+				return this->pending_.empty();
+			});
+
+			this->finished_ = true;
+			this->stopping_ = true;
+			lock.unlock();
+
+			this->job_available_.notify_all();
+			for (auto& worker : this->workers_)
+			{
+				worker.join();
+			}
+
+			zipClose(this->zip_file_, comment.empty() ? nullptr : comment.data());
+
+			// Input callbacks run on the workers, their first error is passed on to the caller
+			if (this->error_)
+			{
+				std::rethrow_exception(std::exchange(this->error_, nullptr));
+			}
+
+			return !this->failed_;
+		}
+
+		void archive_writer::enqueue(std::shared_ptr<entry> entry)
+		{
+			std::unique_lock lock(this->mutex_);
+			if (this->finished_)
+			{
+				this->failed_ = true;
+				return;
+			}
+
+			this->progress_.wait(lock, [this]()
+			{
+				return this->pending_.size() < this->max_pending_;
+			});
+
+			this->pending_.push_back(entry);
+			this->jobs_.push(std::move(entry));
+			lock.unlock();
+
+			this->job_available_.notify_one();
+		}
+
+		void archive_writer::work()
+		{
+			std::unique_lock lock(this->mutex_);
+
+			while (true)
+			{
+				this->job_available_.wait(lock, [this]()
+				{
+					return this->stopping_ || !this->jobs_.empty();
+				});
+
+				if (this->jobs_.empty())
+				{
+					return;
+				}
+
+				const auto entry = std::move(this->jobs_.front());
+				this->jobs_.pop();
+
+				lock.unlock();
+
+				try
+				{
+					this->compress(*entry);
+				}
+				catch (...)
+				{
+					entry->ok = false;
+
+					std::lock_guard _(this->mutex_);
+					if (!this->error_)
+					{
+						this->error_ = std::current_exception();
+					}
+				}
+
+				lock.lock();
+
+				entry->done = true;
+				this->write_completed(lock);
+			}
+		}
+
+		void archive_writer::compress(entry& entry)
+		{
+			z_stream stream{};
+			if (deflateInit2(&stream, this->level_, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			{
+				return;
+			}
+
+			const auto _ = gsl::finally([&stream]()
+			{
+				deflateEnd(&stream);
+			});
+
+			std::ifstream file{};
+			if (!entry.path.empty())
+			{
+				file.open(entry.path, std::ios::binary | std::ios::ate);
+				if (!file.is_open())
+				{
+					return;
+				}
+
+				entry.zip_64 = static_cast<uint64_t>(file.tellg()) >= zip_64_threshold;
+				file.seekg(0);
+			}
+			else
+			{
+				// Without a size a reader's input could be arbitrarily long
+				const auto size = entry.input ? entry.input_size.value_or(zip_64_threshold) : entry.data.size();
+				entry.zip_64 = size >= zip_64_threshold;
+			}
+
+			size_t data_offset = 0;
+			const auto read = [&](uint8_t* buffer, const size_t size) -> size_t
+			{
+				if (entry.input)
+				{
+					return entry.input(buffer, size);
+				}
+
+				if (file.is_open())
+				{
+					file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+					return static_cast<size_t>(file.gcount());
+				}
+
+				const auto length = std::min(size, entry.data.size() - data_offset);
+				std::memcpy(buffer, entry.data.data() + data_offset, length);
+				data_offset += length;
+				return length;
+			};
+
+			std::vector<uint8_t> input(CHUNK * 4);
+			std::vector<uint8_t> output(CHUNK * 4);
+			std::string block{};
+
+			int ret{};
+			do
+			{
+				const auto length = read(input.data(), input.size());
+				entry.crc = crc32(entry.crc, input.data(), static_cast<uInt>(length));
+				entry.size += length;
+
+				stream.next_in = input.data();
+				stream.avail_in = static_cast<uInt>(length);
+
+				const auto flush = length ? Z_NO_FLUSH : Z_FINISH;
+
+				do
+				{
+					stream.next_out = output.data();
+					stream.avail_out = static_cast<uInt>(output.size());
+
+					ret = deflate(&stream, flush);
+					if (ret == Z_STREAM_ERROR)
+					{
+						return;
+					}
+
+					block.append(reinterpret_cast<const char*>(output.data()), output.size() - stream.avail_out);
+				}
+				while (stream.avail_out == 0);
+
+				if (block.size() >= block_size)
+				{
+					this->submit(entry, std::move(block));
+					block = {};
+				}
+			}
+			while (ret != Z_STREAM_END);
+
+			if (!block.empty())
+			{
+				this->submit(entry, std::move(block));
+			}
+
+			// Inputs are released as soon as they are compressed
+			entry.data = {};
+			entry.input = {};
+
+			// A reader or file that produced more than announced can't be stored without zip64
+			entry.ok = entry.zip_64 || entry.size < zip_64_threshold;
+		}
+
+		void archive_writer::submit(entry& entry, std::string block)
+		{
+			std::unique_lock lock(this->mutex_);
+
+			entry.buffered += block.size();
+			entry.blocks.emplace_back(std::move(block));
+
+			// Only the oldest entry is written, later ones wait for it instead of buffering everything
+			this->write_completed(lock);
+			this->progress_.wait(lock, [&entry]()
+			{
+				return entry.buffered < max_buffered_bytes;
+			});
+		}
+
+		bool archive_writer::write_blocks(entry& entry, const std::deque<std::string>& blocks, const bool last) const
+		{
+			if (!entry.opened)
+			{
+				// Nothing was produced for entries that failed before their first block
+				if (last && !entry.ok)
 				{
 					return false;
 				}
 
-				const auto _ = gsl::finally([&zip_file]()
+				if (ZIP_OK != zipOpenNewFileInZip2_64(this->zip_file_, entry.name.data(), nullptr, nullptr, 0, nullptr,
+				                                      0, nullptr, Z_DEFLATED, this->level_, 1, entry.zip_64 ? 1 : 0))
 				{
-					zipCloseFileInZip(zip_file);
-				});
+					return false;
+				}
+
+				entry.opened = true;
+			}
+
+			const auto close = [&]()
+			{
+				entry.opened = false;
+				return ZIP_OK == zipCloseFileInZipRaw64(this->zip_file_, entry.size, entry.crc);
+			};
+
+			for (const auto& block : blocks)
+			{
+				if (ZIP_OK != zipWriteInFileInZip(this->zip_file_, block.data(), static_cast<unsigned>(block.size())))
+				{
+					close();
+					return false;
+				}
+			}
+
+			if (!last)
+			{
+				return true;
+			}
+
+			return close() && entry.ok;
+		}
+
+		void archive_writer::write_completed(std::unique_lock<std::mutex>& lock)
+		{
+			// A single thread stitches entries into the archive, the others keep compressing
+			if (this->writing_)
+			{
+				return;
+			}
 
-				return ZIP_OK == zipWriteInFileInZip(zip_file, data.data(), static_cast<unsigned>(data.size()));
+			this->writing_ = true;
+
+			while (!this->pending_.empty())
+			{
+				const auto entry = this->pending_.front();
+				if (entry->blocks.empty() && !entry->done)
+				{
+					break;
+				}
+
+				const auto blocks = std::move(entry->blocks);
+				entry->blocks.clear();
+				entry->buffered = 0;
+
+				const auto last = entry->done;
+				const auto failed = entry->failed;
+
+				lock.unlock();
+				const auto result = !failed && this->write_blocks(*entry, blocks, last);
+				lock.lock();
+
+				// The rest of a broken entry is dropped
+				if (!result)
+				{
+					entry->failed = true;
+					this->failed_ = true;
+				}
+
+				if (last)
+				{
+					this->pending_.pop_front();
+				}
+
+				this->progress_.notify_all();
 			}
+
+			this->writing_ = false;
 		}
 
 		void archive::add(std::string filename, std::string data)
@@ -140,30 +787,25 @@ namespace utils::compression
 
 		bool archive::write(const std::string& filename, const std::string& comment)
 		{
-			// Hack to create the directory :3
-			io::write_file(filename, {});
-			io::remove_file(filename);
-
-			auto* zip_file = zipOpen64(filename.data(), 0);
-			if (!zip_file)
+			archive_writer writer(filename);
+			if (!writer.is_open())
 			{
 				return false;
 			}
 
-			const auto _ = gsl::finally([&zip_file, &comment]()
-			{
-				zipClose(zip_file, comment.empty() ? nullptr : comment.data());
-			});
-
 			for (const auto& file : this->files_)
 			{
-				if (!add_file(zip_file, file.first, file.second))
+				// The data outlives the writer, so it is read in place instead of being copied into the entry
+				writer.add(file.first, [&data = file.second, offset = size_t(0)](uint8_t* buffer, const size_t size) mutable
 				{
-					return false;
-				}
+					const auto length = std::min(size, data.size() - offset);
+					std::memcpy(buffer, data.data() + offset, length);
+					offset += length;
+					return length;
+				}, file.second.size());
 			}
 
-			return true;
+			return writer.finish(comment);
 		}
 	}
 }
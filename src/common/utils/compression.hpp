@@ -1,20 +1,151 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #define CHUNK 16384u
 
+struct z_stream_s;
+
 namespace utils::compression
 {
 	namespace zlib
 	{
-		std::string compress(const std::string& data);
+		// Levels follow zlib: 0 stores, 9 compresses best, -1 picks zlib's default
+		constexpr int best_compression = 9;
+
+		std::string compress(const std::string& data, int level = best_compression);
 		std::string decompress(const std::string& data);
+
+		// Inflates straight into a buffer of size_hint bytes, which only grows if the hint was too small
+		// Excess capacity is released afterwards, so an exact hint avoids every extra copy
+		std::string decompress(const std::string& data, size_t size_hint);
+
+		// Fills the buffer and returns how many bytes were written, 0 ends the input
+		using reader = std::function<size_t(uint8_t* buffer, size_t size)>;
+
+		// Receives every produced chunk, returning false aborts the stream
+		using writer = std::function<bool(const uint8_t* data, size_t size)>;
+
+		class deflate_stream final
+		{
+		public:
+			explicit deflate_stream(writer output, int level = best_compression);
+			~deflate_stream();
+
+			deflate_stream(const deflate_stream&) = delete;
+			deflate_stream& operator=(const deflate_stream&) = delete;
+
+			bool is_valid() const;
+
+			bool write(const void* data, size_t size);
+			bool finish();
+
+			// Reads until the input ends, then finishes the stream
+			bool pump(const reader& input);
+
+		private:
+			std::unique_ptr<z_stream_s> stream_;
+			std::vector<uint8_t> buffer_;
+			writer output_;
+			bool valid_{false};
+
+			bool process(const uint8_t* data, size_t size, int flush);
+		};
+
+		class inflate_stream final
+		{
+		public:
+			explicit inflate_stream(writer output);
+			~inflate_stream();
+
+			inflate_stream(const inflate_stream&) = delete;
+			inflate_stream& operator=(const inflate_stream&) = delete;
+
+			bool is_valid() const;
+			bool is_finished() const;
+
+			// Input past the end of the compressed stream is ignored
+			bool write(const void* data, size_t size);
+
+			// Reads until the input or the compressed stream ends, returns whether the stream was complete
+			bool pump(const reader& input);
+
+		private:
+			std::unique_ptr<z_stream_s> stream_;
+			std::vector<uint8_t> buffer_;
+			writer output_;
+			bool valid_{false};
+			bool finished_{false};
+		};
 	}
 
 	namespace zip
 	{
+		// Deflates entries on worker threads while they are being added and writes them
+		// to the archive in the order they were added. Adding blocks once a few entries
+		// per worker are in flight, and a worker pauses once a few MB of its entry's output
+		// wait to be written, so memory stays bounded regardless of the archive and entry sizes.
+		// Exceptions thrown by a reader are rethrown from finish.
+		class archive_writer final
+		{
+		public:
+			explicit archive_writer(const std::string& filename, int level = zlib::best_compression,
+			                        size_t threads = 0);
+			~archive_writer();
+
+			archive_writer(const archive_writer&) = delete;
+			archive_writer& operator=(const archive_writer&) = delete;
+
+			bool is_open() const;
+
+			void add(std::string filename, std::string data);
+			void add(std::string filename, zlib::reader input);
+
+			// The size must be the exact input length, it lets entries below 4 GB skip the zip64 extensions
+			void add(std::string filename, zlib::reader input, uint64_t size);
+			void add_file(std::string filename, std::string path);
+
+			// Waits for all entries, closes the archive and returns whether every entry was written
+			bool finish(const std::string& comment = {});
+
+		private:
+			struct entry;
+
+			void* zip_file_{};
+			int level_;
+			size_t max_pending_{};
+
+			std::mutex mutex_;
+			std::condition_variable job_available_;
+			std::condition_variable progress_;
+			std::deque<std::shared_ptr<entry>> pending_;
+			std::queue<std::shared_ptr<entry>> jobs_;
+			std::vector<std::thread> workers_;
+			bool writing_{false};
+			bool stopping_{false};
+			bool failed_{false};
+			bool finished_{false};
+			std::exception_ptr error_{};
+
+			void enqueue(std::shared_ptr<entry> entry);
+			void work();
+			void compress(entry& entry);
+			void submit(entry& entry, std::string block);
+			bool write_blocks(entry& entry, const std::deque<std::string>& blocks, bool last) const;
+			void write_completed(std::unique_lock<std::mutex>& lock);
+		};
+
 		class archive
 		{
 		public:
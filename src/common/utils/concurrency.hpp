@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <mutex>
+#include <string_view>
 
 namespace utils::concurrency
 {
@@ -43,4 +49,144 @@ namespace utils::concurrency
 		mutable MutexType mutex_{};
 		T object_{};
 	};
+
+	// Bounded lock-free queue for many producers and a single consumer.
+	// Producers can reserve several consecutive slots at once, so a record
+	// spanning multiple slots is never interleaved with other producers.
+	// When the queue is full, pushes fail and are counted as dropped.
+	template <typename T, size_t Capacity>
+	class ring_queue
+	{
+	public:
+		static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+		ring_queue()
+		{
+			for (size_t i = 0; i < Capacity; ++i)
+			{
+				slots_[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		ring_queue(const ring_queue&) = delete;
+		ring_queue& operator=(const ring_queue&) = delete;
+
+		template <typename F>
+		bool try_push_n(const size_t count, F&& writer)
+		{
+			if (count == 0 || count > Capacity)
+			{
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			auto position = enqueue_position_.load(std::memory_order_relaxed);
+			while (true)
+			{
+				// The consumer releases slots in order, so if the last slot is free all of them are
+				const auto last = position + count - 1;
+				const auto sequence = slots_[last & mask].sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(last);
+
+				if (difference == 0)
+				{
+					if (enqueue_position_.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+					{
+						break;
+					}
+				}
+				else if (difference < 0)
+				{
+					dropped_.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else
+				{
+					position = enqueue_position_.load(std::memory_order_relaxed);
+				}
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto& slot = slots_[(position + i) & mask];
+				writer(i, slot.value);
+				slot.sequence.store(position + i + 1, std::memory_order_release);
+			}
+
+			return true;
+		}
+
+		template <typename U>
+		bool try_push(U&& value)
+		{
+			return this->try_push_n(1, [&](size_t, T& slot)
+			{
+				slot = std::forward<U>(value);
+			});
+		}
+
+		// Must only be called from the consumer thread
+		template <typename F>
+		size_t consume(F&& reader, const size_t max_count = Capacity)
+		{
+			size_t count = 0;
+			while (count < max_count)
+			{
+				auto& slot = slots_[dequeue_position_ & mask];
+				if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+				{
+					break;
+				}
+
+				reader(slot.value);
+				slot.sequence.store(dequeue_position_ + Capacity, std::memory_order_release);
+
+				++dequeue_position_;
+				++count;
+			}
+
+			return count;
+		}
+
+		size_t take_dropped()
+		{
+			return dropped_.exchange(0, std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr size_t mask = Capacity - 1;
+
+		struct queue_slot
+		{
+			std::atomic<size_t> sequence{};
+			T value{};
+		};
+
+		std::array<queue_slot, Capacity> slots_{};
+
+		std::atomic<size_t> enqueue_position_{0};
+		size_t dequeue_position_{0};
+		std::atomic<size_t> dropped_{0};
+	};
+
+	// Pushes text into a queue of chunks with a length and a char data array, as one record
+	// so it is never interleaved with other producers. Empty text pushes nothing and succeeds.
+	template <typename Chunk, size_t Capacity>
+	bool push_chunked(ring_queue<Chunk, Capacity>& queue, const std::string_view data)
+	{
+		if (data.empty())
+		{
+			return true;
+		}
+
+		constexpr auto chunk_size = sizeof(Chunk::data);
+		const auto chunk_count = (data.size() + chunk_size - 1) / chunk_size;
+
+		return queue.try_push_n(chunk_count, [&](const size_t index, Chunk& chunk)
+		{
+			const auto offset = index * chunk_size;
+			chunk.length = static_cast<decltype(chunk.length)>(std::min(chunk_size, data.size() - offset));
+			std::memcpy(chunk.data, data.data() + offset, chunk.length);
+		});
+	}
 }
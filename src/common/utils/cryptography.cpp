@@ -1,5 +1,6 @@
 #include "string.hpp"
 #include "cryptography.hpp"
+#include "io.hpp"
 #include "nt.hpp"
 #include <gsl/gsl>
 
@@ -543,6 +544,31 @@ namespace utils::cryptography
 		return string::dump_hex(hash, "");
 	}
 
+	std::string sha256::compute_file(const std::string& file, const bool hex)
+	{
+		uint8_t buffer[32] = {0};
+
+		hash_state state;
+		sha256_init(&state);
+
+		const auto mapped = io::map_file(file, [&](const uint8_t* data, const size_t length)
+		{
+			sha256_process(&state, data, ul(length));
+		});
+
+		if (!mapped)
+		{
+			return {};
+		}
+
+		sha256_done(&state, buffer);
+
+		std::string hash(cs(buffer), sizeof(buffer));
+		if (!hex) return hash;
+
+		return string::dump_hex(hash, "");
+	}
+
 	std::string sha512::compute(const std::string& data, const bool hex)
 	{
 		return compute(cs(data.data()), data.size(), hex);
@@ -88,6 +88,7 @@ namespace utils::cryptography
 	{
 		std::string compute(const std::string& data, bool hex = false);
 		std::string compute(const uint8_t* data, size_t length, bool hex = false);
+		std::string compute_file(const std::string& file, bool hex = false);
 	}
 
 	namespace sha512
@@ -0,0 +1,204 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include "nt.hpp"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace utils
+{
+	namespace
+	{
+		class native_pacer_clock final : public pacer_clock
+		{
+		public:
+			native_pacer_clock()
+			{
+#ifdef _WIN32
+				// High resolution timers are only available since Windows 10 1803
+				this->timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+				this->high_resolution_ = this->timer_ != nullptr;
+
+				if (!this->timer_)
+				{
+					this->timer_ = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+				}
+#endif
+			}
+
+			~native_pacer_clock() override
+			{
+#ifdef _WIN32
+				if (this->timer_)
+				{
+					CloseHandle(this->timer_);
+				}
+#endif
+			}
+
+			native_pacer_clock(const native_pacer_clock&) = delete;
+			native_pacer_clock& operator=(const native_pacer_clock&) = delete;
+
+			std::chrono::nanoseconds now() override
+			{
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch());
+			}
+
+			void sleep_until(const std::chrono::nanoseconds deadline) override
+			{
+				const auto remaining = deadline - this->now();
+				if (remaining <= std::chrono::nanoseconds::zero())
+				{
+					return;
+				}
+
+#ifdef _WIN32
+				if (this->timer_)
+				{
+					// Negative due times are relative, in 100ns units
+					LARGE_INTEGER due_time{};
+					due_time.QuadPart = -static_cast<LONGLONG>(remaining.count() / 100);
+
+					if (SetWaitableTimer(this->timer_, &due_time, 0, nullptr, nullptr, FALSE))
+					{
+						WaitForSingleObject(this->timer_, INFINITE);
+						return;
+					}
+				}
+#endif
+
+				std::this_thread::sleep_for(remaining);
+			}
+
+			void relax() override
+			{
+				std::this_thread::yield();
+			}
+
+			std::chrono::nanoseconds get_spin_margin() override
+			{
+				using namespace std::chrono_literals;
+
+				// Regular timers are bound to the system timer resolution
+				return this->high_resolution_ ? 500us : 2ms;
+			}
+
+		private:
+#ifdef _WIN32
+			HANDLE timer_{};
+#endif
+			bool high_resolution_{};
+		};
+	}
+
+	pacer_clock& get_native_pacer_clock()
+	{
+		static native_pacer_clock clock;
+		return clock;
+	}
+
+	std::chrono::nanoseconds frame_pacer::statistics::get_average_lateness() const
+	{
+		const auto on_time = this->ticks - this->overruns;
+		if (!on_time)
+		{
+			return {};
+		}
+
+		return this->total_lateness / static_cast<int64_t>(on_time);
+	}
+
+	frame_pacer::frame_pacer(pacer_clock& clock)
+		: clock_(&clock)
+	{
+	}
+
+	void frame_pacer::wait(const uint32_t rate)
+	{
+		if (!rate)
+		{
+			this->rate_ = 0;
+			return;
+		}
+
+		auto now = this->clock_->now();
+		if (rate != this->rate_)
+		{
+			this->resync(rate, now);
+		}
+
+		++this->statistics_.ticks;
+
+		if (now >= this->next_deadline_)
+		{
+			const auto overrun = now - this->next_deadline_;
+			const auto skipped = overrun / this->interval_;
+
+			++this->statistics_.overruns;
+			this->statistics_.skipped_ticks += static_cast<uint64_t>(skipped);
+			this->statistics_.max_overrun = std::max(this->statistics_.max_overrun, overrun);
+
+			// Stay on the grid, but don't try to run the missed ticks back to back
+			this->next_deadline_ += this->interval_ * (skipped + 1);
+			return;
+		}
+
+		const auto deadline = this->next_deadline_;
+		const auto spin_time = this->get_spin_time();
+
+		if (now < deadline - spin_time)
+		{
+			this->clock_->sleep_until(deadline - spin_time);
+			now = this->clock_->now();
+		}
+
+		while (spin_time > std::chrono::nanoseconds::zero() && now < deadline)
+		{
+			this->clock_->relax();
+			now = this->clock_->now();
+		}
+
+		// Without spinning the sleep may return slightly early
+		const auto lateness = std::max(now - deadline, std::chrono::nanoseconds::zero());
+		this->statistics_.total_lateness += lateness;
+		this->statistics_.max_lateness = std::max(this->statistics_.max_lateness, lateness);
+
+		this->next_deadline_ += this->interval_;
+	}
+
+	void frame_pacer::reset_statistics()
+	{
+		this->statistics_ = {};
+	}
+
+	const frame_pacer::statistics& frame_pacer::get_statistics() const
+	{
+		return this->statistics_;
+	}
+
+	std::chrono::nanoseconds frame_pacer::get_spin_time() const
+	{
+		// When the timer can't resolve the interval, spinning would burn most of every tick
+		const auto margin = this->clock_->get_spin_margin();
+		if (this->interval_ <= margin)
+		{
+			return {};
+		}
+
+		return std::min(margin, this->interval_ / max_spin_fraction);
+	}
+
+	void frame_pacer::resync(const uint32_t rate, const std::chrono::nanoseconds now)
+	{
+		this->rate_ = rate;
+		this->interval_ = std::chrono::nanoseconds(std::chrono::seconds(1)) / rate;
+		this->next_deadline_ = now + this->interval_;
+	}
+}
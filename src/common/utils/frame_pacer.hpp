@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace utils
+{
+	// Time source used by the frame pacer
+	// The native clock sleeps on a high resolution waitable timer on Windows
+	class pacer_clock
+	{
+	public:
+		virtual ~pacer_clock() = default;
+
+		virtual std::chrono::nanoseconds now() = 0;
+
+		// Coarse sleep, may wake up early or late
+		virtual void sleep_until(std::chrono::nanoseconds deadline) = 0;
+
+		// Called repeatedly while busy waiting for the deadline
+		virtual void relax() = 0;
+
+		// How early the coarse sleep should return to leave room for spinning
+		virtual std::chrono::nanoseconds get_spin_margin() = 0;
+	};
+
+	pacer_clock& get_native_pacer_clock();
+
+	// Keeps frames on a fixed grid of tick deadlines.
+	// Every deadline is derived from the previous one, not from the end of the frame,
+	// so the rate doesn't drift with the time spent sleeping.
+	// A frame that ends past its deadline is counted as an overrun and the next
+	// deadline is moved onto the grid after the current time instead of trying to catch up.
+	// Busy waiting is limited to a small part of the interval, and skipped entirely
+	// when the interval isn't longer than the clock's spin margin.
+	class frame_pacer final
+	{
+	public:
+		struct statistics
+		{
+			uint64_t ticks{};
+			uint64_t overruns{};
+			uint64_t skipped_ticks{};
+			std::chrono::nanoseconds total_lateness{};
+			std::chrono::nanoseconds max_lateness{};
+			std::chrono::nanoseconds max_overrun{};
+
+			[[nodiscard]] std::chrono::nanoseconds get_average_lateness() const;
+		};
+
+		explicit frame_pacer(pacer_clock& clock = get_native_pacer_clock());
+
+		// Blocks until the next tick deadline for the given rate
+		// A rate of 0 disables pacing
+		void wait(uint32_t rate);
+
+		void reset_statistics();
+		[[nodiscard]] const statistics& get_statistics() const;
+
+	private:
+		// At most 1/max_spin_fraction of every interval is spent busy waiting
+		static constexpr int64_t max_spin_fraction = 10;
+
+		pacer_clock* clock_;
+		statistics statistics_{};
+
+		uint32_t rate_{};
+		std::chrono::nanoseconds interval_{};
+		std::chrono::nanoseconds next_deadline_{};
+
+		[[nodiscard]] std::chrono::nanoseconds get_spin_time() const;
+		void resync(uint32_t rate, std::chrono::nanoseconds now);
+	};
+}
@@ -171,13 +171,8 @@ namespace utils::hook
 
 	void nop(void* place, const size_t length)
 	{
-		DWORD old_protect{};
-		VirtualProtect(place, length, PAGE_EXECUTE_READWRITE, &old_protect);
-
-		std::memset(place, 0x90, length);
-
-		VirtualProtect(place, length, old_protect, &old_protect);
-		FlushInstructionCache(GetCurrentProcess(), place, length);
+		const std::vector<uint8_t> nops(length, 0x90);
+		write_memory(place, nops.data(), length);
 	}
 
 	void nop(const size_t place, const size_t length)
@@ -187,13 +182,7 @@ namespace utils::hook
 
 	void copy(void* place, const void* data, const size_t length)
 	{
-		DWORD old_protect{};
-		VirtualProtect(place, length, PAGE_EXECUTE_READWRITE, &old_protect);
-
-		std::memmove(place, data, length);
-
-		VirtualProtect(place, length, old_protect, &old_protect);
-		FlushInstructionCache(GetCurrentProcess(), place, length);
+		write_memory(place, data, length);
 	}
 
 	void copy(const size_t place, const void* data, const size_t length)
@@ -208,6 +197,18 @@ namespace utils::hook
 		return diff != int64_t(small_diff);
 	}
 
+	namespace
+	{
+		void write_branch(void* pointer, const uint8_t opcode, const void* data)
+		{
+			uint8_t instruction[5]{opcode};
+			const auto offset = int32_t(size_t(data) - (size_t(pointer) + 5));
+			std::memcpy(instruction + 1, &offset, sizeof(offset));
+
+			copy(pointer, instruction, sizeof(instruction));
+		}
+	}
+
 	void call(void* pointer, void* data)
 	{
 		if (is_relatively_far(pointer, data))
@@ -215,9 +216,7 @@ namespace utils::hook
 			throw std::runtime_error("Too far away to create 32bit relative branch");
 		}
 
-		auto* patch_pointer = PBYTE(pointer);
-		set<uint8_t>(patch_pointer, 0xE8);
-		set<int32_t>(patch_pointer + 1, int32_t(size_t(data) - (size_t(pointer) + 5)));
+		write_branch(pointer, 0xE8, data);
 	}
 
 	void call(const size_t pointer, void* data)
@@ -232,7 +231,7 @@ namespace utils::hook
 
 	void jump(void* pointer, void* data, const bool use_far)
 	{
-		static const unsigned char jump_data[] = {
+		unsigned char jump_data[] = {
 			0x48, 0xb8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0xff, 0xe0
 		};
 
@@ -241,17 +240,14 @@ namespace utils::hook
 			throw std::runtime_error("Too far away to create 32bit relative branch");
 		}
 
-		auto* patch_pointer = PBYTE(pointer);
-
 		if (use_far)
 		{
-			copy(patch_pointer, jump_data, sizeof(jump_data));
-			copy(patch_pointer + 2, &data, sizeof(data));
+			std::memcpy(jump_data + 2, &data, sizeof(data));
+			copy(pointer, jump_data, sizeof(jump_data));
 		}
 		else
 		{
-			set<uint8_t>(patch_pointer, 0xE9);
-			set<int32_t>(patch_pointer + 1, int32_t(size_t(data) - (size_t(pointer) + 5)));
+			write_branch(pointer, 0xE9, data);
 		}
 	}
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "signature.hpp"
+#include "transaction.hpp"
 
 #include <asmjit/core/jitruntime.h>
 #include <asmjit/x86/x86assembler.h>
@@ -176,13 +177,7 @@ namespace utils::hook
 	template <typename T>
 	static void set(void* place, T value)
 	{
-		DWORD old_protect;
-		VirtualProtect(place, sizeof(T), PAGE_EXECUTE_READWRITE, &old_protect);
-
-		*static_cast<T*>(place) = value;
-
-		VirtualProtect(place, sizeof(T), old_protect, &old_protect);
-		FlushInstructionCache(GetCurrentProcess(), place, sizeof(T));
+		write_memory(place, &value, sizeof(T));
 	}
 
 	template <typename T>
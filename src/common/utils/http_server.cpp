@@ -0,0 +1,414 @@
+#include "http_server.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace utils
+{
+	namespace
+	{
+		constexpr auto invalid_socket = ~std::uintptr_t{0};
+
+#ifdef _WIN32
+		using native_socket = SOCKET;
+		constexpr auto send_flags = 0;
+
+		int get_last_error()
+		{
+			return WSAGetLastError();
+		}
+
+		bool would_block()
+		{
+			return WSAGetLastError() == WSAEWOULDBLOCK;
+		}
+
+		void close_socket(const native_socket socket)
+		{
+			closesocket(socket);
+		}
+
+		bool set_non_blocking(const native_socket socket)
+		{
+			u_long non_blocking = 1;
+			return ioctlsocket(socket, FIONBIO, &non_blocking) == 0;
+		}
+#else
+		using native_socket = int;
+		// A scraper that hung up must not kill the process with SIGPIPE
+		constexpr auto send_flags = MSG_NOSIGNAL;
+
+		int get_last_error()
+		{
+			return errno;
+		}
+
+		bool would_block()
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+
+		void close_socket(const native_socket socket)
+		{
+			::close(socket);
+		}
+
+		bool set_non_blocking(const native_socket socket)
+		{
+			const auto flags = fcntl(socket, F_GETFL, 0);
+			return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+		}
+#endif
+
+		native_socket to_native(const std::uintptr_t socket)
+		{
+			return static_cast<native_socket>(socket);
+		}
+
+		std::uintptr_t from_native(const native_socket socket)
+		{
+			return static_cast<std::uintptr_t>(socket);
+		}
+
+		bool is_loopback(const sockaddr& address)
+		{
+			const auto& address_in = reinterpret_cast<const sockaddr_in&>(address);
+			return (ntohl(address_in.sin_addr.s_addr) >> 24) == 127;
+		}
+
+		const char* get_status_text(const int status)
+		{
+			switch (status)
+			{
+			case 200:
+				return "OK";
+			case 400:
+				return "Bad Request";
+			case 404:
+				return "Not Found";
+			case 405:
+				return "Method Not Allowed";
+			case 431:
+				return "Request Header Fields Too Large";
+			default:
+				return "Internal Server Error";
+			}
+		}
+
+		std::string format_response(const http_server::response& response)
+		{
+			std::string result = "HTTP/1.1 " + std::to_string(response.status) + " " + get_status_text(response.status) + "\r\n";
+			result.append("Content-Type: ").append(response.content_type).append("\r\n");
+			result.append("Content-Length: ").append(std::to_string(response.body.size())).append("\r\n");
+			result.append("Connection: close\r\n\r\n");
+			result.append(response.body);
+			return result;
+		}
+
+		std::string format_error(const int status)
+		{
+			return format_response({status, "text/plain; charset=utf-8", std::string(get_status_text(status)) + "\n"});
+		}
+	}
+
+	http_server::http_server(handler request_handler)
+		: handler_(std::move(request_handler))
+		, listener_(invalid_socket)
+	{
+#ifdef _WIN32
+		// The host might not have initialized Winsock yet
+		WSADATA wsa_data{};
+		this->wsa_started_ = WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0;
+#endif
+	}
+
+	http_server::~http_server()
+	{
+		this->close();
+
+#ifdef _WIN32
+		if (this->wsa_started_)
+		{
+			WSACleanup();
+		}
+#endif
+	}
+
+	void http_server::listen(const std::string& address, const bool allow_remote)
+	{
+		this->close();
+
+		const auto separator = address.rfind(':');
+		if (separator == std::string::npos)
+		{
+			throw std::runtime_error("Address '" + address + "' needs to be host:port");
+		}
+
+		const auto host = address.substr(0, separator);
+		const auto port = address.substr(separator + 1);
+
+		addrinfo hints{};
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_protocol = IPPROTO_TCP;
+
+		addrinfo* result{};
+		if (getaddrinfo(host.data(), port.data(), &hints, &result) != 0 || !result)
+		{
+			throw std::runtime_error("Failed to resolve '" + address + "'");
+		}
+
+		const std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> result_guard(result, &freeaddrinfo);
+
+		if (!allow_remote && !is_loopback(*result->ai_addr))
+		{
+			throw std::runtime_error("'" + address + "' is not a loopback address and remote clients are not allowed");
+		}
+
+		const auto listener = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+		if (from_native(listener) == invalid_socket)
+		{
+			throw std::runtime_error("Failed to create a socket: " + std::to_string(get_last_error()));
+		}
+
+#ifndef _WIN32
+		// Rebinding right after a restart would otherwise fail while old connections linger
+		const int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+		if (!set_non_blocking(listener)
+			|| bind(listener, result->ai_addr, static_cast<int>(result->ai_addrlen)) != 0
+			|| ::listen(listener, SOMAXCONN) != 0)
+		{
+			const auto error = get_last_error();
+			close_socket(listener);
+			throw std::runtime_error("Failed to listen on '" + address + "': " + std::to_string(error));
+		}
+
+		this->listener_ = from_native(listener);
+	}
+
+	void http_server::close()
+	{
+		for (const auto& client : this->connections_)
+		{
+			close_socket(to_native(client.socket));
+		}
+
+		this->connections_.clear();
+
+		if (this->listener_ != invalid_socket)
+		{
+			close_socket(to_native(this->listener_));
+			this->listener_ = invalid_socket;
+		}
+	}
+
+	bool http_server::is_listening() const
+	{
+		return this->listener_ != invalid_socket;
+	}
+
+	uint16_t http_server::get_port() const
+	{
+		if (!this->is_listening())
+		{
+			return 0;
+		}
+
+		sockaddr_in address{};
+		socklen_t length = sizeof(address);
+		if (getsockname(to_native(this->listener_), reinterpret_cast<sockaddr*>(&address), &length) != 0)
+		{
+			return 0;
+		}
+
+		return ntohs(address.sin_port);
+	}
+
+	void http_server::run_frame(const std::chrono::milliseconds timeout)
+	{
+		if (!this->is_listening())
+		{
+			std::this_thread::sleep_for(timeout);
+			return;
+		}
+
+		fd_set read_set{};
+		fd_set write_set{};
+		FD_ZERO(&read_set);
+		FD_ZERO(&write_set);
+
+		auto max_socket = to_native(this->listener_);
+		if (this->connections_.size() < max_connections)
+		{
+			FD_SET(to_native(this->listener_), &read_set);
+		}
+
+		for (const auto& client : this->connections_)
+		{
+			const auto socket = to_native(client.socket);
+			FD_SET(socket, client.response.empty() ? &read_set : &write_set);
+			max_socket = std::max(max_socket, socket);
+		}
+
+		const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+		timeval select_timeout{};
+		select_timeout.tv_sec = static_cast<decltype(select_timeout.tv_sec)>(microseconds / 1'000'000);
+		select_timeout.tv_usec = static_cast<decltype(select_timeout.tv_usec)>(microseconds % 1'000'000);
+
+		const auto ready = select(static_cast<int>(max_socket) + 1, &read_set, &write_set, nullptr, &select_timeout);
+		const auto now = std::chrono::steady_clock::now();
+
+		std::erase_if(this->connections_, [&](connection& client)
+		{
+			const auto socket = to_native(client.socket);
+
+			auto keep = now < client.deadline;
+			if (keep && ready > 0 && FD_ISSET(socket, &read_set))
+			{
+				keep = this->read_request(client);
+			}
+
+			// The response is sent right away, most of the time it fits into the socket buffer
+			if (keep && !client.response.empty() && (client.sent == 0 || (ready > 0 && FD_ISSET(socket, &write_set))))
+			{
+				keep = write_response(client);
+			}
+
+			if (!keep)
+			{
+				close_socket(socket);
+			}
+
+			return !keep;
+		});
+
+		if (ready > 0 && FD_ISSET(to_native(this->listener_), &read_set))
+		{
+			this->accept_connections();
+		}
+	}
+
+	void http_server::accept_connections()
+	{
+		while (this->connections_.size() < max_connections)
+		{
+			const auto socket = accept(to_native(this->listener_), nullptr, nullptr);
+			if (from_native(socket) == invalid_socket)
+			{
+				return;
+			}
+
+			if (!set_non_blocking(socket))
+			{
+				close_socket(socket);
+				continue;
+			}
+
+			auto& client = this->connections_.emplace_back();
+			client.socket = from_native(socket);
+			client.deadline = std::chrono::steady_clock::now() + client_timeout;
+		}
+	}
+
+	// Returns false once the connection should be closed
+	bool http_server::read_request(connection& client) const
+	{
+		char buffer[0x400];
+
+		while (true)
+		{
+			const auto length = recv(to_native(client.socket), buffer, static_cast<int>(sizeof(buffer)), 0);
+			if (length == 0)
+			{
+				return false;
+			}
+
+			if (length < 0)
+			{
+				return would_block();
+			}
+
+			client.request.append(buffer, static_cast<std::size_t>(length));
+
+			if (client.request.find("\r\n\r\n") != std::string::npos)
+			{
+				client.response = this->build_response(client.request);
+				return true;
+			}
+
+			if (client.request.size() >= max_request_size)
+			{
+				client.response = format_error(431);
+				return true;
+			}
+		}
+	}
+
+	bool http_server::write_response(connection& client)
+	{
+		while (client.sent < client.response.size())
+		{
+			const auto length = send(to_native(client.socket), client.response.data() + client.sent,
+			                         static_cast<int>(client.response.size() - client.sent), send_flags);
+			if (length < 0)
+			{
+				return would_block();
+			}
+
+			client.sent += static_cast<std::size_t>(length);
+		}
+
+		return false;
+	}
+
+	std::string http_server::build_response(const std::string_view request) const
+	{
+		// GET /path?query HTTP/1.1
+		const auto request_line = request.substr(0, request.find("\r\n"));
+		const auto target_start = request_line.find(' ');
+		const auto target_end = request_line.find(' ', target_start + 1);
+
+		if (target_start == std::string_view::npos || target_end == std::string_view::npos)
+		{
+			return format_error(400);
+		}
+
+		if (request_line.substr(0, target_start) != "GET")
+		{
+			return format_error(405);
+		}
+
+		const auto target = request_line.substr(target_start + 1, target_end - target_start - 1);
+
+		try
+		{
+			return format_response(this->handler_(target.substr(0, target.find('?'))));
+		}
+		catch (const std::exception&)
+		{
+			return format_error(500);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils
+{
+	// Answers GET requests from a single handler, meant for local scrapers.
+	// All sockets are non-blocking and served from run_frame, so a client that connects
+	// and never sends anything only holds its own slot until its deadline passes.
+	class http_server final
+	{
+	public:
+		struct response
+		{
+			int status = 200;
+			std::string content_type = "text/plain; charset=utf-8";
+			std::string body;
+		};
+
+		// Receives the request path without the query string
+		using handler = std::function<response(std::string_view path)>;
+
+		static constexpr std::size_t max_connections = 16;
+		static constexpr std::size_t max_request_size = 0x1000;
+		static constexpr std::chrono::seconds client_timeout{2};
+
+		explicit http_server(handler request_handler);
+		~http_server();
+
+		http_server(const http_server&) = delete;
+		http_server& operator=(const http_server&) = delete;
+
+		// Takes host:port and throws if it can't be resolved or bound.
+		// There is no authentication, so unless allow_remote is set only loopback addresses are accepted.
+		void listen(const std::string& address, bool allow_remote = false);
+		void close();
+
+		[[nodiscard]] bool is_listening() const;
+		[[nodiscard]] uint16_t get_port() const;
+
+		// Accepts, reads and writes whatever is ready, waiting at most the given time
+		void run_frame(std::chrono::milliseconds timeout);
+
+	private:
+		using socket_type = std::uintptr_t;
+
+		struct connection
+		{
+			socket_type socket{};
+			std::chrono::steady_clock::time_point deadline;
+			std::string request;
+			std::string response;
+			std::size_t sent{};
+		};
+
+		handler handler_;
+		socket_type listener_;
+		std::vector<connection> connections_;
+		bool wsa_started_{};
+
+		void accept_connections();
+		bool read_request(connection& client) const;
+		static bool write_response(connection& client);
+		std::string build_response(std::string_view request) const;
+	};
+}
@@ -2,6 +2,8 @@
 #include "nt.hpp"
 #include <fstream>
 
+#include <gsl/gsl>
+
 namespace utils::io
 {
 	bool remove_file(const std::string& file)
@@ -73,6 +75,67 @@ namespace utils::io
 		return false;
 	}
 
+	bool map_file(const std::string& file, const std::function<void(const uint8_t* data, size_t length)>& callback)
+	{
+		// Views are mapped one window at a time so huge files never need to be resident at once
+		constexpr uint64_t view_size = 64 * 1024 * 1024;
+
+		const auto file_handle = CreateFileA(file.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                                     FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_handle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		const auto _ = gsl::finally([&]()
+		{
+			CloseHandle(file_handle);
+		});
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file_handle, &size))
+		{
+			return false;
+		}
+
+		if (size.QuadPart == 0)
+		{
+			return true;
+		}
+
+		const auto mapping = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			return false;
+		}
+
+		const auto __ = gsl::finally([&]()
+		{
+			CloseHandle(mapping);
+		});
+
+		const auto total = static_cast<uint64_t>(size.QuadPart);
+		for (uint64_t offset = 0; offset < total; offset += view_size)
+		{
+			const auto length = static_cast<size_t>(std::min(view_size, total - offset));
+			const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32),
+			                                 static_cast<DWORD>(offset), length);
+			if (!view)
+			{
+				return false;
+			}
+
+			const auto ___ = gsl::finally([view]()
+			{
+				UnmapViewOfFile(view);
+			});
+
+			callback(static_cast<const uint8_t*>(view), length);
+		}
+
+		return true;
+	}
+
 	size_t file_size(const std::string& file)
 	{
 		if (file_exists(file))
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <filesystem>
+#include <functional>
 
 namespace utils::io
 {
@@ -12,6 +13,7 @@ namespace utils::io
 	bool write_file(const std::string& file, const std::string& data, bool append = false);
 	bool read_file(const std::string& file, std::string* data);
 	std::string read_file(const std::string& file);
+	bool map_file(const std::string& file, const std::function<void(const uint8_t* data, size_t length)>& callback);
 	size_t file_size(const std::string& file);
 	bool create_directory(const std::string& directory);
 	bool directory_exists(const std::string& directory);
@@ -0,0 +1,142 @@
+#include "latency_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace utils::latency_stats
+{
+	namespace
+	{
+		std::size_t get_bucket(const std::uint64_t duration_ns)
+		{
+			return std::min(static_cast<std::size_t>(std::bit_width(duration_ns)), histogram::bucket_count - 1);
+		}
+
+		void update_max(std::atomic_uint64_t& max, const std::uint64_t value)
+		{
+			auto current = max.load(std::memory_order_relaxed);
+			while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			{
+			}
+		}
+	}
+
+	void histogram::record(const std::uint64_t duration_ns)
+	{
+		this->count_.fetch_add(1, std::memory_order_relaxed);
+		this->total_ns_.fetch_add(duration_ns, std::memory_order_relaxed);
+		this->buckets_[get_bucket(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+		update_max(this->max_ns_, duration_ns);
+	}
+
+	void histogram::reset()
+	{
+		this->count_ = 0;
+		this->total_ns_ = 0;
+		this->max_ns_ = 0;
+
+		for (auto& bucket : this->buckets_)
+		{
+			bucket = 0;
+		}
+	}
+
+	std::uint64_t histogram::get_count() const
+	{
+		return this->count_.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t histogram::get_total() const
+	{
+		return this->total_ns_.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t histogram::get_max() const
+	{
+		return this->max_ns_.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t histogram::get_percentile(const std::uint64_t percentile) const
+	{
+		const auto target = (this->get_count() * percentile + 99) / 100;
+
+		std::uint64_t seen = 0;
+		for (std::size_t i = 0; i < this->buckets_.size(); ++i)
+		{
+			seen += this->buckets_[i].load(std::memory_order_relaxed);
+			if (seen >= target)
+			{
+				return i ? (1ull << i) - 1 : 0;
+			}
+		}
+
+		return this->get_max();
+	}
+
+	slowest_list::slowest_list(const std::size_t capacity)
+		: capacity_(std::max(capacity, static_cast<std::size_t>(1)))
+	{
+	}
+
+	void slowest_list::record(const int category, const std::string_view name, const std::uint64_t duration_ns)
+	{
+		if (duration_ns <= this->threshold_.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		this->entries_.access([&](std::vector<entry>& entries)
+		{
+			if (entries.size() >= this->capacity_ && duration_ns <= entries.back().duration_ns)
+			{
+				return;
+			}
+
+			const auto existing = std::ranges::find_if(entries, [&](const entry& e)
+			{
+				return e.category == category && e.name == name;
+			});
+
+			if (existing != entries.end())
+			{
+				if (existing->duration_ns >= duration_ns)
+				{
+					return;
+				}
+
+				entries.erase(existing);
+			}
+
+			const auto position = std::ranges::upper_bound(entries, duration_ns, std::greater{}, &entry::duration_ns);
+			entries.insert(position, entry{std::string(name), category, duration_ns});
+
+			if (entries.size() > this->capacity_)
+			{
+				entries.pop_back();
+			}
+
+			if (entries.size() == this->capacity_)
+			{
+				this->threshold_.store(entries.back().duration_ns, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	void slowest_list::reset()
+	{
+		this->entries_.access([this](std::vector<entry>& entries)
+		{
+			entries.clear();
+			this->threshold_ = 0;
+		});
+	}
+
+	std::vector<slowest_list::entry> slowest_list::get() const
+	{
+		return this->entries_.access<std::vector<entry>>([](const std::vector<entry>& entries)
+		{
+			return entries;
+		});
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "concurrency.hpp"
+
+namespace utils::latency_stats
+{
+	// Lock-free count, total, maximum and power of two buckets of durations in nanoseconds.
+	// The last bucket collects everything above ~1s.
+	class histogram final
+	{
+	public:
+		static constexpr std::size_t bucket_count = 32;
+
+		void record(std::uint64_t duration_ns);
+		void reset();
+
+		[[nodiscard]] std::uint64_t get_count() const;
+		[[nodiscard]] std::uint64_t get_total() const;
+		[[nodiscard]] std::uint64_t get_max() const;
+
+		// Upper bound of the bucket holding the percentile, an estimate within a factor of two
+		[[nodiscard]] std::uint64_t get_percentile(std::uint64_t percentile) const;
+
+	private:
+		std::atomic_uint64_t count_{0};
+		std::atomic_uint64_t total_ns_{0};
+		std::atomic_uint64_t max_ns_{0};
+		std::array<std::atomic_uint64_t, bucket_count> buckets_{};
+	};
+
+	// The slowest entries seen, slowest first, every name of a category at most once.
+	// Once full, durations below the fastest kept entry are dropped without taking the lock.
+	class slowest_list final
+	{
+	public:
+		struct entry
+		{
+			std::string name;
+			int category;
+			std::uint64_t duration_ns;
+		};
+
+		explicit slowest_list(std::size_t capacity);
+
+		void record(int category, std::string_view name, std::uint64_t duration_ns);
+		void reset();
+
+		[[nodiscard]] std::vector<entry> get() const;
+
+	private:
+		std::size_t capacity_;
+		std::atomic_uint64_t threshold_{0};
+		concurrency::container<std::vector<entry>> entries_;
+	};
+}
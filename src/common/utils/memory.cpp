@@ -1,5 +1,13 @@
 #include "memory.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
 #include "nt.hpp"
+#endif
 
 namespace utils
 {
@@ -99,6 +107,7 @@ namespace utils
 		return true;
 	}
 
+#ifdef _WIN32
 	bool memory::is_bad_read_ptr(const void* ptr)
 	{
 		MEMORY_BASIC_INFORMATION mbi = {};
@@ -154,6 +163,7 @@ namespace utils
 
 		return false;
 	}
+#endif
 
 	memory::allocator* memory::get_allocator()
 	{
@@ -0,0 +1,217 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+
+namespace utils::metrics
+{
+	namespace
+	{
+		std::string escape_label_value(const std::string& value)
+		{
+			std::string result;
+			result.reserve(value.size());
+
+			for (const auto character : value)
+			{
+				if (character == '\\' || character == '"')
+				{
+					result.push_back('\\');
+					result.push_back(character);
+				}
+				else if (character == '\n')
+				{
+					result.append("\\n");
+				}
+				else
+				{
+					result.push_back(character);
+				}
+			}
+
+			return result;
+		}
+
+		// {name="value"} with an optional extra label, or nothing without labels
+		std::string format_labels(const label& metric_label, const std::string_view extra = {})
+		{
+			std::string labels;
+			if (!metric_label.name.empty())
+			{
+				labels.append(metric_label.name).append("=\"").append(escape_label_value(metric_label.value)).append("\"");
+			}
+
+			if (!extra.empty())
+			{
+				labels.append(labels.empty() ? "" : ",").append(extra);
+			}
+
+			return labels.empty() ? std::string{} : "{" + labels + "}";
+		}
+
+		// Shortest representation that reads back to the same value
+		std::string format_number(const double value)
+		{
+			char buffer[32]{};
+			const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			return std::string(buffer, result.ptr);
+		}
+
+		double to_seconds(const std::chrono::nanoseconds duration)
+		{
+			return std::chrono::duration<double>(duration).count();
+		}
+
+		void append_sample(std::string& output, const std::string& name, const std::string_view suffix, const std::string& labels,
+		                   const std::string& value)
+		{
+			output.append(name).append(suffix).append(labels).append(" ").append(value).append("\n");
+		}
+	}
+
+	void histogram::observe(const std::chrono::nanoseconds duration)
+	{
+		const auto itr = std::ranges::lower_bound(bounds, duration);
+		const auto index = static_cast<std::size_t>(itr - bounds.begin());
+
+		this->buckets_[index].fetch_add(1, std::memory_order_relaxed);
+		this->sum_ns_.fetch_add(static_cast<std::uint64_t>(std::max(duration, std::chrono::nanoseconds::zero()).count()), std::memory_order_relaxed);
+	}
+
+	std::array<std::uint64_t, histogram::bounds.size() + 1> histogram::get_buckets() const
+	{
+		std::array<std::uint64_t, bounds.size() + 1> buckets{};
+
+		std::uint64_t total = 0;
+		for (std::size_t i = 0; i < buckets.size(); ++i)
+		{
+			total += this->buckets_[i].load(std::memory_order_relaxed);
+			buckets[i] = total;
+		}
+
+		return buckets;
+	}
+
+	std::chrono::nanoseconds histogram::get_sum() const
+	{
+		return std::chrono::nanoseconds(this->sum_ns_.load(std::memory_order_relaxed));
+	}
+
+	template <typename T>
+	T& registry::get_metric(const std::string& name, const std::string& help, const metric_type type, const label& metric_label)
+	{
+		return this->metrics_.access<T&>([&](std::vector<metric_entry>& list) -> T&
+		{
+			for (auto& entry : list)
+			{
+				if (entry.name == name && entry.metric_label.name == metric_label.name && entry.metric_label.value == metric_label.value)
+				{
+					if (entry.type != type)
+					{
+						throw std::runtime_error("Metric " + name + " was registered with a different type");
+					}
+
+					return *std::get<std::unique_ptr<T>>(entry.value);
+				}
+			}
+
+			auto& entry = list.emplace_back(metric_entry{name, help, type, metric_label, std::make_unique<T>()});
+			return *std::get<std::unique_ptr<T>>(entry.value);
+		});
+	}
+
+	counter& registry::get_counter(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return this->get_metric<counter>(name, help, metric_type::counter, metric_label);
+	}
+
+	gauge& registry::get_gauge(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return this->get_metric<gauge>(name, help, metric_type::gauge, metric_label);
+	}
+
+	histogram& registry::get_histogram(const std::string& name, const std::string& help, const label& metric_label)
+	{
+		return this->get_metric<histogram>(name, help, metric_type::histogram, metric_label);
+	}
+
+	std::string registry::render() const
+	{
+		return this->metrics_.access<std::string>([](const std::vector<metric_entry>& list)
+		{
+			std::string output;
+			std::unordered_set<std::string_view> rendered_names;
+
+			// Samples of one metric have to be grouped below a single header
+			for (const auto& entry : list)
+			{
+				if (!rendered_names.emplace(entry.name).second)
+				{
+					continue;
+				}
+
+				output.append("# HELP ").append(entry.name).append(" ").append(entry.help).append("\n");
+				output.append("# TYPE ").append(entry.name).append(" ").append(get_type_name(entry.type)).append("\n");
+
+				for (const auto& sample : list)
+				{
+					if (sample.name == entry.name)
+					{
+						render_entry(output, sample);
+					}
+				}
+			}
+
+			return output;
+		});
+	}
+
+	const char* registry::get_type_name(const metric_type type)
+	{
+		switch (type)
+		{
+		case metric_type::counter:
+			return "counter";
+		case metric_type::gauge:
+			return "gauge";
+		case metric_type::histogram:
+			return "histogram";
+		}
+
+		return "untyped";
+	}
+
+	void registry::render_entry(std::string& output, const metric_entry& entry)
+	{
+		const auto labels = format_labels(entry.metric_label);
+
+		switch (entry.type)
+		{
+		case metric_type::counter:
+			append_sample(output, entry.name, {}, labels, std::to_string(std::get<std::unique_ptr<counter>>(entry.value)->get()));
+			break;
+		case metric_type::gauge:
+			append_sample(output, entry.name, {}, labels, format_number(std::get<std::unique_ptr<gauge>>(entry.value)->get()));
+			break;
+		case metric_type::histogram:
+		{
+			const auto& value = *std::get<std::unique_ptr<histogram>>(entry.value);
+			const auto buckets = value.get_buckets();
+
+			for (std::size_t i = 0; i < histogram::bounds.size(); ++i)
+			{
+				const auto bound = "le=\"" + format_number(to_seconds(histogram::bounds[i])) + "\"";
+				append_sample(output, entry.name, "_bucket", format_labels(entry.metric_label, bound), std::to_string(buckets[i]));
+			}
+
+			append_sample(output, entry.name, "_bucket", format_labels(entry.metric_label, "le=\"+Inf\""), std::to_string(buckets.back()));
+			append_sample(output, entry.name, "_sum", labels, format_number(to_seconds(value.get_sum())));
+			append_sample(output, entry.name, "_count", labels, std::to_string(buckets.back()));
+			break;
+		}
+		}
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "concurrency.hpp"
+
+namespace utils::metrics
+{
+	// Updating a metric never locks, only looking one up does, so callers should keep the reference
+
+	class counter final
+	{
+	public:
+		void increment(const std::uint64_t value = 1)
+		{
+			this->value_.fetch_add(value, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] std::uint64_t get() const
+		{
+			return this->value_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic_uint64_t value_{0};
+	};
+
+	class gauge final
+	{
+	public:
+		void set(const double value)
+		{
+			this->value_.store(value, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] double get() const
+		{
+			return this->value_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<double> value_{0.0};
+	};
+
+	// Durations in fixed buckets from 1ms to 1s
+	class histogram final
+	{
+	public:
+		static constexpr std::array<std::chrono::nanoseconds, 11> bounds
+		{
+			std::chrono::milliseconds(1), std::chrono::microseconds(2500), std::chrono::milliseconds(5),
+			std::chrono::milliseconds(10), std::chrono::microseconds(16667), std::chrono::milliseconds(25),
+			std::chrono::microseconds(33333), std::chrono::milliseconds(50), std::chrono::milliseconds(100),
+			std::chrono::milliseconds(250), std::chrono::seconds(1),
+		};
+
+		void observe(std::chrono::nanoseconds duration);
+
+		// Cumulative counts per bound, followed by the total count
+		[[nodiscard]] std::array<std::uint64_t, bounds.size() + 1> get_buckets() const;
+		[[nodiscard]] std::chrono::nanoseconds get_sum() const;
+
+	private:
+		std::array<std::atomic_uint64_t, bounds.size() + 1> buckets_{};
+		std::atomic_uint64_t sum_ns_{0};
+	};
+
+	struct label
+	{
+		std::string name;
+		std::string value;
+	};
+
+	class registry final
+	{
+	public:
+		counter& get_counter(const std::string& name, const std::string& help, const label& metric_label = {});
+		gauge& get_gauge(const std::string& name, const std::string& help, const label& metric_label = {});
+		histogram& get_histogram(const std::string& name, const std::string& help, const label& metric_label = {});
+
+		// All metrics in the Prometheus text format
+		[[nodiscard]] std::string render() const;
+
+	private:
+		enum class metric_type
+		{
+			counter,
+			gauge,
+			histogram,
+		};
+
+		struct metric_entry
+		{
+			std::string name;
+			std::string help;
+			metric_type type;
+			label metric_label;
+			std::variant<std::unique_ptr<counter>, std::unique_ptr<gauge>, std::unique_ptr<histogram>> value;
+		};
+
+		concurrency::container<std::vector<metric_entry>> metrics_;
+
+		template <typename T>
+		T& get_metric(const std::string& name, const std::string& help, metric_type type, const label& metric_label);
+
+		static const char* get_type_name(metric_type type);
+		static void render_entry(std::string& output, const metric_entry& entry);
+	};
+}
@@ -0,0 +1,173 @@
+#include "output_history.hpp"
+
+#include <cstring>
+#include <thread>
+
+namespace utils
+{
+	output_history::output_history(const size_t capacity)
+		// The arena must fit at least one full line, or a long line would overrun a small history
+		: capacity_(capacity), slots_(capacity), arena_(std::max(capacity * 128, max_line_length))
+	{
+	}
+
+	size_t output_history::capacity() const
+	{
+		return this->capacity_;
+	}
+
+	size_t output_history::begin() const
+	{
+		return this->head_.load(std::memory_order_acquire);
+	}
+
+	size_t output_history::end() const
+	{
+		return this->tail_.load(std::memory_order_acquire);
+	}
+
+	void output_history::append(const std::string_view prefix, std::string_view line)
+	{
+		line = line.substr(0, max_line_length - std::min(prefix.size(), max_line_length));
+		const auto length = std::min(prefix.size(), max_line_length) + line.size();
+
+		auto head = this->head_.load(std::memory_order_relaxed);
+		const auto tail = this->tail_.load(std::memory_order_relaxed);
+
+		this->sequence_.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		auto position = this->cursor_;
+		if (position + length > this->arena_.size())
+		{
+			// Lines left behind the cursor are the oldest ones, drop them before wrapping
+			while (head != tail && this->get_slot(head).offset >= position)
+			{
+				++head;
+			}
+
+			position = 0;
+		}
+
+		while (head != tail && (tail - head >= this->capacity_ || this->overlaps(head, position, length)))
+		{
+			++head;
+		}
+
+		std::memcpy(this->arena_.data() + position, prefix.data(), length - line.size());
+		std::memcpy(this->arena_.data() + position + (length - line.size()), line.data(), line.size());
+
+		auto& slot = this->get_slot(tail);
+		slot.offset = position;
+		slot.length = length;
+
+		this->cursor_ = position + length;
+		this->head_.store(head, std::memory_order_relaxed);
+		this->tail_.store(tail + 1, std::memory_order_relaxed);
+
+		this->sequence_.fetch_add(1, std::memory_order_release);
+	}
+
+	bool output_history::read(size_t first, const size_t count, snapshot& out) const
+	{
+		for (auto attempt = 0; attempt < 16; ++attempt)
+		{
+			const auto sequence = this->sequence_.load(std::memory_order_acquire);
+			if (sequence & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			const auto head = this->head_.load(std::memory_order_relaxed);
+			const auto tail = this->tail_.load(std::memory_order_relaxed);
+			first = std::clamp(first, head, tail);
+
+			out.begin = head;
+			out.first = first;
+			out.total = tail - head;
+			out.text.clear();
+			out.lines.clear();
+
+			for (auto i = first; i < tail && i - first < count; ++i)
+			{
+				const auto& slot = this->get_slot(i);
+				const auto length = std::min(slot.length, max_line_length);
+				const auto offset = std::min(slot.offset, this->arena_.size() - length);
+
+				out.lines.emplace_back(out.text.size(), length);
+				out.text.append(this->arena_.data() + offset, length);
+				out.text.push_back('\0');
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (this->sequence_.load(std::memory_order_relaxed) == sequence)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	size_t output_history::get_first_visible_line(const size_t visible_lines) const
+	{
+		const auto begin = this->begin();
+		const auto end = this->end();
+		const auto bottom = std::max(begin, end - std::min(end, visible_lines));
+
+		const auto line = this->display_line_.load(std::memory_order_relaxed);
+		return line == follow_output ? bottom : std::clamp(line, begin, bottom);
+	}
+
+	void output_history::scroll(const int lines, const size_t visible_lines)
+	{
+		const auto begin = this->begin();
+		const auto end = this->end();
+		if (end - begin <= visible_lines)
+		{
+			return;
+		}
+
+		const auto bottom = end - visible_lines;
+		const auto distance = static_cast<size_t>(lines < 0 ? -static_cast<long long>(lines) : lines);
+
+		auto current = this->display_line_.load(std::memory_order_relaxed);
+		while (true)
+		{
+			const auto first = current == follow_output ? bottom : std::clamp(current, begin, bottom);
+
+			auto next = lines < 0 ? first - std::min(first - begin, distance) : std::min(first + distance, bottom);
+			if (lines >= 0 && next == bottom)
+			{
+				next = follow_output;
+			}
+
+			if (this->display_line_.compare_exchange_weak(current, next, std::memory_order_relaxed))
+			{
+				return;
+			}
+		}
+	}
+
+	bool output_history::is_following_output() const
+	{
+		return this->display_line_.load(std::memory_order_relaxed) == follow_output;
+	}
+
+	output_history::line_slot& output_history::get_slot(const size_t index)
+	{
+		return this->slots_[index % this->capacity_];
+	}
+
+	const output_history::line_slot& output_history::get_slot(const size_t index) const
+	{
+		return this->slots_[index % this->capacity_];
+	}
+
+	bool output_history::overlaps(const size_t index, const size_t position, const size_t length) const
+	{
+		const auto& slot = this->get_slot(index);
+		return slot.offset < position + length && position < slot.offset + slot.length;
+	}
+}
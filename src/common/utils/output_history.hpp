@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+	// Fixed-capacity ring of line slots backed by one contiguous text arena.
+	// Appends are serialized by the caller, readers copy lines out under a seqlock
+	// so rendering never blocks on writers.
+	// The scroll position is kept here as well: input and render threads update it without
+	// a lock, and a history that gets replaced (cleared or resized) starts out following the output.
+	class output_history final
+	{
+	public:
+		static constexpr size_t max_line_length = 1024;
+
+		struct snapshot
+		{
+			size_t begin{};
+			size_t first{};
+			size_t total{};
+			std::string text{};
+			std::vector<std::pair<size_t, size_t>> lines{};
+		};
+
+		explicit output_history(size_t capacity);
+
+		[[nodiscard]] size_t capacity() const;
+
+		// Absolute index of the oldest line and one past the newest line
+		[[nodiscard]] size_t begin() const;
+		[[nodiscard]] size_t end() const;
+
+		void append(std::string_view prefix, std::string_view line);
+
+		// Copies up to count lines starting at the absolute index first
+		bool read(size_t first, size_t count, snapshot& out) const;
+
+		// Must be called by the writer, lines aren't protected against concurrent appends
+		template <typename F>
+		void for_each(const size_t first, F&& callback) const
+		{
+			const auto tail = this->tail_.load(std::memory_order_relaxed);
+			for (auto i = std::max(first, this->begin()); i < tail; ++i)
+			{
+				const auto& slot = this->get_slot(i);
+				callback(std::string_view(this->arena_.data() + slot.offset, slot.length));
+			}
+		}
+
+		// First line of a view that shows the given number of lines
+		[[nodiscard]] size_t get_first_visible_line(size_t visible_lines) const;
+
+		// Moves the view up (negative) or down, reaching the newest line follows the output again
+		void scroll(int lines, size_t visible_lines);
+		[[nodiscard]] bool is_following_output() const;
+
+	private:
+		static constexpr size_t follow_output = ~size_t{0};
+
+		struct line_slot
+		{
+			size_t offset;
+			size_t length;
+		};
+
+		size_t capacity_;
+		std::vector<line_slot> slots_;
+		std::vector<char> arena_;
+		size_t cursor_{};
+
+		std::atomic<size_t> head_{0};
+		std::atomic<size_t> tail_{0};
+		std::atomic<size_t> sequence_{0};
+
+		// First visible line, or follow_output to stick to the newest lines
+		std::atomic<size_t> display_line_{follow_output};
+
+		line_slot& get_slot(size_t index);
+		const line_slot& get_slot(size_t index) const;
+		bool overlaps(size_t index, size_t position, size_t length) const;
+	};
+}
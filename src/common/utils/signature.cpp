@@ -1,4 +1,5 @@
 #include "signature.hpp"
+#include "io.hpp"
 #include <thread>
 #include <mutex>
 
@@ -6,53 +7,53 @@
 
 namespace utils::hook
 {
-	void signature::load_pattern(const std::string& pattern)
+	namespace
 	{
-		this->mask_.clear();
-		this->pattern_.clear();
-
-		uint8_t nibble = 0;
-		auto has_nibble = false;
+		constexpr uint32_t cache_magic = 0x53494743;
+		constexpr uint32_t cache_version = 1;
 
-		for (auto val : pattern)
+		uint64_t fnv1a(const void* data, const size_t length, uint64_t hash = 0xCBF29CE484222325)
 		{
-			if (val == ' ') continue;
-			if (val == '?')
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < length; ++i)
 			{
-				this->mask_.push_back(val);
-				this->pattern_.push_back(0);
+				hash ^= bytes[i];
+				hash *= 0x100000001B3;
 			}
-			else
-			{
-				if ((val < '0' || val > '9') && (val < 'A' || val > 'F') && (val < 'a' || val > 'f'))
-				{
-					throw std::runtime_error("Invalid pattern");
-				}
 
-				char str[] = {val, 0};
-				const auto current_nibble = static_cast<uint8_t>(strtol(str, nullptr, 16));
+			return hash;
+		}
 
-				if (!has_nibble)
-				{
-					has_nibble = true;
-					nibble = current_nibble;
-				}
-				else
-				{
-					has_nibble = false;
-					const uint8_t byte = current_nibble | (nibble << 4);
+		uint64_t get_pattern_hash(const signature_scanner::pattern& pattern)
+		{
+			return fnv1a(pattern.bytes.data(), pattern.mask.size(), fnv1a(pattern.mask.data(), pattern.mask.size()));
+		}
 
-					this->mask_.push_back('x');
-					this->pattern_.push_back(byte);
-				}
-			}
+		template <typename T>
+		void write_value(std::string& buffer, const T& value)
+		{
+			buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
 		}
 
-		while (!this->mask_.empty() && this->mask_.back() == '?')
+		template <typename T>
+		bool read_value(const std::string& buffer, size_t& offset, T& value)
 		{
-			this->mask_.pop_back();
-			this->pattern_.pop_back();
+			if (offset + sizeof(T) > buffer.size())
+			{
+				return false;
+			}
+
+			std::memcpy(&value, buffer.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
 		}
+	}
+
+	void signature::load_pattern(const std::string& pattern)
+	{
+		auto parsed = signature_scanner::parse(pattern);
+		this->mask_ = std::move(parsed.mask);
+		this->pattern_ = std::move(parsed.bytes);
 
 		if (this->has_sse_support())
 		{
@@ -61,11 +62,6 @@ namespace utils::hook
 				this->pattern_.push_back(0);
 			}
 		}
-
-		if (has_nibble)
-		{
-			throw std::runtime_error("Invalid pattern");
-		}
 	}
 
 	std::vector<size_t> signature::process_range(uint8_t* start, const size_t length) const
@@ -204,6 +200,139 @@ namespace utils::hook
 
 		return false;
 	}
+
+	signature_batch::signature_batch(const nt::library library)
+		: signature_batch(library.get_ptr(), library.get_optional_header()->SizeOfImage)
+	{
+		const auto* nt_headers = library.get_nt_headers();
+		this->key_ = fnv1a(&nt_headers->OptionalHeader.CheckSum, sizeof(nt_headers->OptionalHeader.CheckSum));
+		this->key_ = fnv1a(&nt_headers->FileHeader.TimeDateStamp, sizeof(nt_headers->FileHeader.TimeDateStamp),
+		                   this->key_);
+		this->key_ = fnv1a(&nt_headers->OptionalHeader.SizeOfImage, sizeof(nt_headers->OptionalHeader.SizeOfImage),
+		                   this->key_);
+	}
+
+	size_t signature_batch::add(const std::string& pattern)
+	{
+		return this->scanner_.add(pattern);
+	}
+
+	size_t signature_batch::size() const
+	{
+		return this->scanner_.size();
+	}
+
+	void signature_batch::set_cache_file(const std::string& file)
+	{
+		this->cache_file_ = file;
+	}
+
+	void signature_batch::set_cache_file(const std::string& file, const uint64_t key)
+	{
+		this->cache_file_ = file;
+		this->key_ = key;
+	}
+
+	std::vector<signature::signature_result> signature_batch::process() const
+	{
+		match_list matches;
+		if (!this->load_cache(matches))
+		{
+			matches = this->scanner_.scan(this->start_, this->length_);
+			this->store_cache(matches);
+		}
+
+		std::vector<signature::signature_result> results;
+		results.reserve(matches.size());
+
+		for (auto& offsets : matches)
+		{
+			for (auto& offset : offsets)
+			{
+				offset += size_t(this->start_);
+			}
+
+			results.emplace_back(std::move(offsets));
+		}
+
+		return results;
+	}
+
+	bool signature_batch::load_cache(match_list& matches) const
+	{
+		std::string data;
+		if (this->cache_file_.empty() || !io::read_file(this->cache_file_, &data))
+		{
+			return false;
+		}
+
+		size_t offset = 0;
+		uint32_t magic{}, version{};
+		uint64_t key{}, length{}, count{};
+
+		if (!read_value(data, offset, magic) || magic != cache_magic
+			|| !read_value(data, offset, version) || version != cache_version
+			|| !read_value(data, offset, key) || key != this->key_
+			|| !read_value(data, offset, length) || length != this->length_
+			|| !read_value(data, offset, count) || count != this->scanner_.size())
+		{
+			return false;
+		}
+
+		matches.assign(this->scanner_.size(), {});
+
+		for (size_t i = 0; i < this->scanner_.size(); ++i)
+		{
+			uint64_t hash{}, match_count{};
+			if (!read_value(data, offset, hash) || hash != get_pattern_hash(this->scanner_.get(i))
+				|| !read_value(data, offset, match_count))
+			{
+				return false;
+			}
+
+			for (uint64_t j = 0; j < match_count; ++j)
+			{
+				uint64_t match{};
+				if (!read_value(data, offset, match)
+					|| !this->scanner_.matches_at(i, this->start_, this->length_, static_cast<size_t>(match)))
+				{
+					return false;
+				}
+
+				matches[i].push_back(static_cast<size_t>(match));
+			}
+		}
+
+		return true;
+	}
+
+	void signature_batch::store_cache(const match_list& matches) const
+	{
+		if (this->cache_file_.empty())
+		{
+			return;
+		}
+
+		std::string data;
+		write_value(data, cache_magic);
+		write_value(data, cache_version);
+		write_value(data, this->key_);
+		write_value(data, static_cast<uint64_t>(this->length_));
+		write_value(data, static_cast<uint64_t>(this->scanner_.size()));
+
+		for (size_t i = 0; i < this->scanner_.size(); ++i)
+		{
+			write_value(data, get_pattern_hash(this->scanner_.get(i)));
+			write_value(data, static_cast<uint64_t>(matches[i].size()));
+
+			for (const auto& match : matches[i])
+			{
+				write_value(data, static_cast<uint64_t>(match));
+			}
+		}
+
+		io::write_file(this->cache_file_, data);
+	}
 }
 
 utils::hook::signature::signature_result operator"" _sig(const char* str, const size_t len)
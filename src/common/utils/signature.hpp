@@ -1,5 +1,6 @@
 #pragma once
 #include "nt.hpp"
+#include "signature_scanner.hpp"
 #include <cstdint>
 
 namespace utils::hook
@@ -68,6 +69,47 @@ namespace utils::hook
 
 		bool has_sse_support() const;
 	};
+
+	// Finds many signatures in a single pass over the image, see signature_scanner
+	class signature_batch final
+	{
+	public:
+		explicit signature_batch(const nt::library library = {});
+
+		signature_batch(void* start, void* end)
+			: signature_batch(start, size_t(end) - size_t(start))
+		{
+		}
+
+		signature_batch(void* start, const size_t length)
+			: start_(static_cast<uint8_t*>(start)), length_(length)
+		{
+		}
+
+		size_t add(const std::string& pattern);
+		[[nodiscard]] size_t size() const;
+
+		// Results are stored in the given file and reused as long as the key matches.
+		// The library constructor derives the key from the module checksum.
+		void set_cache_file(const std::string& file);
+		void set_cache_file(const std::string& file, uint64_t key);
+
+		std::vector<signature::signature_result> process() const;
+
+	private:
+		using match_list = signature_scanner::match_list;
+
+		uint8_t* start_;
+		size_t length_;
+
+		uint64_t key_{};
+		std::string cache_file_;
+
+		signature_scanner scanner_;
+
+		bool load_cache(match_list& matches) const;
+		void store_cache(const match_list& matches) const;
+	};
 }
 
 utils::hook::signature::signature_result operator"" _sig(const char* str, size_t len);
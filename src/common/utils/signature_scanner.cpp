@@ -0,0 +1,361 @@
+#include "signature_scanner.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SIGNATURE_SCANNER_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// The AVX2 filter is only called after checking the CPU, the rest of the file stays baseline x64
+#if defined(SIGNATURE_SCANNER_AVX2) && !defined(_MSC_VER)
+#define SIGNATURE_SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIGNATURE_SCANNER_TARGET_AVX2
+#endif
+
+namespace utils::hook
+{
+	namespace
+	{
+#ifdef SIGNATURE_SCANNER_AVX2
+		std::array<uint32_t, 4> get_cpu_id(const uint32_t leaf, const uint32_t sub_leaf)
+		{
+			std::array<uint32_t, 4> registers{};
+#ifdef _MSC_VER
+			__cpuidex(reinterpret_cast<int*>(registers.data()), static_cast<int>(leaf), static_cast<int>(sub_leaf));
+#else
+			__cpuid_count(leaf, sub_leaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+			return registers;
+		}
+
+		uint64_t get_enabled_xsave_features()
+		{
+#ifdef _MSC_VER
+			return _xgetbv(0);
+#else
+			uint32_t low{}, high{};
+			__asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+			return low | (static_cast<uint64_t>(high) << 32);
+#endif
+		}
+#endif
+
+		uint8_t parse_nibble(const char value)
+		{
+			if (value >= '0' && value <= '9') return static_cast<uint8_t>(value - '0');
+			if (value >= 'a' && value <= 'f') return static_cast<uint8_t>(value - 'a' + 10);
+			if (value >= 'A' && value <= 'F') return static_cast<uint8_t>(value - 'A' + 10);
+
+			throw std::runtime_error("Invalid pattern");
+		}
+	}
+
+	signature_scanner::pattern signature_scanner::parse(const std::string& pattern)
+	{
+		signature_scanner::pattern result{};
+
+		uint8_t nibble = 0;
+		auto has_nibble = false;
+
+		for (const auto value : pattern)
+		{
+			if (value == ' ') continue;
+			if (value == '?')
+			{
+				result.mask.push_back('?');
+				result.bytes.push_back(0);
+				continue;
+			}
+
+			const auto current_nibble = parse_nibble(value);
+			if (!has_nibble)
+			{
+				has_nibble = true;
+				nibble = current_nibble;
+				continue;
+			}
+
+			has_nibble = false;
+			result.mask.push_back('x');
+			result.bytes.push_back(static_cast<uint8_t>(current_nibble | (nibble << 4)));
+		}
+
+		if (has_nibble)
+		{
+			throw std::runtime_error("Invalid pattern");
+		}
+
+		while (!result.mask.empty() && result.mask.back() == '?')
+		{
+			result.mask.pop_back();
+			result.bytes.pop_back();
+		}
+
+		return result;
+	}
+
+	size_t signature_scanner::add(const std::string& pattern)
+	{
+		auto parsed = parse(pattern);
+		if (parsed.mask.find('x') == std::string::npos)
+		{
+			throw std::runtime_error("Invalid pattern");
+		}
+
+		this->patterns_.emplace_back(std::move(parsed));
+		return this->patterns_.size() - 1;
+	}
+
+	size_t signature_scanner::size() const
+	{
+		return this->patterns_.size();
+	}
+
+	const signature_scanner::pattern& signature_scanner::get(const size_t index) const
+	{
+		return this->patterns_.at(index);
+	}
+
+	signature_scanner::match_list signature_scanner::scan(const uint8_t* data, const size_t length) const
+	{
+		match_list matches(this->patterns_.size());
+		if (this->patterns_.empty() || !length)
+		{
+			return matches;
+		}
+
+		const auto table = this->build_anchors(data, length);
+
+		const auto cores = std::max(1u, std::thread::hardware_concurrency() / 2);
+		// Only use half of the available cores
+		if (cores == 1 || length <= cores * 0x10000ull)
+		{
+			this->scan_range(table, data, length, 0, length, matches);
+			return matches;
+		}
+
+		const auto grid = length / cores;
+
+		std::vector<match_list> local_matches(cores, match_list(this->patterns_.size()));
+		std::vector<std::thread> threads;
+
+		for (auto i = 0u; i < cores; ++i)
+		{
+			const auto start = grid * i;
+			const auto end = (i + 1 == cores) ? length : start + grid;
+			threads.emplace_back([&, i, start, end]()
+			{
+				this->scan_range(table, data, length, start, end, local_matches[i]);
+			});
+		}
+
+		for (auto& t : threads)
+		{
+			if (t.joinable())
+			{
+				t.join();
+			}
+		}
+
+		// Every match is found by exactly one thread, at its anchor position
+		for (size_t i = 0; i < matches.size(); ++i)
+		{
+			for (const auto& local : local_matches)
+			{
+				matches[i].insert(matches[i].end(), local[i].begin(), local[i].end());
+			}
+
+			std::sort(matches[i].begin(), matches[i].end());
+		}
+
+		return matches;
+	}
+
+	bool signature_scanner::matches_at(const size_t index, const uint8_t* data, const size_t length,
+	                                   const size_t offset) const
+	{
+		const auto& [mask, bytes] = this->patterns_[index];
+		if (offset > length || mask.size() > length - offset)
+		{
+			return false;
+		}
+
+		const auto* address = data + offset;
+		for (size_t j = 0; j < mask.size(); ++j)
+		{
+			if (mask[j] != '?' && bytes[j] != address[j])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	signature_scanner::anchor_table signature_scanner::build_anchors(const uint8_t* data, const size_t length) const
+	{
+		// Sample the buffer to estimate how common each byte value is
+		std::array<size_t, 256> histogram{};
+		for (size_t i = 0; i < length; i += 61)
+		{
+			++histogram[data[i]];
+		}
+
+		anchor_table table{};
+
+		for (size_t i = 0; i < this->patterns_.size(); ++i)
+		{
+			const auto& [mask, bytes] = this->patterns_[i];
+
+			auto best = std::string::npos;
+			for (size_t j = 0; j < mask.size(); ++j)
+			{
+				if (mask[j] == 'x' && (best == std::string::npos || histogram[bytes[j]] < histogram[bytes[best]]))
+				{
+					best = j;
+				}
+			}
+
+			const auto value = bytes[best];
+			table.buckets[value].emplace_back(anchor{i, best});
+			table.anchors[value] = true;
+		}
+
+		return table;
+	}
+
+	void signature_scanner::scan_range(const anchor_table& table, const uint8_t* data, const size_t length,
+	                                   const size_t start, const size_t end, match_list& matches) const
+	{
+		auto i = start;
+
+		if (has_avx2_support())
+		{
+			i = this->filter_avx2(table, data, length, start, end, matches);
+		}
+
+		for (; i < end; ++i)
+		{
+			if (table.anchors[data[i]])
+			{
+				this->check(table, data, length, i, matches);
+			}
+		}
+	}
+
+	void signature_scanner::check(const anchor_table& table, const uint8_t* data, const size_t length,
+	                              const size_t position, match_list& matches) const
+	{
+		for (const auto& entry : table.buckets[data[position]])
+		{
+			if (position < entry.offset) continue;
+
+			const auto offset = position - entry.offset;
+			if (this->matches_at(entry.index, data, length, offset))
+			{
+				matches[entry.index].push_back(offset);
+			}
+		}
+	}
+
+	// Returns the first position that still has to be checked without AVX2
+	SIGNATURE_SCANNER_TARGET_AVX2 size_t signature_scanner::filter_avx2(const anchor_table& table, const uint8_t* data,
+	                                                                    const size_t length, const size_t start,
+	                                                                    const size_t end, match_list& matches) const
+	{
+		auto i = start;
+
+#ifdef SIGNATURE_SCANNER_AVX2
+		// Byte set membership through nibble lookups:
+		// the low nibble selects a row, the high nibble selects a bit in that row.
+		// Rows for high nibbles 8-15 live in a second table, picked by the sign bit.
+		alignas(16) uint8_t low_rows[16]{};
+		alignas(16) uint8_t high_rows[16]{};
+		alignas(16) uint8_t bit_values[16]{};
+
+		for (auto value = 0; value < 256; ++value)
+		{
+			if (!table.anchors[value]) continue;
+
+			auto& rows = (value & 0x80) ? high_rows : low_rows;
+			rows[value & 0xF] |= static_cast<uint8_t>(1 << ((value >> 4) & 7));
+		}
+
+		for (auto j = 0; j < 16; ++j)
+		{
+			bit_values[j] = static_cast<uint8_t>(1 << (j & 7));
+		}
+
+		const auto low_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(low_rows)));
+		const auto high_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(high_rows)));
+		const auto bit_table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(bit_values)));
+		const auto nibble_mask = _mm256_set1_epi8(0xF);
+
+		for (; i + 32 <= end; i += 32)
+		{
+			const auto value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			const auto low = _mm256_and_si256(value, nibble_mask);
+			const auto high = _mm256_and_si256(_mm256_srli_epi16(value, 4), nibble_mask);
+
+			const auto rows = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_table, low),
+			                                     _mm256_shuffle_epi8(high_table, low), value);
+			const auto bits = _mm256_shuffle_epi8(bit_table, high);
+			const auto hits = _mm256_cmpeq_epi8(_mm256_and_si256(rows, bits), bits);
+
+			auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+			while (mask)
+			{
+				const auto index = static_cast<size_t>(std::countr_zero(mask));
+				mask &= mask - 1;
+
+				this->check(table, data, length, i + index, matches);
+			}
+		}
+#else
+		(void)table;
+		(void)data;
+		(void)length;
+		(void)end;
+		(void)matches;
+#endif
+
+		return i;
+	}
+
+	bool signature_scanner::has_avx2_support()
+	{
+#ifdef SIGNATURE_SCANNER_AVX2
+		static const auto supported = []
+		{
+			if (get_cpu_id(0, 0)[0] < 7)
+			{
+				return false;
+			}
+
+			// OSXSAVE and AVX, then make sure the OS preserves the ymm state
+			constexpr auto required = (1u << 27) | (1u << 28);
+			if ((get_cpu_id(1, 0)[2] & required) != required || (get_enabled_xsave_features() & 6) != 6)
+			{
+				return false;
+			}
+
+			return (get_cpu_id(7, 0)[1] & (1u << 5)) != 0;
+		}();
+
+		return supported;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace utils::hook
+{
+	// Finds many byte patterns in a single pass over a buffer.
+	// Every pattern is anchored on its rarest fixed byte, positions holding
+	// any anchor byte are filtered (using AVX2 where available) and then verified.
+	class signature_scanner final
+	{
+	public:
+		struct pattern
+		{
+			// 'x' for a fixed byte, '?' for a wildcard
+			std::string mask;
+			std::basic_string<uint8_t> bytes;
+		};
+
+		// Offsets of every match, one list per pattern in the order they were added
+		using match_list = std::vector<std::vector<size_t>>;
+
+		// Hex bytes separated by spaces, every '?' is a single wildcard byte. Throws on malformed input.
+		static pattern parse(const std::string& pattern);
+
+		// Patterns need at least one fixed byte
+		size_t add(const std::string& pattern);
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] const pattern& get(size_t index) const;
+
+		// Splits large buffers across half of the available cores
+		[[nodiscard]] match_list scan(const uint8_t* data, size_t length) const;
+
+		[[nodiscard]] bool matches_at(size_t index, const uint8_t* data, size_t length, size_t offset) const;
+
+	private:
+		struct anchor
+		{
+			size_t index;
+			size_t offset;
+		};
+
+		struct anchor_table
+		{
+			std::vector<anchor> buckets[256];
+			bool anchors[256]{};
+		};
+
+		std::vector<pattern> patterns_;
+
+		anchor_table build_anchors(const uint8_t* data, size_t length) const;
+		void scan_range(const anchor_table& table, const uint8_t* data, size_t length, size_t start, size_t end,
+		                match_list& matches) const;
+		size_t filter_avx2(const anchor_table& table, const uint8_t* data, size_t length, size_t start, size_t end,
+		                   match_list& matches) const;
+		void check(const anchor_table& table, const uint8_t* data, size_t length, size_t position,
+		           match_list& matches) const;
+
+		static bool has_avx2_support();
+	};
+}
@@ -1,9 +1,14 @@
 #include "string.hpp"
-#include <sstream>
 #include <cstdarg>
 #include <algorithm>
 
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef _WIN32
 #include "nt.hpp"
+#endif
 
 namespace utils::string
 {
@@ -20,51 +25,138 @@ namespace utils::string
 		return result;
 	}
 
-	std::vector<std::string> split(const std::string& s, const char delim)
+	namespace
+	{
+		// Only ASCII letters change, which matches tolower/toupper in the "C" locale
+		template <char First, char Last>
+		void flip_ascii_case(char* data, const size_t length)
+		{
+			size_t i = 0;
+
+#if defined(_M_X64) || defined(__SSE2__)
+			const auto lower_bound = _mm_set1_epi8(static_cast<char>(First - 1));
+			const auto upper_bound = _mm_set1_epi8(static_cast<char>(Last + 1));
+			const auto case_bit = _mm_set1_epi8(0x20);
+
+			for (; i + 16 <= length; i += 16)
+			{
+				auto* const block = reinterpret_cast<__m128i*>(data + i);
+				const auto chars = _mm_loadu_si128(block);
+
+				// Bytes >= 0x80 compare as negative and are never inside the range
+				const auto in_range = _mm_and_si128(_mm_cmpgt_epi8(chars, lower_bound),
+				                                    _mm_cmplt_epi8(chars, upper_bound));
+
+				_mm_storeu_si128(block, _mm_xor_si128(chars, _mm_and_si128(in_range, case_bit)));
+			}
+#endif
+
+			for (; i < length; ++i)
+			{
+				if (data[i] >= First && data[i] <= Last)
+				{
+					data[i] = static_cast<char>(data[i] ^ 0x20);
+				}
+			}
+		}
+	}
+
+	std::vector<std::string> split(const std::string_view s, const char delim)
 	{
-		std::stringstream ss(s);
-		std::string item;
 		std::vector<std::string> elems;
+		elems.reserve(static_cast<size_t>(std::ranges::count(s, delim)) + 1);
 
-		while (std::getline(ss, item, delim))
+		for (const auto& item : split_view(s, delim))
 		{
-			elems.push_back(item); // elems.push_back(std::move(item)); // if C++11 (based on comment from @mchiasson)
+			elems.emplace_back(item);
 		}
 
 		return elems;
 	}
 
+	std::vector<std::string> split(const std::string& s, const char delim)
+	{
+		return split(std::string_view{s}, delim);
+	}
+
+	std::vector<std::string> split(const char* s, const char delim)
+	{
+		return split(std::string_view{s}, delim);
+	}
+
+	std::string to_lower(const std::string_view text)
+	{
+		std::string result{text};
+		to_lower_inplace(result);
+		return result;
+	}
+
 	std::string to_lower(const std::string& text)
 	{
-		std::string result;
-		std::ranges::transform(text, std::back_inserter(result), [](const unsigned char input)
-		{
-			return static_cast<char>(std::tolower(input));
-		});
+		return to_lower(std::string_view{text});
+	}
 
+	std::string to_lower(const char* text)
+	{
+		return to_lower(std::string_view{text});
+	}
+
+	std::string to_upper(const std::string_view text)
+	{
+		std::string result{text};
+		to_upper_inplace(result);
 		return result;
 	}
 
 	std::string to_upper(const std::string& text)
 	{
-		std::string result;
-		std::ranges::transform(text, std::back_inserter(result), [](const unsigned char input)
-		{
-			return static_cast<char>(std::toupper(input));
-		});
+		return to_upper(std::string_view{text});
+	}
 
-		return result;
+	std::string to_upper(const char* text)
+	{
+		return to_upper(std::string_view{text});
+	}
+
+	void to_lower_inplace(std::string& text)
+	{
+		flip_ascii_case<'A', 'Z'>(text.data(), text.size());
+	}
+
+	void to_upper_inplace(std::string& text)
+	{
+		flip_ascii_case<'a', 'z'>(text.data(), text.size());
+	}
+
+	bool starts_with(const std::string_view text, const std::string_view substring)
+	{
+		return text.size() >= substring.size() && text.compare(0, substring.size(), substring) == 0;
+	}
+
+	bool ends_with(const std::string_view text, const std::string_view substring)
+	{
+		return text.size() >= substring.size()
+			&& text.compare(text.size() - substring.size(), substring.size(), substring) == 0;
 	}
 
 	bool starts_with(const std::string& text, const std::string& substring)
 	{
-		return text.find(substring) == 0;
+		return starts_with(std::string_view{text}, std::string_view{substring});
+	}
+
+	bool starts_with(const char* text, const char* substring)
+	{
+		return starts_with(std::string_view{text}, std::string_view{substring});
 	}
 
 	bool ends_with(const std::string& text, const std::string& substring)
 	{
-		if (substring.size() > text.size()) return false;
-		return std::equal(substring.rbegin(), substring.rend(), text.rbegin());
+		return ends_with(std::string_view{text}, std::string_view{substring});
+	}
+
+	bool ends_with(const char* text, const char* substring)
+	{
+		return ends_with(std::string_view{text}, std::string_view{substring});
 	}
 
 	std::string dump_hex(const std::string& data, const std::string& separator)
@@ -84,6 +176,7 @@ namespace utils::string
 		return result;
 	}
 
+#ifdef _WIN32
 	std::string get_clipboard_data()
 	{
 		if (OpenClipboard(nullptr))
@@ -106,6 +199,7 @@ namespace utils::string
 		}
 		return {};
 	}
+#endif
 
 	void strip(const char* in, char* out, size_t max)
 	{
@@ -176,4 +270,24 @@ namespace utils::string
 
 		return str;
 	}
+
+	std::string quote_csv(const std::string_view field)
+	{
+		std::string result;
+		result.reserve(field.size() + 2);
+		result.push_back('"');
+
+		for (const auto chr : field)
+		{
+			if (chr == '"')
+			{
+				result.push_back('"');
+			}
+
+			result.push_back(chr);
+		}
+
+		result.push_back('"');
+		return result;
+	}
 }
@@ -1,6 +1,10 @@
 #pragma once
 #include "memory.hpp"
+#include <cstdarg>
 #include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string_view>
 
 template <class Type, size_t n>
 constexpr auto ARRAY_COUNT(Type(&)[n]) { return n; }
@@ -17,7 +21,7 @@ namespace utils::string
 		{
 		}
 
-		char* get(const char* format, const va_list ap)
+		char* get(const char* format, va_list ap)
 		{
 			++this->current_buffer_ %= ARRAY_COUNT(this->string_pool_);
 			auto entry = &this->string_pool_[this->current_buffer_];
@@ -29,7 +33,16 @@ namespace utils::string
 
 			while (true)
 			{
+#ifdef _WIN32
 				const int res = vsnprintf_s(entry->buffer, entry->size, _TRUNCATE, format, ap);
+#else
+				// vsnprintf consumes its va_list and reports the untruncated length instead of -1
+				va_list copy;
+				va_copy(copy, ap);
+				const auto length = vsnprintf(entry->buffer, entry->size, format, copy);
+				va_end(copy);
+				const int res = length < 0 || static_cast<size_t>(length) < entry->size ? length : -1;
+#endif
 				if (res > 0) break; // Success
 				if (res == 0) return nullptr; // Error
 
@@ -78,16 +91,119 @@ namespace utils::string
 
 	const char* va(const char* fmt, ...);
 
+	// Splits lazily into views of the original text, producing the same tokens as split:
+	// empty tokens are kept, except for a single trailing one
+	class split_view final
+	{
+	public:
+		class iterator final
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = std::string_view;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const std::string_view*;
+			using reference = const std::string_view&;
+
+			iterator() = default;
+
+			iterator(const std::string_view text, const char delim)
+				: rest_(text), delim_(delim), end_(false)
+			{
+				this->advance();
+			}
+
+			reference operator*() const { return this->token_; }
+			pointer operator->() const { return &this->token_; }
+
+			iterator& operator++()
+			{
+				this->advance();
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				auto copy = *this;
+				this->advance();
+				return copy;
+			}
+
+			bool operator==(const iterator& other) const
+			{
+				if (this->end_ || other.end_)
+				{
+					return this->end_ == other.end_;
+				}
+
+				return this->token_.data() == other.token_.data() && this->token_.size() == other.token_.size();
+			}
+
+		private:
+			std::string_view rest_{};
+			std::string_view token_{};
+			char delim_{};
+			bool end_{true};
+
+			void advance()
+			{
+				if (this->rest_.empty())
+				{
+					this->end_ = true;
+					return;
+				}
+
+				const auto pos = this->rest_.find(this->delim_);
+				if (pos == std::string_view::npos)
+				{
+					this->token_ = this->rest_;
+					this->rest_ = {};
+					return;
+				}
+
+				this->token_ = this->rest_.substr(0, pos);
+				this->rest_ = this->rest_.substr(pos + 1);
+			}
+		};
+
+		split_view(const std::string_view text, const char delim)
+			: text_(text), delim_(delim)
+		{
+		}
+
+		[[nodiscard]] iterator begin() const { return {this->text_, this->delim_}; }
+		[[nodiscard]] iterator end() const { return {}; }
+
+	private:
+		std::string_view text_;
+		char delim_;
+	};
+
 	std::vector<std::string> split(const std::string& s, char delim);
+	std::vector<std::string> split(std::string_view s, char delim);
+	std::vector<std::string> split(const char* s, char delim);
 
 	std::string to_lower(const std::string& text);
+	std::string to_lower(std::string_view text);
+	std::string to_lower(const char* text);
 	std::string to_upper(const std::string& text);
+	std::string to_upper(std::string_view text);
+	std::string to_upper(const char* text);
+	void to_lower_inplace(std::string& text);
+	void to_upper_inplace(std::string& text);
+
 	bool starts_with(const std::string& text, const std::string& substring);
+	bool starts_with(std::string_view text, std::string_view substring);
+	bool starts_with(const char* text, const char* substring);
 	bool ends_with(const std::string& text, const std::string& substring);
+	bool ends_with(std::string_view text, std::string_view substring);
+	bool ends_with(const char* text, const char* substring);
 
 	std::string dump_hex(const std::string& data, const std::string& separator = " ");
 
+#ifdef _WIN32
 	std::string get_clipboard_data();
+#endif
 
 	void strip(const char* in, char* out, size_t max);
 
@@ -95,4 +211,7 @@ namespace utils::string
 	std::wstring convert(const std::string& str);
 
 	std::string replace(std::string str, const std::string& from, const std::string& to);
+
+	// Encloses a CSV field in quotes and doubles the quotes inside
+	std::string quote_csv(std::string_view field);
 }
@@ -0,0 +1,276 @@
+#include "transaction.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include "nt.hpp"
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace utils::hook
+{
+	namespace
+	{
+		thread_local transaction* active_transaction = nullptr;
+
+		class native_protection_backend final : public protection_backend
+		{
+		public:
+#ifdef _WIN32
+			size_t get_page_size() override
+			{
+				SYSTEM_INFO info{};
+				GetSystemInfo(&info);
+				return info.dwPageSize;
+			}
+
+			bool unprotect(void* address, const size_t length, uint32_t* old_protection) override
+			{
+				DWORD protection{};
+				if (!VirtualProtect(address, length, PAGE_EXECUTE_READWRITE, &protection))
+				{
+					return false;
+				}
+
+				*old_protection = protection;
+				return true;
+			}
+
+			void restore(void* address, const size_t length, const uint32_t old_protection) override
+			{
+				DWORD protection{};
+				VirtualProtect(address, length, old_protection, &protection);
+			}
+
+			void flush(void* address, const size_t length) override
+			{
+				FlushInstructionCache(GetCurrentProcess(), address, length);
+			}
+#else
+			size_t get_page_size() override
+			{
+				return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			}
+
+			bool unprotect(void* address, const size_t length, uint32_t* old_protection) override
+			{
+				// mprotect can't report the previous protection, patched memory is assumed to be code
+				*old_protection = PROT_READ | PROT_EXEC;
+				return mprotect(this->align(address), this->span(address, length), PROT_READ | PROT_WRITE | PROT_EXEC)
+					== 0;
+			}
+
+			void restore(void* address, const size_t length, const uint32_t old_protection) override
+			{
+				mprotect(this->align(address), this->span(address, length), static_cast<int>(old_protection));
+			}
+
+			void flush(void* address, const size_t length) override
+			{
+				auto* const begin = static_cast<char*>(address);
+				__builtin___clear_cache(begin, begin + length);
+			}
+
+		private:
+			void* align(void* address)
+			{
+				return reinterpret_cast<void*>(reinterpret_cast<size_t>(address) & ~(this->get_page_size() - 1));
+			}
+
+			size_t span(void* address, const size_t length)
+			{
+				return (reinterpret_cast<size_t>(address) + length) - reinterpret_cast<size_t>(this->align(address));
+			}
+#endif
+		};
+	}
+
+	protection_backend& get_native_protection_backend()
+	{
+		static native_protection_backend backend{};
+		return backend;
+	}
+
+	transaction::transaction(protection_backend& backend)
+		: backend_(&backend), previous_(active_transaction), uncaught_exceptions_(std::uncaught_exceptions())
+	{
+		active_transaction = this;
+	}
+
+	transaction::~transaction() noexcept
+	{
+		// Only unwinding may skip the commit, anything else is a forgotten commit() call
+		assert(this->committed_ || this->patches_.empty() || std::uncaught_exceptions() > this->uncaught_exceptions_);
+
+		if (!this->committed_)
+		{
+			this->patches_.clear();
+		}
+
+		this->deactivate();
+	}
+
+	void transaction::write(void* place, const void* data, const size_t length)
+	{
+		if (this->committed_)
+		{
+			throw std::runtime_error("Transaction was already committed");
+		}
+
+		if (!length)
+		{
+			return;
+		}
+
+		const auto* const bytes = static_cast<const uint8_t*>(data);
+		this->patches_.push_back(patch{static_cast<uint8_t*>(place), {bytes, bytes + length}, {}});
+	}
+
+	void transaction::commit()
+	{
+		if (this->committed_)
+		{
+			return;
+		}
+
+		this->deactivate();
+		this->apply(false);
+		this->committed_ = true;
+	}
+
+	void transaction::rollback()
+	{
+		if (!this->committed_)
+		{
+			this->patches_.clear();
+			this->deactivate();
+			this->committed_ = true;
+			return;
+		}
+
+		this->apply(true);
+		this->patches_.clear();
+	}
+
+	size_t transaction::size() const
+	{
+		return this->patches_.size();
+	}
+
+	bool transaction::is_committed() const
+	{
+		return this->committed_;
+	}
+
+	transaction* transaction::get_active()
+	{
+		return active_transaction;
+	}
+
+	void transaction::deactivate()
+	{
+		if (!this->active_)
+		{
+			return;
+		}
+
+		this->active_ = false;
+
+		if (active_transaction == this)
+		{
+			active_transaction = this->previous_;
+		}
+	}
+
+	void transaction::apply(const bool restore_original)
+	{
+		if (this->patches_.empty())
+		{
+			return;
+		}
+
+		const auto page_size = this->backend_->get_page_size();
+
+		std::vector<size_t> pages{};
+		auto lowest = reinterpret_cast<size_t>(this->patches_.front().place);
+		auto highest = lowest;
+
+		for (const auto& patch : this->patches_)
+		{
+			const auto start = reinterpret_cast<size_t>(patch.place);
+			const auto end = start + patch.data.size();
+
+			lowest = std::min(lowest, start);
+			highest = std::max(highest, end);
+
+			for (auto page = start & ~(page_size - 1); page < end; page += page_size)
+			{
+				pages.push_back(page);
+			}
+		}
+
+		std::sort(pages.begin(), pages.end());
+		pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+		// Pages can have different protections, so each one keeps its own
+		std::vector<uint32_t> protections(pages.size());
+		for (size_t i = 0; i < pages.size(); ++i)
+		{
+			if (!this->backend_->unprotect(reinterpret_cast<void*>(pages[i]), page_size, &protections[i]))
+			{
+				for (size_t j = 0; j < i; ++j)
+				{
+					this->backend_->restore(reinterpret_cast<void*>(pages[j]), page_size, protections[j]);
+				}
+
+				throw std::runtime_error("Unable to unprotect memory for patching");
+			}
+		}
+
+		if (restore_original)
+		{
+			for (auto patch = this->patches_.rbegin(); patch != this->patches_.rend(); ++patch)
+			{
+				std::memmove(patch->place, patch->original.data(), patch->original.size());
+			}
+		}
+		else
+		{
+			for (auto& patch : this->patches_)
+			{
+				patch.original.assign(patch.place, patch.place + patch.data.size());
+				std::memmove(patch.place, patch.data.data(), patch.data.size());
+			}
+		}
+
+		for (size_t i = 0; i < pages.size(); ++i)
+		{
+			this->backend_->restore(reinterpret_cast<void*>(pages[i]), page_size, protections[i]);
+		}
+
+		this->backend_->flush(reinterpret_cast<void*>(lowest), highest - lowest);
+	}
+
+	void write_memory(void* place, const void* data, const size_t length)
+	{
+		if (auto* const active = transaction::get_active())
+		{
+			active->write(place, data, length);
+			return;
+		}
+
+		auto& backend = get_native_protection_backend();
+
+		uint32_t old_protection{};
+		backend.unprotect(place, length, &old_protection);
+		std::memmove(place, data, length);
+		backend.restore(place, length, old_protection);
+		backend.flush(place, length);
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils::hook
+{
+	// Changes page protections for memory patches
+	// The native backend uses VirtualProtect on Windows and mprotect elsewhere
+	class protection_backend
+	{
+	public:
+		virtual ~protection_backend() = default;
+
+		virtual size_t get_page_size() = 0;
+		virtual bool unprotect(void* address, size_t length, uint32_t* old_protection) = 0;
+		virtual void restore(void* address, size_t length, uint32_t old_protection) = 0;
+		virtual void flush(void* address, size_t length) = 0;
+	};
+
+	protection_backend& get_native_protection_backend();
+
+	// Collects memory writes while it is active on the current thread and applies
+	// them at once: every touched page is unprotected and restored a single time
+	// and the instruction cache is flushed once.
+	// The original bytes are recorded, so a committed transaction can be rolled back.
+	// Reads of patched memory don't see pending writes until the transaction is committed.
+	// Nothing is applied without an explicit commit, a transaction that is destroyed before
+	// that (e.g. while an exception unwinds halfway through a patch set) discards its writes.
+	class transaction final
+	{
+	public:
+		explicit transaction(protection_backend& backend = get_native_protection_backend());
+		~transaction() noexcept;
+
+		transaction(const transaction&) = delete;
+		transaction& operator=(const transaction&) = delete;
+
+		void write(void* place, const void* data, size_t length);
+
+		void commit();
+		void rollback();
+
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool is_committed() const;
+
+		static transaction* get_active();
+
+	private:
+		struct patch
+		{
+			uint8_t* place;
+			std::vector<uint8_t> data;
+			std::vector<uint8_t> original;
+		};
+
+		protection_backend* backend_;
+		std::vector<patch> patches_;
+		transaction* previous_;
+		int uncaught_exceptions_;
+		bool active_{true};
+		bool committed_{false};
+
+		void deactivate();
+		void apply(bool restore_original);
+	};
+
+	// Writes through the active transaction if there is one, otherwise right away
+	void write_memory(void* place, const void* data, size_t length);
+}
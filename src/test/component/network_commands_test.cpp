@@ -0,0 +1,137 @@
+#include "test.hpp"
+
+#include <component/network_commands.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+	// Every command of the same length collides
+	network::command_hash hash_length(const char* command, size_t* length)
+	{
+		*length = std::strlen(command);
+		return *length;
+	}
+
+	std::string to_lower(std::string text)
+	{
+		std::ranges::transform(text, text.begin(), [](const char c)
+		{
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		});
+
+		return text;
+	}
+
+	template <typename Lookup>
+	void measure_dispatch(const char* name, const std::vector<std::string>& packets, Lookup&& lookup)
+	{
+		constexpr auto rounds = 250;
+
+		size_t total = 0;
+		const auto start = std::chrono::steady_clock::now();
+
+		for (auto round = 0; round < rounds; ++round)
+		{
+			for (const auto& packet : packets)
+			{
+				total += lookup(packet.data());
+			}
+		}
+
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		test::keep(total);
+
+		std::printf("  %-28s %6.1f M packets/s\n", name, static_cast<double>(packets.size()) * rounds / seconds / 1e6);
+	}
+
+	const char* commands[] = {
+		"getInfo", "infoResponse", "getStatus", "statusResponse", "getServersResponse", "getbotsResponse", "rcon",
+		"print", "connectResponse", "challengeResponse", "disconnect", "error", "updateResponse", "keyAuthorize",
+		"getchallenge", "connect", "ipAuthorize", "heartbeat", "loadingNewMap", "fastRestart",
+	};
+}
+
+TEST_CASE(network_commands_find_commands)
+{
+	network::command_table<int> table{};
+	table.add("getInfo", 1);
+	table.add("infoResponse", 2);
+
+	size_t length{};
+	const auto* handler = table.find("GETINFO", &length);
+	CHECK(handler && *handler == 1);
+	CHECK(length == 7);
+
+	handler = table.find("inforesponse", &length);
+	CHECK(handler && *handler == 2);
+
+	CHECK(!table.find("getInf", &length));
+	CHECK(length == 6);
+	CHECK(!table.find("getInfos", &length));
+	CHECK(!table.find("", &length));
+	CHECK(length == 0);
+
+	// The same command again replaces the handler
+	table.add("GetInfo", 3);
+	handler = table.find("getinfo", &length);
+	CHECK(handler && *handler == 3);
+	CHECK(table.size() == 2);
+}
+
+TEST_CASE(network_commands_reject_hash_collisions)
+{
+	network::command_table<int, hash_length> table{};
+	table.add("rcon", 1);
+
+	// Another command with the same hash can't replace the first one
+	CHECK_THROWS(table.add("ping", 2));
+
+	size_t length{};
+	const auto* handler = table.find("RCON", &length);
+	CHECK(handler && *handler == 1);
+
+	// And an incoming command that only shares the hash doesn't reach it
+	CHECK(!table.find("ping", &length));
+
+	table.add("rcon", 3);
+	handler = table.find("rcon", &length);
+	CHECK(handler && *handler == 3);
+}
+
+BENCHMARK(network_commands_benchmark)
+{
+	network::command_table<size_t> table{};
+	std::unordered_map<std::string, size_t> by_name{};
+
+	for (size_t i = 0; i < std::size(commands); ++i)
+	{
+		table.add(commands[i], i);
+
+		by_name[to_lower(commands[i])] = i;
+	}
+
+	// Mostly known commands as they arrive on a busy server, with a few unknown ones
+	std::vector<std::string> packets;
+	for (size_t i = 0; i < 4096; ++i)
+	{
+		packets.emplace_back(i % 16 == 0 ? "unknownCommand" + std::to_string(i) : commands[(i * 7) % std::size(commands)]);
+	}
+
+	measure_dispatch("hash table", packets, [&table](const char* command)
+	{
+		size_t length{};
+		const auto* handler = table.find(command, &length);
+		return handler ? *handler : length;
+	});
+
+	// What dispatching did before the hash table
+	measure_dispatch("lowercase copy + string map", packets, [&by_name](const char* command)
+	{
+		const auto name = to_lower(command);
+		const auto entry = by_name.find(name);
+		return entry != by_name.end() ? entry->second : name.size();
+	});
+}
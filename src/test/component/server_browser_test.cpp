@@ -0,0 +1,235 @@
+#include "test.hpp"
+
+#include <component/server_browser.hpp>
+
+#include <random>
+
+namespace
+{
+	struct test_server
+	{
+		int clients{};
+		int max_clients{};
+		int ping{};
+		std::string host_name;
+		std::string map_name;
+		std::string game_type;
+		uint64_t order{};
+	};
+
+	using test_model = server_list::browser_model<test_server>;
+
+	test_server make_server(const std::string& host_name, const int clients, const int ping, const int max_clients = 18)
+	{
+		test_server server{};
+		server.host_name = host_name;
+		server.clients = clients;
+		server.max_clients = max_clients;
+		server.ping = ping;
+		server.map_name = "mp_" + host_name;
+		server.game_type = host_name.substr(0, 1);
+		return server;
+	}
+
+	test_server make_random_server(std::mt19937& random)
+	{
+		static const char* maps[] = {"mp_refraction", "mp_lab2", "mp_comeback", "mp_greenband", "mp_levity", "mp_prison"};
+		static const char* game_types[] = {"war", "dom", "conf", "sd", "ctf", "hp"};
+
+		test_server server{};
+		server.max_clients = 6 + static_cast<int>(random() % 13);
+		server.clients = static_cast<int>(random() % (server.max_clients + 1));
+		server.ping = static_cast<int>(random() % 300);
+		server.host_name = "Server " + std::to_string(random() % 100000);
+		server.map_name = maps[random() % std::size(maps)];
+		server.game_type = game_types[random() % std::size(game_types)];
+		return server;
+	}
+
+	std::vector<std::string> get_host_names(const test_model& model)
+	{
+		std::vector<std::string> names;
+		for (const auto& server : model.get_visible())
+		{
+			names.push_back(server->host_name);
+		}
+
+		return names;
+	}
+
+	// The visible list a full filter and sort over every server would give
+	test_model::view get_expected(const test_model& model)
+	{
+		test_model::view expected;
+		for (const auto& server : model.get_servers())
+		{
+			if (server_list::is_visible(*server, model.get_options()))
+			{
+				expected.push_back(server);
+			}
+		}
+
+		const auto key = model.get_options().sort;
+		std::ranges::stable_sort(expected, [key](const test_model::entry& a, const test_model::entry& b)
+		{
+			return server_list::compare_servers(*a, *b, key);
+		});
+
+		return expected;
+	}
+}
+
+TEST_CASE(server_browser_sorts_servers)
+{
+	test_model model{};
+	model.insert(make_server("b", 4, 80));
+	model.insert(make_server("a", 10, 120));
+	model.insert(make_server("d", 4, 30));
+	model.insert(make_server("c", 4, 80));
+
+	// Most players first, then the lowest ping, then arrival order
+	CHECK((get_host_names(model) == std::vector<std::string>{"a", "d", "b", "c"}));
+
+	model.set_options({server_list::sort_key::ping});
+	CHECK((get_host_names(model) == std::vector<std::string>{"d", "b", "c", "a"}));
+
+	model.set_options({server_list::sort_key::host_name});
+	CHECK((get_host_names(model) == std::vector<std::string>{"a", "b", "c", "d"}));
+
+	// Inserted in place under the current sort
+	model.insert(make_server("bb", 0, 999));
+	CHECK((get_host_names(model) == std::vector<std::string>{"a", "b", "bb", "c", "d"}));
+
+	model.set_options({server_list::sort_key::game_type});
+	CHECK((get_host_names(model) == std::vector<std::string>{"a", "b", "bb", "c", "d"}));
+}
+
+TEST_CASE(server_browser_filters_servers)
+{
+	test_model model{};
+	model.insert(make_server("full", 18, 50));
+	model.insert(make_server("empty", 0, 20));
+	model.insert(make_server("some", 5, 40));
+	model.insert(make_server("over", 20, 60, 18));
+
+	CHECK(model.get_visible().size() == 4);
+
+	model.set_options({server_list::sort_key::ping, true, false});
+	CHECK((get_host_names(model) == std::vector<std::string>{"empty", "some"}));
+
+	model.set_options({server_list::sort_key::ping, false, true});
+	CHECK((get_host_names(model) == std::vector<std::string>{"some", "full", "over"}));
+
+	model.set_options({server_list::sort_key::ping, true, true});
+	CHECK((get_host_names(model) == std::vector<std::string>{"some"}));
+
+	// Filtered servers are kept, but not inserted into the visible list
+	model.insert(make_server("another_empty", 0, 1));
+	model.insert(make_server("another", 1, 100));
+	CHECK((get_host_names(model) == std::vector<std::string>{"some", "another"}));
+	CHECK(model.get_servers().size() == 6);
+
+	model.set_options({});
+	CHECK(model.get_visible().size() == 6);
+	CHECK(model.get_visible().front()->host_name == "over");
+}
+
+TEST_CASE(server_browser_tracks_changes)
+{
+	test_model model{};
+	CHECK(!model.consume_changes());
+
+	model.insert(make_server("a", 1, 10));
+	CHECK(model.consume_changes());
+	CHECK(!model.consume_changes());
+
+	// Hidden servers and unchanged options don't touch the visible list
+	model.set_options({server_list::sort_key::players, false, true});
+	CHECK(model.consume_changes());
+	model.insert(make_server("empty", 0, 10));
+	model.set_options({server_list::sort_key::players, false, true});
+	CHECK(!model.consume_changes());
+
+	model.clear();
+	CHECK(model.consume_changes());
+	CHECK(model.get_servers().empty());
+	CHECK(model.get_visible().empty());
+
+	model.insert(make_server("b", 1, 10));
+	CHECK(model.get_servers().front()->order == 0);
+}
+
+TEST_CASE(server_browser_insertion_matches_a_full_sort)
+{
+	std::mt19937 random(1);
+
+	for (auto key = 0; key < static_cast<int>(server_list::sort_key::count); ++key)
+	{
+		for (const auto hide : {0, 1, 2, 3})
+		{
+			const server_list::browser_options options{static_cast<server_list::sort_key>(key), (hide & 1) != 0, (hide & 2) != 0};
+
+			test_model model{};
+			model.set_options(options);
+
+			for (auto i = 0; i < 500; ++i)
+			{
+				model.insert(make_random_server(random));
+			}
+
+			CHECK(model.get_visible() == get_expected(model));
+		}
+	}
+}
+
+BENCHMARK(server_browser_benchmark)
+{
+	constexpr auto server_count = 5000;
+
+	std::mt19937 random(2);
+	std::vector<test_server> servers;
+	for (auto i = 0; i < server_count; ++i)
+	{
+		servers.emplace_back(make_random_server(random));
+	}
+
+	static const char* key_names[] = {"players", "ping", "host_name", "map_name", "game_type"};
+
+	for (auto key = 0; key < static_cast<int>(server_list::sort_key::count); ++key)
+	{
+		const server_list::browser_options options{static_cast<server_list::sort_key>(key)};
+
+		test_model model{};
+		model.set_options(options);
+
+		auto start = std::chrono::steady_clock::now();
+		for (auto server : servers)
+		{
+			model.insert(std::move(server));
+		}
+
+		const auto insert_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// Sorting everything again after every insert, like a list without sorted insertion would
+		test_model::view resorted;
+		start = std::chrono::steady_clock::now();
+		for (const auto& server : model.get_servers())
+		{
+			resorted.push_back(server);
+			std::ranges::stable_sort(resorted, [&options](const test_model::entry& a, const test_model::entry& b)
+			{
+				return server_list::compare_servers(*a, *b, options.sort);
+			});
+		}
+
+		const auto resort_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// A rebuild after the sort or filter dvars changed
+		start = std::chrono::steady_clock::now();
+		model.set_options({options.sort, true, true});
+		const auto rebuild_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::printf("  %-10s %d inserts: %6.2f ms (resorting every insert %8.1f ms), rebuild %5.2f ms\n",
+		            key_names[key], server_count, insert_time, resort_time, rebuild_time);
+	}
+}
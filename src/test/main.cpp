@@ -0,0 +1,73 @@
+#include "test.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+namespace test
+{
+	std::vector<test_case>& get_test_cases()
+	{
+		static std::vector<test_case> test_cases;
+		return test_cases;
+	}
+
+	void fail(const char* file, const int line, const std::string& message)
+	{
+		char buffer[512]{};
+		std::snprintf(buffer, sizeof(buffer), "%s:%d: %s", file, line, message.data());
+		throw failure(buffer);
+	}
+}
+
+// Usage: tests [--bench] [filter]
+// Runs every test whose name contains the filter, and the benchmarks as well with --bench
+int main(const int argc, char** argv)
+{
+	auto run_benchmarks = false;
+	const char* filter = "";
+
+	for (auto i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+		{
+			run_benchmarks = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	auto passed = 0;
+	auto failed = 0;
+
+	for (const auto& test_case : test::get_test_cases())
+	{
+		if ((test_case.benchmark && !run_benchmarks) || !std::strstr(test_case.name, filter))
+		{
+			continue;
+		}
+
+		std::printf("%s\n", test_case.name);
+
+		try
+		{
+			test_case.function();
+			++passed;
+		}
+		catch (const test::failure& e)
+		{
+			std::printf("  FAILED %s\n", e.what());
+			++failed;
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("  FAILED unexpected exception: %s\n", e.what());
+			++failed;
+		}
+	}
+
+	std::printf("%d passed, %d failed\n", passed, failed);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Stand-in for the client's precompiled header, so client units that
+// don't depend on Windows or the game can be built into the tests
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <gsl/gsl>
+
+using namespace std::literals;
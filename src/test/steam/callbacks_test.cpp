@@ -0,0 +1,214 @@
+#include "test.hpp"
+
+#include <std_include.hpp>
+#include <steam/callbacks.hpp>
+
+#include <memory>
+
+namespace
+{
+	class test_handler final : public steam::callbacks::base
+	{
+	public:
+		using callback = std::function<void(test_handler&, void*)>;
+
+		test_handler(callback function = {})
+			: callback_(std::move(function))
+		{
+		}
+
+		void run(void* pv_param) override
+		{
+			this->run(pv_param, false, 0);
+		}
+
+		void run(void* pv_param, bool /*failure*/, uint64_t /*handle*/) override
+		{
+			++this->calls;
+			if (this->callback_)
+			{
+				this->callback_(*this, pv_param);
+			}
+		}
+
+		int get_callback_size_bytes() override
+		{
+			return sizeof(int);
+		}
+
+		size_t calls{};
+
+	private:
+		callback callback_;
+	};
+
+	void post(const int type, const int value, const uint64_t call = 0)
+	{
+		auto* data = static_cast<int*>(steam::callbacks::allocate_result(sizeof(int)));
+		*data = value;
+		steam::callbacks::return_call(data, sizeof(int), type, call);
+	}
+}
+
+TEST_CASE(callbacks_dispatch_results_in_order)
+{
+	constexpr auto type = 1001;
+
+	std::vector<int> values;
+	test_handler handler([&values](test_handler&, void* data)
+	{
+		values.push_back(*static_cast<int*>(data));
+	});
+
+	size_t call_results = 0;
+	test_handler call_result([&call_results](test_handler&, void*)
+	{
+		++call_results;
+	});
+
+	steam::callbacks::register_callback(&handler, type);
+
+	const auto call = steam::callbacks::register_call();
+	steam::callbacks::register_call_result(call, &call_result);
+
+	// More than the queue holds, the rest goes through the overflow list
+	for (auto i = 0; i < 0x5000; ++i)
+	{
+		post(type, i, i == 0 ? call : 0);
+	}
+
+	steam::callbacks::run_callbacks();
+
+	CHECK(values.size() == 0x5000);
+	for (auto i = 0; i < static_cast<int>(values.size()); ++i)
+	{
+		CHECK(values[i] == i);
+	}
+
+	CHECK(call_results == 1);
+
+	steam::callbacks::unregister_call_result(call, &call_result);
+	steam::callbacks::unregister_callback(&handler);
+
+	post(type, 0, call);
+	steam::callbacks::run_callbacks();
+	CHECK(handler.calls == 0x5000);
+	CHECK(call_results == 1);
+}
+
+TEST_CASE(callbacks_unregister_during_dispatch)
+{
+	constexpr auto type = 1002;
+
+	test_handler later{};
+	test_handler added{};
+	test_handler second{};
+
+	// Removes itself and a handler that wasn't called yet, and adds a new one
+	test_handler first([&](test_handler& self, void*)
+	{
+		steam::callbacks::unregister_callback(&self);
+		steam::callbacks::unregister_callback(&later);
+		steam::callbacks::register_callback(&added, type);
+	});
+
+	steam::callbacks::register_callback(&first, type);
+	steam::callbacks::register_callback(&second, type);
+	steam::callbacks::register_callback(&later, type);
+
+	post(type, 1);
+	post(type, 2);
+	steam::callbacks::run_callbacks();
+
+	// The second result no longer reaches the removed handlers, the added one only sees it
+	CHECK(first.calls == 1);
+	CHECK(second.calls == 2);
+	CHECK(later.calls == 0);
+	CHECK(added.calls == 1);
+
+	post(type, 3);
+	steam::callbacks::run_callbacks();
+
+	CHECK(first.calls == 1);
+	CHECK(second.calls == 3);
+	CHECK(later.calls == 0);
+	CHECK(added.calls == 2);
+
+	steam::callbacks::unregister_callback(&second);
+	steam::callbacks::unregister_callback(&added);
+
+	post(type, 4);
+	steam::callbacks::run_callbacks();
+	CHECK(second.calls == 3);
+	CHECK(added.calls == 2);
+}
+
+TEST_CASE(callbacks_unregister_others_from_another_type)
+{
+	constexpr auto type = 1003;
+	constexpr auto other_type = 1004;
+
+	test_handler other{};
+	test_handler remover([&other](test_handler&, void*)
+	{
+		steam::callbacks::unregister_callback(&other);
+	});
+
+	steam::callbacks::register_callback(&remover, type);
+	steam::callbacks::register_callback(&other, other_type);
+
+	post(type, 1);
+	post(other_type, 2);
+	steam::callbacks::run_callbacks();
+
+	CHECK(remover.calls == 1);
+	CHECK(other.calls == 0);
+
+	steam::callbacks::unregister_callback(&remover);
+}
+
+BENCHMARK(callbacks_benchmark)
+{
+	// 1,000 handlers spread over 100 callback types, like the interfaces and components register them
+	constexpr auto handler_count = 1000;
+	constexpr auto type_count = 100;
+	constexpr auto results_per_frame = 10000;
+	constexpr auto first_type = 2000;
+
+	std::vector<std::unique_ptr<test_handler>> handlers;
+	for (auto i = 0; i < handler_count; ++i)
+	{
+		handlers.emplace_back(std::make_unique<test_handler>());
+		steam::callbacks::register_callback(handlers.back().get(), first_type + i % type_count);
+	}
+
+	std::vector<double> frames;
+	for (auto frame = 0; frame < 50; ++frame)
+	{
+		for (auto i = 0; i < results_per_frame; ++i)
+		{
+			post(first_type + i % type_count, i);
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		steam::callbacks::run_callbacks();
+		frames.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	std::sort(frames.begin(), frames.end());
+
+	size_t calls = 0;
+	for (const auto& handler : handlers)
+	{
+		calls += handler->calls;
+		steam::callbacks::unregister_callback(handler.get());
+	}
+
+	std::printf("  %d handlers, %d results per frame: p50 %.1f us, p99 %.1f us per frame (%zu handler calls)\n",
+	            handler_count, results_per_frame, frames[frames.size() / 2], frames[frames.size() * 99 / 100], calls);
+
+	test::measure("allocate_result + free_result", []
+	{
+		steam::callbacks::free_result(steam::callbacks::allocate_result(sizeof(int)));
+	});
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace test
+{
+	struct test_case
+	{
+		const char* name;
+		void (*function)();
+		bool benchmark;
+	};
+
+	std::vector<test_case>& get_test_cases();
+
+	class registrar final
+	{
+	public:
+		registrar(const char* name, void (*function)(), const bool benchmark)
+		{
+			get_test_cases().push_back({name, function, benchmark});
+		}
+	};
+
+	class failure final : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	[[noreturn]] void fail(const char* file, int line, const std::string& message);
+
+	inline volatile const void* keep_sink;
+
+	// Keeps the optimizer from dropping a result that is otherwise unused
+	template <typename T>
+	void keep(T&& value)
+	{
+		keep_sink = &value;
+	}
+
+	// Runs the function in batches until it took at least the given time and prints the time per call
+	template <typename Function>
+	void measure(const char* name, Function&& function,
+	             const std::chrono::nanoseconds min_duration = std::chrono::milliseconds(200))
+	{
+		using clock = std::chrono::steady_clock;
+		constexpr uint64_t batch_size = 64;
+
+		uint64_t iterations = 0;
+		const auto start = clock::now();
+		auto elapsed = clock::duration::zero();
+
+		do
+		{
+			for (uint64_t i = 0; i < batch_size; ++i)
+			{
+				function();
+			}
+
+			iterations += batch_size;
+			elapsed = clock::now() - start;
+		}
+		while (elapsed < min_duration);
+
+		const auto nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count();
+		std::printf("  %-48s %12.1f ns/op (%llu runs)\n", name, nanoseconds / static_cast<double>(iterations),
+		            static_cast<unsigned long long>(iterations));
+	}
+}
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+
+#define TEST_REGISTER(name, benchmark) \
+	static void name(); \
+	static test::registrar TEST_CONCAT(name, _registrar){#name, name, benchmark}; \
+	static void name()
+
+// Run on every invocation
+#define TEST_CASE(name) TEST_REGISTER(name, false)
+
+// Only run with --bench
+#define BENCHMARK(name) TEST_REGISTER(name, true)
+
+#define CHECK(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			test::fail(__FILE__, __LINE__, #expression); \
+		} \
+	} \
+	while (false)
+
+#define CHECK_THROWS(expression) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			expression; \
+		} \
+		catch (...) \
+		{ \
+			thrown = true; \
+		} \
+		if (!thrown) \
+		{ \
+			test::fail(__FILE__, __LINE__, "expected an exception: " #expression); \
+		} \
+	} \
+	while (false)
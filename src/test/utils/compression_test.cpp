@@ -0,0 +1,552 @@
+#include "test.hpp"
+
+#include <utils/compression.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include <zlib.h>
+
+namespace
+{
+	struct zip_entry
+	{
+		std::string name;
+		uint16_t version{};
+		uint16_t extra_length{};
+		std::string data;
+	};
+
+	uint16_t read_u16(const std::string& data, const size_t offset)
+	{
+		return static_cast<uint16_t>(static_cast<uint8_t>(data.at(offset)) | static_cast<uint8_t>(data.at(offset + 1)) << 8);
+	}
+
+	uint32_t read_u32(const std::string& data, const size_t offset)
+	{
+		return read_u16(data, offset) | static_cast<uint32_t>(read_u16(data, offset + 2)) << 16;
+	}
+
+	uint64_t read_u64(const std::string& data, const size_t offset)
+	{
+		return read_u32(data, offset) | static_cast<uint64_t>(read_u32(data, offset + 4)) << 32;
+	}
+
+	std::string inflate_raw(const std::string& data, const size_t size)
+	{
+		std::string result(size, '\0');
+
+		z_stream stream{};
+		inflateInit2(&stream, -MAX_WBITS);
+		stream.next_in = reinterpret_cast<const Bytef*>(data.data());
+		stream.avail_in = static_cast<uInt>(data.size());
+		stream.next_out = reinterpret_cast<Bytef*>(result.data());
+		stream.avail_out = static_cast<uInt>(result.size());
+
+		const auto ret = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+
+		CHECK(ret == Z_STREAM_END);
+		return result;
+	}
+
+	// Walks the local file headers, which is enough for archives written in one pass
+	std::vector<zip_entry> read_zip(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		const std::string archive{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+		std::vector<zip_entry> entries;
+		size_t offset = 0;
+
+		while (offset + 30 <= archive.size() && read_u32(archive, offset) == 0x04034b50)
+		{
+			zip_entry entry{};
+			entry.version = read_u16(archive, offset + 4);
+
+			uint64_t compressed_size = read_u32(archive, offset + 18);
+			uint64_t size = read_u32(archive, offset + 22);
+
+			const auto name_length = read_u16(archive, offset + 26);
+			entry.extra_length = read_u16(archive, offset + 28);
+			entry.name = archive.substr(offset + 30, name_length);
+
+			const auto extra = offset + 30 + name_length;
+			if (compressed_size == 0xFFFFFFFF && entry.extra_length >= 20 && read_u16(archive, extra) == 1)
+			{
+				size = read_u64(archive, extra + 4);
+				compressed_size = read_u64(archive, extra + 12);
+			}
+
+			const auto data = extra + entry.extra_length;
+			entry.data = inflate_raw(archive.substr(data, compressed_size), size);
+			entries.emplace_back(std::move(entry));
+
+			offset = data + compressed_size;
+		}
+
+		return entries;
+	}
+
+	std::filesystem::path get_temp_path(const std::string& name)
+	{
+		return std::filesystem::temp_directory_path() / ("s1x_test_" + name);
+	}
+
+	// Log-like lines with varying numbers, they deflate about as well as the files a server archives
+	std::string generate_text(const size_t size, uint32_t seed)
+	{
+		static const char* words[] = {
+			"Kill", "Damage", "Weapon", "player", "spawned", "axis", "allies", "iw5_m4_mp", "iw5_acr_mp", "MOD_RIFLE_BULLET",
+			"MOD_HEAD_SHOT", "torso_upper", "head", "left_arm_lower", "score", "team", "connected", "disconnected",
+		};
+
+		std::string text;
+		text.reserve(size + 64);
+
+		while (text.size() < size)
+		{
+			seed = seed * 1664525 + 1013904223;
+			text.append(words[(seed >> 16) % std::size(words)]);
+			text.push_back(';');
+			text.append(std::to_string((seed >> 4) % 100000));
+			text.push_back((seed >> 8) % 6 ? ';' : '\n');
+		}
+
+		text.resize(size);
+		return text;
+	}
+
+	utils::compression::zlib::reader read_string(const std::string& data)
+	{
+		return [&data, offset = size_t(0)](uint8_t* buffer, const size_t size) mutable
+		{
+			const auto length = std::min(size, data.size() - offset);
+			std::memcpy(buffer, data.data() + offset, length);
+			offset += length;
+			return length;
+		};
+	}
+
+	std::string compress_in_chunks(const std::string& data, const size_t chunk_size)
+	{
+		std::string result;
+		utils::compression::zlib::deflate_stream stream([&result](const uint8_t* buffer, const size_t size)
+		{
+			result.append(reinterpret_cast<const char*>(buffer), size);
+			return true;
+		}, 6);
+
+		CHECK(stream.is_valid());
+
+		for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+		{
+			CHECK(stream.write(data.data() + offset, std::min(chunk_size, data.size() - offset)));
+		}
+
+		CHECK(stream.finish());
+		return result;
+	}
+
+	std::string decompress_in_chunks(const std::string& data, const size_t chunk_size)
+	{
+		std::string result;
+		utils::compression::zlib::inflate_stream stream([&result](const uint8_t* buffer, const size_t size)
+		{
+			result.append(reinterpret_cast<const char*>(buffer), size);
+			return true;
+		});
+
+		CHECK(stream.is_valid());
+
+		for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+		{
+			CHECK(stream.write(data.data() + offset, std::min(chunk_size, data.size() - offset)));
+		}
+
+		CHECK(stream.is_finished());
+		return result;
+	}
+
+	// The decompress before the size hint, which appended every 16 KB chunk to the result
+	std::string decompress_appending(const std::string& data)
+	{
+		z_stream stream{};
+		if (inflateInit(&stream) != Z_OK)
+		{
+			return {};
+		}
+
+		std::string buffer{};
+		uint8_t dest[CHUNK];
+		size_t offset = 0;
+		int ret{};
+
+		do
+		{
+			const auto input_size = std::min(sizeof(dest), data.size() - offset);
+			stream.avail_in = static_cast<uInt>(input_size);
+			stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
+			offset += stream.avail_in;
+
+			do
+			{
+				stream.avail_out = sizeof(dest);
+				stream.next_out = dest;
+
+				ret = inflate(&stream, Z_NO_FLUSH);
+				if (ret != Z_OK && ret != Z_STREAM_END)
+				{
+					inflateEnd(&stream);
+					return {};
+				}
+
+				buffer.append(reinterpret_cast<const char*>(dest), sizeof(dest) - stream.avail_out);
+			}
+			while (stream.avail_out == 0);
+		}
+		while (ret != Z_STREAM_END);
+
+		inflateEnd(&stream);
+		return buffer;
+	}
+
+	// Best of a few runs, in milliseconds
+	template <typename Function>
+	double time_best(const size_t runs, Function&& function)
+	{
+		auto best = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < runs; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			test::keep(function());
+			best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		return best;
+	}
+}
+
+TEST_CASE(archive_writer_keeps_entries_in_order)
+{
+	const auto path = get_temp_path("ordered.zip");
+	const auto source = get_temp_path("source.txt");
+
+	// Large entries first, so later small ones finish compressing before them
+	std::vector<std::pair<std::string, std::string>> files;
+	for (uint32_t i = 0; i < 24; ++i)
+	{
+		const auto size = i < 4 ? 0x400000 - i : 0x100 * i;
+		files.emplace_back("file_" + std::to_string(i) + ".txt", generate_text(size, i));
+	}
+
+	std::ofstream(source, std::ios::binary) << files[5].second;
+
+	{
+		utils::compression::zip::archive_writer writer(path.string(), 6, 4);
+		CHECK(writer.is_open());
+
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			auto& [name, data] = files[i];
+			if (i == 5)
+			{
+				writer.add_file(name, source.string());
+			}
+			else if (i % 3 == 0)
+			{
+				writer.add(name, read_string(data), data.size());
+			}
+			else if (i % 3 == 1)
+			{
+				writer.add(name, read_string(data));
+			}
+			else
+			{
+				writer.add(name, data);
+			}
+		}
+
+		CHECK(writer.finish());
+	}
+
+	const auto entries = read_zip(path);
+	CHECK(entries.size() == files.size());
+
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		CHECK(entries[i].name == files[i].first);
+		CHECK(entries[i].data == files[i].second);
+	}
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(source);
+}
+
+TEST_CASE(archive_stays_plain_zip_for_small_entries)
+{
+	const auto path = get_temp_path("plain.zip");
+
+	utils::compression::zip::archive archive{};
+	archive.add("a.txt", generate_text(1000, 1));
+	archive.add("b.txt", {});
+	CHECK(archive.write(path.string()));
+
+	const auto entries = read_zip(path);
+	CHECK(entries.size() == 2);
+
+	for (const auto& entry : entries)
+	{
+		CHECK(entry.version == 20);
+		CHECK(entry.extra_length == 0);
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(archive_writer_uses_zip64_for_unsized_readers)
+{
+	const auto path = get_temp_path("unsized.zip");
+	const auto data = generate_text(1000, 2);
+
+	{
+		utils::compression::zip::archive_writer writer(path.string());
+		writer.add("unsized.txt", read_string(data));
+		CHECK(writer.finish());
+	}
+
+	const auto entries = read_zip(path);
+	CHECK(entries.size() == 1);
+	CHECK(entries[0].version == 45);
+	CHECK(entries[0].data == data);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(archive_writer_rethrows_reader_errors)
+{
+	const auto path = get_temp_path("error.zip");
+	const auto data = generate_text(0x10000, 3);
+
+	utils::compression::zip::archive_writer writer(path.string(), 6, 2);
+	writer.add("before.txt", data);
+	writer.add("broken.txt", [calls = 0](uint8_t* buffer, const size_t size) mutable -> size_t
+	{
+		if (++calls > 2)
+		{
+			throw std::runtime_error("read failed");
+		}
+
+		std::memset(buffer, 'x', size);
+		return size;
+	});
+	writer.add("after.txt", data);
+
+	CHECK_THROWS(writer.finish());
+
+	// The error is only reported once, the archive stays marked as failed
+	CHECK(!writer.finish());
+
+	const auto entries = read_zip(path);
+	CHECK(!entries.empty());
+	CHECK(entries[0].name == "before.txt");
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(archive_writer_fails_for_missing_files)
+{
+	const auto path = get_temp_path("missing.zip");
+
+	utils::compression::zip::archive_writer writer(path.string());
+	writer.add_file("missing.txt", get_temp_path("does_not_exist.txt").string());
+	CHECK(!writer.finish());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(zlib_decompress_round_trips_with_any_hint)
+{
+	constexpr size_t sizes[] = {0, 1, 1000, CHUNK - 1, CHUNK, CHUNK + 1, 0x100000 + 7};
+	for (const auto size : sizes)
+	{
+		const auto data = generate_text(size, static_cast<uint32_t>(size));
+		const auto compressed = utils::compression::zlib::compress(data);
+		CHECK(!compressed.empty());
+
+		CHECK(utils::compression::zlib::decompress(compressed) == data);
+		CHECK(utils::compression::zlib::decompress(compressed, size) == data);
+
+		// Too small, so the buffer has to grow, and far too large, so the rest is released
+		CHECK(utils::compression::zlib::decompress(compressed, 0) == data);
+		CHECK(utils::compression::zlib::decompress(compressed, size / 3) == data);
+		CHECK(utils::compression::zlib::decompress(compressed, size * 8 + 0x10000) == data);
+	}
+}
+
+TEST_CASE(zlib_decompress_rejects_broken_input)
+{
+	CHECK(utils::compression::zlib::decompress({}).empty());
+	CHECK(utils::compression::zlib::decompress({}, 0x1000).empty());
+	CHECK(utils::compression::zlib::decompress("not zlib data").empty());
+
+	const auto data = generate_text(0x10000, 5);
+	const auto compressed = utils::compression::zlib::compress(data);
+
+	CHECK(utils::compression::zlib::decompress(compressed.substr(0, compressed.size() / 2)).empty());
+	CHECK(utils::compression::zlib::decompress(compressed.substr(0, compressed.size() - 1), data.size()).empty());
+}
+
+TEST_CASE(zlib_streams_round_trip)
+{
+	for (const size_t size : {0, 1, 1000, 0x100000 + 7})
+	{
+		const auto data = generate_text(size, static_cast<uint32_t>(size) + 1);
+
+		// Odd chunk sizes, so input and output never line up with the internal buffers
+		const auto compressed = compress_in_chunks(data, 4099);
+		CHECK(utils::compression::zlib::decompress(compressed, size) == data);
+		CHECK(decompress_in_chunks(compressed, 1) == data);
+		CHECK(decompress_in_chunks(compressed, 7919) == data);
+		CHECK(decompress_in_chunks(utils::compression::zlib::compress(data), compressed.size()) == data);
+
+		const auto pumped = [&]
+		{
+			std::string result;
+			utils::compression::zlib::deflate_stream stream([&result](const uint8_t* buffer, const size_t length)
+			{
+				result.append(reinterpret_cast<const char*>(buffer), length);
+				return true;
+			});
+
+			CHECK(stream.pump(read_string(data)));
+			return result;
+		}();
+
+		std::string inflated;
+		utils::compression::zlib::inflate_stream stream([&inflated](const uint8_t* buffer, const size_t length)
+		{
+			inflated.append(reinterpret_cast<const char*>(buffer), length);
+			return true;
+		});
+
+		CHECK(stream.pump(read_string(pumped)));
+		CHECK(inflated == data);
+	}
+}
+
+TEST_CASE(zlib_streams_stop_on_errors)
+{
+	const auto data = generate_text(0x40000, 6);
+	const auto compressed = utils::compression::zlib::compress(data);
+
+	// Input past the end of the stream is ignored
+	CHECK(decompress_in_chunks(compressed + "trailing", 1000) == data);
+
+	{
+		utils::compression::zlib::inflate_stream stream([](const uint8_t*, size_t)
+		{
+			return false;
+		});
+
+		CHECK(!stream.write(compressed.data(), compressed.size()));
+		CHECK(!stream.is_finished());
+	}
+
+	{
+		utils::compression::zlib::inflate_stream stream([](const uint8_t*, size_t)
+		{
+			return true;
+		});
+
+		CHECK(!stream.pump(read_string(compressed.substr(0, compressed.size() / 2))));
+		CHECK(!stream.is_finished());
+	}
+
+	{
+		utils::compression::zlib::deflate_stream stream([](const uint8_t*, size_t)
+		{
+			return false;
+		});
+
+		// The output doesn't fit the internal buffer, so the writer is called before finishing
+		CHECK(!stream.write(data.data(), data.size()));
+	}
+}
+
+BENCHMARK(archive_writer_benchmark)
+{
+	// A 1 GB tree of 256 text files of 4 MB, generated by readers so only the archive touches the disk
+	constexpr size_t file_count = 256;
+	constexpr size_t file_size = 0x400000;
+
+	const auto path = get_temp_path("benchmark.zip");
+	const auto data = generate_text(file_size, 4);
+
+	for (const size_t threads : {1, 2, 4, 8})
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		utils::compression::zip::archive_writer writer(path.string(), utils::compression::zlib::best_compression, threads);
+		for (size_t i = 0; i < file_count; ++i)
+		{
+			writer.add("file_" + std::to_string(i) + ".txt", read_string(data), data.size());
+		}
+
+		CHECK(writer.finish());
+
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("  %zu thread(s): %6.2f s, %7.1f MB/s, archive %.1f MB\n", threads, seconds,
+		            static_cast<double>(file_count * file_size) / seconds / 1e6,
+		            static_cast<double>(std::filesystem::file_size(path)) / 1e6);
+	}
+
+	std::filesystem::remove(path);
+}
+
+BENCHMARK(zlib_decompress_benchmark)
+{
+	std::printf("  %-8s %12s %12s %12s %12s\n", "size", "appending", "no hint", "exact hint", "stream");
+
+	for (const size_t size : {0x400, 0x10000, 0x100000, 0x1000000, 0x4000000})
+	{
+		const auto data = generate_text(size, 7);
+		const auto compressed = utils::compression::zlib::compress(data, 6);
+		const size_t runs = size <= 0x100000 ? 50 : 5;
+
+		CHECK(decompress_appending(compressed) == data);
+
+		const auto appending = time_best(runs, [&]
+		{
+			return decompress_appending(compressed);
+		});
+
+		const auto no_hint = time_best(runs, [&]
+		{
+			return utils::compression::zlib::decompress(compressed);
+		});
+
+		const auto hinted = time_best(runs, [&]
+		{
+			return utils::compression::zlib::decompress(compressed, size);
+		});
+
+		const auto streamed = time_best(runs, [&]
+		{
+			size_t total = 0;
+			utils::compression::zlib::inflate_stream stream([&total](const uint8_t*, const size_t length)
+			{
+				total += length;
+				return true;
+			});
+
+			stream.write(compressed.data(), compressed.size());
+			return total;
+		});
+
+		std::printf("  %6zu KB %9.3f ms %9.3f ms %9.3f ms %9.3f ms\n", size / 1024, appending, no_hint, hinted, streamed);
+	}
+}
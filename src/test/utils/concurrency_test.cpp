@@ -0,0 +1,297 @@
+#include "test.hpp"
+
+#include <utils/concurrency.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+	// Same layout as the game event stream, a line spans as many chunks as it needs
+	struct event_chunk
+	{
+		uint16_t length;
+		char data[0xFE];
+	};
+
+	using event_queue = utils::concurrency::ring_queue<event_chunk, 0x4000>;
+
+	bool push_line(event_queue& queue, const std::string_view line)
+	{
+		return utils::concurrency::push_chunked(queue, line);
+	}
+
+	std::string consume_text(event_queue& queue)
+	{
+		std::string text;
+		queue.consume([&](const event_chunk& chunk) { text.append(chunk.data, chunk.length); });
+		return text;
+	}
+
+	const std::string_view kill_line =
+		R"({"type":"kill","time":123456,"victim":{"guid":"0110000100000001","num":3,"team":"axis","name":"Victim"},)"
+		R"("attacker":{"guid":"0110000100000002","num":7,"team":"allies","name":"Attacker"},)"
+		R"("weapon":"iw5_m4_mp","damage":100,"mod":"MOD_RIFLE_BULLET","hitloc":"head"})"
+		"\n";
+
+	// Producers push as fast as they can while the consumer drains at the given interval, like the
+	// game event writer does every 20ms. Whatever doesn't fit into the ring between drains is dropped.
+	void run_throughput(event_queue& queue, const size_t producers, const std::chrono::milliseconds drain_interval)
+	{
+		std::atomic_bool running{true};
+		std::atomic_uint64_t pushed{0};
+
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < producers; ++i)
+		{
+			threads.emplace_back([&]
+			{
+				uint64_t count = 0;
+				while (running.load(std::memory_order_relaxed))
+				{
+					count += push_line(queue, kill_line) ? 1 : 0;
+				}
+
+				pushed += count;
+			});
+		}
+
+		uint64_t bytes = 0;
+		const auto start = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - start < 1s)
+		{
+			std::this_thread::sleep_for(drain_interval);
+			queue.consume([&](const event_chunk& chunk) { bytes += chunk.length; });
+		}
+
+		running = false;
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		queue.consume([&](const event_chunk& chunk) { bytes += chunk.length; });
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const auto dropped = queue.take_dropped();
+
+		std::printf("  %zu producer(s), %2lldms drain: %10.0f events/s, %7.1f MB/s, %5.1f%% of pushes dropped\n",
+		            producers, static_cast<long long>(drain_interval.count()),
+		            static_cast<double>(pushed.load()) / seconds, static_cast<double>(bytes) / seconds / 1e6,
+		            100.0 * static_cast<double>(dropped) / static_cast<double>(dropped + pushed.load()));
+	}
+}
+
+TEST_CASE(ring_queue_drops_when_full)
+{
+	utils::concurrency::ring_queue<int, 4> queue{};
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		CHECK(queue.try_push(i));
+	}
+
+	CHECK(!queue.try_push(4));
+	CHECK(!queue.try_push_n(5, [](size_t, int&) {}));
+	CHECK(queue.take_dropped() == 2);
+	CHECK(queue.take_dropped() == 0);
+
+	std::vector<int> values;
+	CHECK(queue.consume([&](const int value) { values.push_back(value); }) == 4);
+	CHECK((values == std::vector{0, 1, 2, 3}));
+
+	CHECK(queue.try_push(5));
+	CHECK(queue.consume([](int) {}) == 1);
+}
+
+TEST_CASE(ring_queue_keeps_multi_slot_records_together)
+{
+	auto queue = std::make_unique<event_queue>();
+
+	constexpr size_t producers = 4;
+	constexpr size_t lines_per_producer = 20000;
+
+	std::vector<std::thread> threads;
+	for (size_t producer = 0; producer < producers; ++producer)
+	{
+		threads.emplace_back([&, producer]
+		{
+			// Long enough to span three chunks, every byte names the producer
+			const std::string line(600, static_cast<char>('a' + producer));
+			for (size_t i = 0; i < lines_per_producer;)
+			{
+				if (push_line(*queue, line + '\n'))
+				{
+					++i;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	size_t lines = 0;
+	std::string current;
+	bool interleaved = false;
+
+	while (lines < producers * lines_per_producer)
+	{
+		queue->consume([&](const event_chunk& chunk)
+		{
+			current.append(chunk.data, chunk.length);
+			if (current.back() != '\n')
+			{
+				return;
+			}
+
+			interleaved |= current.size() != 601 || current.find_first_not_of(current.front()) != current.size() - 1;
+			current.clear();
+			++lines;
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(!interleaved);
+	CHECK(current.empty());
+}
+
+TEST_CASE(push_chunked_splits_text_into_one_record)
+{
+	auto queue = std::make_unique<event_queue>();
+	constexpr auto chunk_size = sizeof(event_chunk::data);
+
+	for (const auto size : {size_t{1}, chunk_size - 1, chunk_size, chunk_size + 1, chunk_size * 3})
+	{
+		std::string text(size, 'x');
+		text.back() = '\n';
+
+		CHECK(push_line(*queue, text));
+		CHECK(consume_text(*queue) == text);
+	}
+
+	CHECK(queue->take_dropped() == 0);
+}
+
+TEST_CASE(push_chunked_ignores_empty_text)
+{
+	auto queue = std::make_unique<event_queue>();
+
+	CHECK(push_line(*queue, {}));
+	CHECK(consume_text(*queue).empty());
+	CHECK(queue->take_dropped() == 0);
+}
+
+TEST_CASE(push_chunked_drops_text_larger_than_the_queue)
+{
+	utils::concurrency::ring_queue<event_chunk, 4> queue{};
+
+	CHECK(!utils::concurrency::push_chunked(queue, std::string(sizeof(event_chunk::data) * 4 + 1, 'x')));
+	CHECK(queue.take_dropped() == 1);
+
+	CHECK(utils::concurrency::push_chunked(queue, std::string(sizeof(event_chunk::data) * 4, 'x')));
+	CHECK(queue.take_dropped() == 0);
+}
+
+BENCHMARK(console_queue_latency_benchmark)
+{
+	// Console messages from 4 threads while the runner drains the queue continuously
+	auto queue = std::make_unique<event_queue>();
+
+	constexpr size_t producers = 4;
+	constexpr size_t messages_per_producer = 250000;
+	const std::string_view message = "Loaded fastfile 'mp_frontend_tr' in 12 ms\n";
+
+	std::atomic_bool running{true};
+	std::thread consumer([&]
+	{
+		while (running.load(std::memory_order_relaxed))
+		{
+			if (!queue->consume([](const event_chunk& chunk) { test::keep(chunk.length); }))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	std::vector<std::vector<uint32_t>> latencies(producers);
+	std::vector<std::thread> threads;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t producer = 0; producer < producers; ++producer)
+	{
+		threads.emplace_back([&, producer]
+		{
+			auto& samples = latencies[producer];
+			samples.reserve(messages_per_producer);
+
+			for (size_t i = 0; i < messages_per_producer; ++i)
+			{
+				const auto push_start = std::chrono::steady_clock::now();
+				push_line(*queue, message);
+				const auto push_end = std::chrono::steady_clock::now();
+
+				samples.push_back(static_cast<uint32_t>(std::chrono::nanoseconds(push_end - push_start).count()));
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	running = false;
+	consumer.join();
+
+	std::vector<uint32_t> samples;
+	for (const auto& producer_samples : latencies)
+	{
+		samples.insert(samples.end(), producer_samples.begin(), producer_samples.end());
+	}
+
+	std::sort(samples.begin(), samples.end());
+	const auto percentile = [&](const double value)
+	{
+		return samples[static_cast<size_t>(value * static_cast<double>(samples.size() - 1))];
+	};
+
+	const auto dropped = queue->take_dropped();
+	std::printf("  %zu messages from %zu threads: %.0f messages/s, %zu dropped\n", samples.size(), producers,
+	            static_cast<double>(samples.size()) / seconds, dropped);
+	std::printf("  push latency: p50 %u ns, p99 %u ns, p99.9 %u ns, max %u ns\n", percentile(0.5), percentile(0.99),
+	            percentile(0.999), samples.back());
+}
+
+BENCHMARK(event_queue_benchmark)
+{
+	auto queue = std::make_unique<event_queue>();
+
+	test::measure("push kill event (consumer idle)", [&]
+	{
+		if (!push_line(*queue, kill_line))
+		{
+			queue->consume([](const event_chunk& chunk) { test::keep(chunk.length); });
+		}
+	});
+
+	queue->consume([](const event_chunk&) {});
+	queue->take_dropped();
+
+	for (const auto drain_interval : {0ms, 20ms})
+	{
+		run_throughput(*queue, 1, drain_interval);
+		run_throughput(*queue, 4, drain_interval);
+	}
+}
@@ -0,0 +1,143 @@
+#include "test.hpp"
+
+#include <utils/frame_pacer.hpp>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+	// Time only moves when the pacer sleeps or spins, or when a test simulates frame work
+	class fake_pacer_clock final : public utils::pacer_clock
+	{
+	public:
+		std::chrono::nanoseconds time{1s};
+		std::chrono::nanoseconds margin{2ms};
+		std::chrono::nanoseconds oversleep{};
+		std::chrono::nanoseconds relax_step{10us};
+
+		std::vector<std::chrono::nanoseconds> sleeps;
+		uint64_t relax_calls{};
+
+		std::chrono::nanoseconds now() override
+		{
+			return this->time;
+		}
+
+		void sleep_until(const std::chrono::nanoseconds deadline) override
+		{
+			this->sleeps.push_back(deadline);
+			this->time = std::max(this->time, deadline + this->oversleep);
+		}
+
+		void relax() override
+		{
+			++this->relax_calls;
+			this->time += this->relax_step;
+		}
+
+		std::chrono::nanoseconds get_spin_margin() override
+		{
+			return this->margin;
+		}
+	};
+}
+
+TEST_CASE(frame_pacer_keeps_ticks_on_the_grid)
+{
+	fake_pacer_clock clock{};
+	utils::frame_pacer pacer{clock};
+
+	const auto start = clock.time;
+	for (auto i = 0; i < 100; ++i)
+	{
+		// Frame work of varying length must not shift the following deadlines
+		clock.time += std::chrono::milliseconds(i % 7);
+		pacer.wait(100);
+	}
+
+	CHECK(clock.time == start + 100 * 10ms);
+
+	const auto& stats = pacer.get_statistics();
+	CHECK(stats.ticks == 100);
+	CHECK(stats.overruns == 0);
+	CHECK(stats.max_lateness == 0ns);
+}
+
+TEST_CASE(frame_pacer_caps_spinning_to_a_fraction_of_the_interval)
+{
+	fake_pacer_clock clock{};
+	utils::frame_pacer pacer{clock};
+
+	// 2ms margin, but only a tenth of the 10ms interval may be spent spinning
+	pacer.wait(100);
+
+	CHECK(clock.sleeps.size() == 1);
+	CHECK(clock.sleeps[0] == 1s + 9ms);
+	CHECK(clock.relax_calls == 100);
+
+	// A 50ms interval spins for the whole margin
+	clock.relax_calls = 0;
+	clock.sleeps.clear();
+	pacer.wait(20);
+
+	CHECK(clock.sleeps.size() == 1);
+	CHECK(clock.relax_calls == 200);
+}
+
+TEST_CASE(frame_pacer_only_sleeps_when_the_interval_is_within_the_margin)
+{
+	fake_pacer_clock clock{};
+	clock.oversleep = 300us;
+	utils::frame_pacer pacer{clock};
+
+	for (auto i = 0; i < 10; ++i)
+	{
+		pacer.wait(1000);
+	}
+
+	CHECK(clock.relax_calls == 0);
+	CHECK(clock.sleeps.size() == 10);
+
+	const auto& stats = pacer.get_statistics();
+	CHECK(stats.overruns == 0);
+	CHECK(stats.max_lateness == 300us);
+}
+
+TEST_CASE(frame_pacer_skips_missed_ticks)
+{
+	fake_pacer_clock clock{};
+	utils::frame_pacer pacer{clock};
+
+	pacer.wait(100);
+	const auto first_deadline = clock.time;
+
+	// The next deadline was first_deadline + 10ms, this frame ends 25ms later
+	clock.time += 35ms;
+	pacer.wait(100);
+
+	const auto& stats = pacer.get_statistics();
+	CHECK(stats.overruns == 1);
+	CHECK(stats.skipped_ticks == 2);
+	CHECK(stats.max_overrun == 25ms);
+
+	// Back on the grid instead of running the missed ticks
+	pacer.wait(100);
+	CHECK(clock.time == first_deadline + 40ms);
+}
+
+TEST_CASE(frame_pacer_rate_changes)
+{
+	fake_pacer_clock clock{};
+	utils::frame_pacer pacer{clock};
+
+	const auto start = clock.time;
+	pacer.wait(0);
+	CHECK(clock.time == start);
+	CHECK(pacer.get_statistics().ticks == 0);
+
+	pacer.wait(50);
+	CHECK(clock.time == start + 20ms);
+
+	pacer.wait(200);
+	CHECK(clock.time == start + 25ms);
+}
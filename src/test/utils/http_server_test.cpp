@@ -0,0 +1,199 @@
+#include "test.hpp"
+
+#include <utils/http_server.hpp>
+#include <utils/metrics.hpp>
+
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace
+{
+	// Blocking loopback client, the server has to be running on another thread
+	class test_client final
+	{
+	public:
+		explicit test_client(const uint16_t port)
+		{
+			this->socket_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(port);
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+			if (connect(this->socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+			{
+				test::fail(__FILE__, __LINE__, "failed to connect to the server");
+			}
+		}
+
+		~test_client()
+		{
+#ifdef _WIN32
+			closesocket(this->socket_);
+#else
+			close(this->socket_);
+#endif
+		}
+
+		test_client(const test_client&) = delete;
+		test_client& operator=(const test_client&) = delete;
+
+		void send_data(const std::string& data) const
+		{
+			send(this->socket_, data.data(), static_cast<int>(data.size()), 0);
+		}
+
+		// Everything until the server closes the connection
+		std::string receive_all() const
+		{
+			std::string result;
+			char buffer[0x400];
+
+			while (true)
+			{
+				const auto length = recv(this->socket_, buffer, static_cast<int>(sizeof(buffer)), 0);
+				if (length <= 0)
+				{
+					return result;
+				}
+
+				result.append(buffer, static_cast<size_t>(length));
+			}
+		}
+
+	private:
+#ifdef _WIN32
+		SOCKET socket_;
+#else
+		int socket_;
+#endif
+	};
+
+	// Serves a registry on an ephemeral loopback port for the lifetime of the object
+	class metrics_endpoint final
+	{
+	public:
+		utils::metrics::registry registry{};
+
+		metrics_endpoint()
+			: server_([this](const std::string_view path) -> utils::http_server::response
+			{
+				if (path != "/metrics")
+				{
+					return {404, "text/plain; charset=utf-8", "Not Found\n"};
+				}
+
+				return {200, "text/plain; version=0.0.4; charset=utf-8", this->registry.render()};
+			})
+		{
+			this->server_.listen("127.0.0.1:0");
+			this->port_ = this->server_.get_port();
+
+			this->thread_ = std::thread([this]
+			{
+				while (this->running_)
+				{
+					this->server_.run_frame(10ms);
+				}
+			});
+		}
+
+		~metrics_endpoint()
+		{
+			this->running_ = false;
+			this->thread_.join();
+		}
+
+		metrics_endpoint(const metrics_endpoint&) = delete;
+		metrics_endpoint& operator=(const metrics_endpoint&) = delete;
+
+		[[nodiscard]] uint16_t get_port() const
+		{
+			return this->port_;
+		}
+
+		[[nodiscard]] std::string get(const std::string& path) const
+		{
+			const test_client client(this->port_);
+			client.send_data("GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+			return client.receive_all();
+		}
+
+	private:
+		utils::http_server server_;
+		uint16_t port_{};
+		std::atomic_bool running_{true};
+		std::thread thread_;
+	};
+}
+
+TEST_CASE(http_server_rejects_remote_addresses)
+{
+	utils::http_server server([](std::string_view) { return utils::http_server::response{}; });
+
+	CHECK_THROWS(server.listen("0.0.0.0:0"));
+	CHECK_THROWS(server.listen("127.0.0.1"));
+	CHECK(!server.is_listening());
+
+	server.listen("127.0.0.1:0");
+	CHECK(server.is_listening());
+	CHECK(server.get_port() != 0);
+}
+
+TEST_CASE(metrics_scrape_over_loopback)
+{
+	metrics_endpoint endpoint{};
+	endpoint.registry.get_counter("net_oob_packets_total", "Packets", {"command", "getinfo"}).increment(7);
+
+	const auto response = endpoint.get("/metrics?name=net_oob_packets_total");
+
+	CHECK(response.starts_with("HTTP/1.1 200 OK\r\n"));
+	CHECK(response.find("Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n") != std::string::npos);
+	CHECK(response.ends_with("\r\n\r\n" + endpoint.registry.render()));
+	CHECK(response.find("net_oob_packets_total{command=\"getinfo\"} 7\n") != std::string::npos);
+
+	CHECK(endpoint.get("/other").starts_with("HTTP/1.1 404 Not Found\r\n"));
+}
+
+TEST_CASE(metrics_scrape_is_not_blocked_by_idle_clients)
+{
+	metrics_endpoint endpoint{};
+
+	// Connections that never send a request only hold their own slot
+	const test_client idle_client(endpoint.get_port());
+	const test_client partial_client(endpoint.get_port());
+	partial_client.send_data("GET /metr");
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto response = endpoint.get("/metrics");
+
+	CHECK(response.starts_with("HTTP/1.1 200 OK\r\n"));
+	CHECK(std::chrono::steady_clock::now() - start < utils::http_server::client_timeout / 2);
+
+	// And are dropped once their deadline passed
+	CHECK(partial_client.receive_all().empty());
+}
+
+TEST_CASE(http_server_rejects_other_methods)
+{
+	metrics_endpoint endpoint{};
+
+	const test_client client(endpoint.get_port());
+	client.send_data("POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+
+	CHECK(client.receive_all().starts_with("HTTP/1.1 405 Method Not Allowed\r\n"));
+}
@@ -0,0 +1,140 @@
+#include "test.hpp"
+
+#include <utils/latency_stats.hpp>
+
+#include <random>
+#include <thread>
+
+TEST_CASE(latency_histogram_tracks_durations)
+{
+	utils::latency_stats::histogram histogram{};
+	CHECK(histogram.get_count() == 0);
+	CHECK(histogram.get_percentile(50) == 0);
+
+	for (std::uint64_t i = 1; i <= 100; ++i)
+	{
+		histogram.record(i * 1000);
+	}
+
+	CHECK(histogram.get_count() == 100);
+	CHECK(histogram.get_total() == 5050 * 1000);
+	CHECK(histogram.get_max() == 100000);
+
+	// Bucket upper bounds, within a factor of two above the exact percentile
+	CHECK(histogram.get_percentile(50) >= 50000 && histogram.get_percentile(50) < 100000);
+	CHECK(histogram.get_percentile(99) >= 99000 && histogram.get_percentile(99) < 198000);
+	CHECK(histogram.get_percentile(100) >= 100000);
+
+	// Everything above ~1s lands in the last bucket
+	histogram.record(~0ull >> 1);
+	CHECK(histogram.get_percentile(100) == (1ull << (utils::latency_stats::histogram::bucket_count - 1)) - 1);
+
+	histogram.reset();
+	CHECK(histogram.get_count() == 0);
+	CHECK(histogram.get_total() == 0);
+	CHECK(histogram.get_max() == 0);
+}
+
+TEST_CASE(latency_slowest_list_keeps_the_slowest)
+{
+	utils::latency_stats::slowest_list slowest{3};
+
+	slowest.record(1, "a", 10);
+	slowest.record(1, "b", 30);
+	slowest.record(2, "a", 20);
+	slowest.record(1, "c", 5);
+
+	auto entries = slowest.get();
+	CHECK(entries.size() == 3);
+	CHECK(entries[0].name == "b" && entries[0].duration_ns == 30);
+	CHECK(entries[1].name == "a" && entries[1].category == 2);
+	CHECK(entries[2].name == "a" && entries[2].category == 1);
+
+	// A name is kept once per category, with its slowest duration
+	slowest.record(1, "a", 40);
+	slowest.record(1, "a", 15);
+	entries = slowest.get();
+	CHECK(entries.size() == 3);
+	CHECK(entries[0].name == "a" && entries[0].duration_ns == 40);
+	CHECK(entries[1].name == "b");
+	CHECK(entries[2].category == 2);
+
+	// Faster than everything kept once the list is full
+	slowest.record(3, "d", 20);
+	CHECK(slowest.get().back().category == 2);
+
+	slowest.reset();
+	CHECK(slowest.get().empty());
+	slowest.record(1, "e", 1);
+	CHECK(slowest.get().size() == 1);
+}
+
+BENCHMARK(latency_stats_benchmark)
+{
+	// Asset lookups: most take a few microseconds, about one in a thousand is a slow streamed asset
+	std::mt19937 random(1);
+	std::vector<std::uint64_t> durations(0x10000);
+	for (auto& duration : durations)
+	{
+		duration = random() % 1000 == 0 ? 1'000'000 + random() % 50'000'000 : 500 + random() % 20'000;
+	}
+
+	std::vector<std::string> names;
+	for (auto i = 0; i < 512; ++i)
+	{
+		names.emplace_back("mp_prison_asset_" + std::to_string(i));
+	}
+
+	utils::latency_stats::histogram histogram{};
+	utils::latency_stats::slowest_list slowest{32};
+
+	size_t index = 0;
+	test::measure("histogram record", [&]
+	{
+		histogram.record(durations[++index & 0xFFFF]);
+	});
+
+	test::measure("histogram + slowest list record", [&]
+	{
+		const auto i = ++index;
+		histogram.record(durations[i & 0xFFFF]);
+		slowest.record(static_cast<int>(i % 40), names[i & 511], durations[i & 0xFFFF]);
+	});
+
+	test::measure("histogram p99", [&]
+	{
+		test::keep(histogram.get_percentile(99));
+	});
+
+	for (const auto thread_count : {2, 4})
+	{
+		constexpr auto records = 1'000'000;
+
+		histogram.reset();
+		slowest.reset();
+
+		const auto start = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> threads;
+		for (auto t = 0; t < thread_count; ++t)
+		{
+			threads.emplace_back([&, t]
+			{
+				for (auto i = 0; i < records; ++i)
+				{
+					const auto n = static_cast<size_t>(i) * thread_count + t;
+					histogram.record(durations[n & 0xFFFF]);
+					slowest.record(static_cast<int>(n % 40), names[n & 511], durations[n & 0xFFFF]);
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("  %d threads: %.1f ns per record\n", thread_count, seconds * 1e9 / (static_cast<double>(records) * thread_count));
+	}
+}
@@ -0,0 +1,115 @@
+#include "test.hpp"
+
+#include <utils/metrics.hpp>
+
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+	bool contains(const std::string& text, const std::string& part)
+	{
+		return text.find(part) != std::string::npos;
+	}
+}
+
+TEST_CASE(metrics_lookup_returns_the_same_metric)
+{
+	utils::metrics::registry registry{};
+
+	auto& first = registry.get_counter("requests_total", "Requests", {"service", "a"});
+	auto& second = registry.get_counter("requests_total", "Requests", {"service", "a"});
+	auto& other = registry.get_counter("requests_total", "Requests", {"service", "b"});
+
+	CHECK(&first == &second);
+	CHECK(&first != &other);
+	CHECK_THROWS(registry.get_gauge("requests_total", "Requests", {"service", "a"}));
+}
+
+TEST_CASE(metrics_histogram_buckets_are_cumulative)
+{
+	utils::metrics::histogram histogram{};
+
+	histogram.observe(500us);
+	histogram.observe(1ms);
+	histogram.observe(20ms);
+	histogram.observe(5s);
+
+	const auto buckets = histogram.get_buckets();
+	CHECK(buckets[0] == 2);
+	CHECK(buckets[4] == 2);
+	CHECK(buckets[5] == 3);
+	CHECK(buckets[utils::metrics::histogram::bounds.size() - 1] == 3);
+	CHECK(buckets.back() == 4);
+	CHECK(histogram.get_sum() == 500us + 1ms + 20ms + 5s);
+}
+
+TEST_CASE(metrics_render_prometheus_text)
+{
+	utils::metrics::registry registry{};
+
+	registry.get_counter("packets_total", "Packets per command", {"command", "getinfo"}).increment(3);
+	registry.get_gauge("clients", "Connected clients").set(12);
+	registry.get_counter("packets_total", "Packets per command", {"command", "a\"b\\c"}).increment();
+	registry.get_histogram("frame_seconds", "Frame time", {"pipeline", "server"}).observe(2ms);
+
+	const auto output = registry.render();
+
+	// Both label values are rendered below one header
+	CHECK(output.find("# TYPE packets_total counter") == output.rfind("# TYPE packets_total counter"));
+	CHECK(contains(output, "# HELP packets_total Packets per command\n# TYPE packets_total counter\n"
+		"packets_total{command=\"getinfo\"} 3\npackets_total{command=\"a\\\"b\\\\c\"} 1\n"));
+	CHECK(contains(output, "# TYPE clients gauge\nclients 12\n"));
+	CHECK(contains(output, "frame_seconds_bucket{pipeline=\"server\",le=\"0.001\"} 0\n"));
+	CHECK(contains(output, "frame_seconds_bucket{pipeline=\"server\",le=\"0.0025\"} 1\n"));
+	CHECK(contains(output, "frame_seconds_bucket{pipeline=\"server\",le=\"+Inf\"} 1\n"));
+	CHECK(contains(output, "frame_seconds_sum{pipeline=\"server\"} 0.002\n"));
+	CHECK(contains(output, "frame_seconds_count{pipeline=\"server\"} 1\n"));
+}
+
+// The cost every instrumented call site pays, and what a scrape costs the exporter thread
+BENCHMARK(metrics_benchmark)
+{
+	utils::metrics::registry registry{};
+
+	auto& counter = registry.get_counter("packets_total", "Packets", {"command", "getinfo"});
+	auto& gauge = registry.get_gauge("clients", "Clients");
+	auto& histogram = registry.get_histogram("frame_seconds", "Frame time", {"pipeline", "server"});
+
+	test::measure("counter increment", [&] { counter.increment(); });
+	test::measure("gauge set", [&] { gauge.set(12.0); });
+	test::measure("histogram observe", [&] { histogram.observe(16ms); });
+	test::measure("counter lookup (uncached)", [&] { test::keep(registry.get_counter("packets_total", "Packets", {"command", "getinfo"})); });
+
+	// Contended counter, like several pipelines counting into one metric
+	{
+		std::atomic_bool running{true};
+		std::thread other([&]
+		{
+			while (running.load(std::memory_order_relaxed))
+			{
+				counter.increment();
+			}
+		});
+
+		test::measure("counter increment (contended)", [&] { counter.increment(); });
+
+		running = false;
+		other.join();
+	}
+
+	// Roughly what a server registers: OOB commands, Demonware services and the pipelines
+	for (auto i = 0; i < 40; ++i)
+	{
+		registry.get_counter("net_oob_packets_total", "Packets", {"command", "command" + std::to_string(i)}).increment(static_cast<uint64_t>(i));
+		registry.get_counter("dw_requests_total", "Requests", {"service", "service" + std::to_string(i)}).increment();
+	}
+
+	for (const auto* pipeline : {"async", "renderer", "server", "main"})
+	{
+		registry.get_histogram("scheduler_frame_seconds", "Frame time", {"pipeline", pipeline}).observe(8ms);
+	}
+
+	test::measure("render 90 metrics", [&] { test::keep(registry.render()); });
+}
@@ -0,0 +1,176 @@
+#include "test.hpp"
+
+#include <utils/output_history.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+	std::string get_line(const utils::output_history::snapshot& snapshot, const size_t index)
+	{
+		const auto& [offset, length] = snapshot.lines.at(index);
+		return snapshot.text.substr(offset, length);
+	}
+
+	void append_lines(utils::output_history& output, const size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			output.append("> ", std::to_string(i));
+		}
+	}
+}
+
+TEST_CASE(output_history_drops_oldest_lines_when_full)
+{
+	utils::output_history output{4};
+	append_lines(output, 10);
+
+	CHECK(output.begin() == 6);
+	CHECK(output.end() == 10);
+
+	utils::output_history::snapshot snapshot{};
+	CHECK(output.read(0, 16, snapshot));
+	CHECK(snapshot.first == 6);
+	CHECK(snapshot.total == 4);
+	CHECK(snapshot.lines.size() == 4);
+	CHECK(get_line(snapshot, 0) == "> 6");
+	CHECK(get_line(snapshot, 3) == "> 9");
+}
+
+TEST_CASE(output_history_wraps_the_arena)
+{
+	// 2 slots of 128 bytes, every line takes 101 bytes so each append wraps or evicts
+	utils::output_history output{2};
+	const std::string line(100, 'x');
+
+	for (auto i = 0; i < 8; ++i)
+	{
+		output.append(std::to_string(i), line);
+	}
+
+	utils::output_history::snapshot snapshot{};
+	CHECK(output.read(output.begin(), 2, snapshot));
+	CHECK(!snapshot.lines.empty());
+	CHECK(get_line(snapshot, snapshot.lines.size() - 1) == "7" + line);
+}
+
+TEST_CASE(output_history_truncates_long_lines)
+{
+	utils::output_history output{4};
+	output.append("> ", std::string(utils::output_history::max_line_length * 2, 'a'));
+
+	utils::output_history::snapshot snapshot{};
+	CHECK(output.read(0, 1, snapshot));
+	CHECK(get_line(snapshot, 0).size() == utils::output_history::max_line_length);
+}
+
+TEST_CASE(output_history_scroll_follows_output_at_bottom)
+{
+	utils::output_history output{64};
+	append_lines(output, 20);
+
+	CHECK(output.is_following_output());
+	CHECK(output.get_first_visible_line(5) == 15);
+
+	output.scroll(-3, 5);
+	CHECK(!output.is_following_output());
+	CHECK(output.get_first_visible_line(5) == 12);
+
+	// New lines don't move a view that was scrolled up
+	append_lines(output, 2);
+	CHECK(output.get_first_visible_line(5) == 12);
+
+	output.scroll(-100, 5);
+	CHECK(output.get_first_visible_line(5) == 0);
+
+	output.scroll(100, 5);
+	CHECK(output.is_following_output());
+	CHECK(output.get_first_visible_line(5) == 17);
+
+	append_lines(output, 1);
+	CHECK(output.get_first_visible_line(5) == 18);
+}
+
+TEST_CASE(output_history_scroll_ignores_short_output)
+{
+	utils::output_history output{64};
+	append_lines(output, 3);
+
+	output.scroll(-1, 5);
+	CHECK(output.is_following_output());
+	CHECK(output.get_first_visible_line(5) == 0);
+}
+
+TEST_CASE(output_history_scroll_races_appends)
+{
+	utils::output_history output{128};
+	std::atomic_bool running{true};
+
+	std::thread writer([&]
+	{
+		for (size_t i = 0; running.load(std::memory_order_relaxed); ++i)
+		{
+			output.append("> ", std::to_string(i));
+		}
+	});
+
+	utils::output_history::snapshot snapshot{};
+	for (auto i = 0; i < 10000; ++i)
+	{
+		output.scroll(i % 3 == 0 ? 1 : -1, 10);
+
+		const auto first = output.get_first_visible_line(10);
+		if (output.read(first, 10, snapshot))
+		{
+			CHECK(snapshot.lines.size() <= 10);
+		}
+	}
+
+	running = false;
+	writer.join();
+}
+
+BENCHMARK(output_history_benchmark)
+{
+	utils::output_history output{512};
+	const std::string line = "Loaded fastfile 'mp_frontend_tr' in 12 ms";
+
+	test::measure("append", [&] { output.append("^3", line); });
+
+	utils::output_history::snapshot snapshot{};
+	test::measure("render 40 visible lines", [&]
+	{
+		output.read(output.get_first_visible_line(40), 40, snapshot);
+		test::keep(snapshot.text.size());
+	});
+
+	test::measure("scroll and render 40 lines", [&]
+	{
+		output.scroll(-1, 40);
+		output.read(output.get_first_visible_line(40), 40, snapshot);
+		test::keep(snapshot.text.size());
+	});
+
+	// Rendering while the console is spammed from another thread
+	{
+		std::atomic_bool running{true};
+		std::thread writer([&]
+		{
+			while (running.load(std::memory_order_relaxed))
+			{
+				output.append("^3", line);
+			}
+		});
+
+		test::measure("render 40 lines (concurrent appends)", [&]
+		{
+			output.read(output.get_first_visible_line(40), 40, snapshot);
+			test::keep(snapshot.text.size());
+		});
+
+		running = false;
+		writer.join();
+	}
+}
@@ -0,0 +1,187 @@
+#include "test.hpp"
+
+#include <utils/signature_scanner.hpp>
+
+#include <random>
+
+namespace
+{
+	std::vector<uint8_t> generate_buffer(const size_t size, const uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<uint8_t> buffer(size);
+
+		// Skewed towards a few values, like code with its many 0x00, 0x48 and 0xCC bytes
+		for (auto& value : buffer)
+		{
+			const auto roll = random();
+			value = static_cast<uint8_t>(roll % 4 == 0 ? roll >> 8 : (roll >> 8) % 16);
+		}
+
+		return buffer;
+	}
+
+	std::string generate_pattern(std::mt19937& random, std::vector<uint8_t>& buffer, const bool plant)
+	{
+		const auto length = 8 + random() % 9;
+		const auto position = random() % (buffer.size() - length);
+
+		std::string pattern;
+		for (size_t i = 0; i < length; ++i)
+		{
+			if (i != 0 && random() % 5 == 0)
+			{
+				pattern += "? ";
+				continue;
+			}
+
+			const auto value = static_cast<uint8_t>(random());
+			if (plant)
+			{
+				buffer[position + i] = value;
+			}
+
+			char hex[4];
+			std::snprintf(hex, sizeof(hex), "%02X ", value);
+			pattern += hex;
+		}
+
+		return pattern;
+	}
+
+	std::vector<size_t> find_all(const utils::hook::signature_scanner::pattern& pattern, const std::vector<uint8_t>& buffer)
+	{
+		std::vector<size_t> matches;
+		for (size_t offset = 0; offset + pattern.mask.size() <= buffer.size(); ++offset)
+		{
+			size_t i = 0;
+			while (i < pattern.mask.size() && (pattern.mask[i] == '?' || pattern.bytes[i] == buffer[offset + i]))
+			{
+				++i;
+			}
+
+			if (i == pattern.mask.size())
+			{
+				matches.push_back(offset);
+			}
+		}
+
+		return matches;
+	}
+}
+
+TEST_CASE(signature_scanner_parses_patterns)
+{
+	const auto pattern = utils::hook::signature_scanner::parse("48 8b ? 05 ? ?");
+	CHECK(pattern.mask == "xx?x");
+	CHECK((pattern.bytes == std::basic_string<uint8_t>{0x48, 0x8B, 0x00, 0x05}));
+
+	CHECK_THROWS(utils::hook::signature_scanner::parse("48 8G"));
+	CHECK_THROWS(utils::hook::signature_scanner::parse("48 8"));
+
+	utils::hook::signature_scanner scanner{};
+	CHECK_THROWS(scanner.add("? ?"));
+	CHECK(scanner.add("CC") == 0);
+}
+
+TEST_CASE(signature_scanner_finds_overlapping_and_edge_matches)
+{
+	const std::vector<uint8_t> buffer = {0xAA, 0xAA, 0xAA, 0x01, 0x02, 0xAA, 0xAA};
+
+	utils::hook::signature_scanner scanner{};
+	scanner.add("AA AA");
+	scanner.add("AA ? 01");
+	scanner.add("02 AA AA");
+	scanner.add("AA AA AA AA AA AA AA AA");
+
+	const auto matches = scanner.scan(buffer.data(), buffer.size());
+	CHECK((matches[0] == std::vector<size_t>{0, 1, 5}));
+	CHECK((matches[1] == std::vector<size_t>{1}));
+	CHECK((matches[2] == std::vector<size_t>{4}));
+	CHECK(matches[3].empty());
+}
+
+TEST_CASE(signature_scanner_matches_a_linear_search)
+{
+	// Not a multiple of the 32 byte blocks, so the scalar tail runs as well
+	auto buffer = generate_buffer(0x200000 + 13, 1);
+	std::mt19937 random(2);
+
+	utils::hook::signature_scanner scanner{};
+	for (auto i = 0; i < 64; ++i)
+	{
+		scanner.add(generate_pattern(random, buffer, i % 2 == 0));
+	}
+
+	// Short patterns of common bytes have many matches
+	scanner.add("01 ? 02");
+	scanner.add("0F 0F");
+
+	const auto matches = scanner.scan(buffer.data(), buffer.size());
+	CHECK(matches.size() == scanner.size());
+
+	for (size_t i = 0; i < scanner.size(); ++i)
+	{
+		CHECK(matches[i] == find_all(scanner.get(i), buffer));
+		if (i < 64 && i % 2 == 0)
+		{
+			CHECK(!matches[i].empty());
+		}
+	}
+}
+
+TEST_CASE(signature_scanner_checks_bounds)
+{
+	const std::vector<uint8_t> buffer = {0x01, 0x02, 0x03};
+
+	utils::hook::signature_scanner scanner{};
+	scanner.add("02 03");
+
+	CHECK(scanner.matches_at(0, buffer.data(), buffer.size(), 1));
+	CHECK(!scanner.matches_at(0, buffer.data(), buffer.size(), 2));
+	CHECK(!scanner.matches_at(0, buffer.data(), buffer.size(), 10));
+	CHECK(scanner.scan(buffer.data(), 0)[0].empty());
+}
+
+BENCHMARK(signature_scanner_benchmark)
+{
+	auto buffer = generate_buffer(100 * 1024 * 1024, 3);
+	std::mt19937 random(4);
+
+	utils::hook::signature_scanner scanner{};
+	for (auto i = 0; i < 500; ++i)
+	{
+		scanner.add(generate_pattern(random, buffer, i % 2 == 0));
+	}
+
+	for (auto run = 0; run < 3; ++run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const auto matches = scanner.scan(buffer.data(), buffer.size());
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		size_t total = 0;
+		for (const auto& list : matches)
+		{
+			total += list.size();
+		}
+
+		std::printf("  500 patterns over 100 MB: %7.1f ms, %7.1f MB/s, %zu matches\n", seconds * 1000.0,
+		            static_cast<double>(buffer.size()) / seconds / 1e6, total);
+	}
+
+	// The same patterns one after another, like 500 separate signature scans
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		size_t total = 0;
+		for (size_t i = 0; i < 20; ++i)
+		{
+			total += find_all(scanner.get(i), buffer).size();
+		}
+
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 25.0;
+		std::printf("  500 linear scans over 100 MB (extrapolated from 20): %.1f ms (%zu matches in the sample)\n",
+		            seconds * 1000.0, total);
+	}
+}
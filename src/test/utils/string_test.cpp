@@ -0,0 +1,197 @@
+#include "test.hpp"
+
+#include <utils/string.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <sstream>
+
+namespace
+{
+	// The implementations the optimized helpers replaced, used as references
+	std::vector<std::string> reference_split(const std::string& s, const char delim)
+	{
+		std::stringstream ss(s);
+		std::string item;
+		std::vector<std::string> elems;
+
+		while (std::getline(ss, item, delim))
+		{
+			elems.push_back(item);
+		}
+
+		return elems;
+	}
+
+	std::string reference_to_lower(const std::string& text)
+	{
+		std::string result;
+		std::ranges::transform(text, std::back_inserter(result), [](const unsigned char input)
+		{
+			return static_cast<char>(std::tolower(input));
+		});
+
+		return result;
+	}
+
+	std::string reference_to_upper(const std::string& text)
+	{
+		std::string result;
+		std::ranges::transform(text, std::back_inserter(result), [](const unsigned char input)
+		{
+			return static_cast<char>(std::toupper(input));
+		});
+
+		return result;
+	}
+
+	std::string random_text(std::mt19937& engine)
+	{
+		static constexpr char alphabet[] = "aZ\\ \n09^@[`{\x80\xC4\xFF";
+
+		std::uniform_int_distribution<size_t> length(0, 80);
+		std::uniform_int_distribution<size_t> index(0, sizeof(alphabet) - 2);
+
+		std::string text(length(engine), '\0');
+		for (auto& chr : text)
+		{
+			chr = alphabet[index(engine)];
+		}
+
+		return text;
+	}
+
+	const std::string info_string = "\\sv_hostname\\^2S1x ^7Server\\mapname\\mp_prison\\g_gametype\\war"
+		"\\sv_maxclients\\18\\clients\\12\\bots\\4\\isPrivate\\0\\hc\\0\\securityLevel\\0\\shortversion\\1.22";
+}
+
+TEST_CASE(string_split_keeps_empty_tokens)
+{
+	using utils::string::split;
+
+	CHECK(split(std::string("a,,b"), ',') == (std::vector<std::string>{"a", "", "b"}));
+	CHECK(split(std::string(",a"), ',') == (std::vector<std::string>{"", "a"}));
+	CHECK(split(std::string("a,"), ',') == (std::vector<std::string>{"a"}));
+	CHECK(split(std::string(""), ',').empty());
+}
+
+TEST_CASE(string_split_matches_getline)
+{
+	std::mt19937 engine(1337);
+
+	for (auto i = 0; i < 20000; ++i)
+	{
+		const auto text = random_text(engine);
+		CHECK(utils::string::split(text, '\\') == reference_split(text, '\\'));
+	}
+}
+
+TEST_CASE(string_split_view_matches_split)
+{
+	std::mt19937 engine(42);
+
+	for (auto i = 0; i < 20000; ++i)
+	{
+		const auto text = random_text(engine);
+		const auto expected = utils::string::split(text, ' ');
+
+		std::vector<std::string> tokens;
+		for (const auto& token : utils::string::split_view(text, ' '))
+		{
+			CHECK(token.data() >= text.data() && token.data() + token.size() <= text.data() + text.size());
+			tokens.emplace_back(token);
+		}
+
+		CHECK(tokens == expected);
+	}
+}
+
+TEST_CASE(string_case_matches_c_locale)
+{
+	std::mt19937 engine(7);
+
+	for (auto i = 0; i < 20000; ++i)
+	{
+		const auto text = random_text(engine);
+		CHECK(utils::string::to_lower(text) == reference_to_lower(text));
+		CHECK(utils::string::to_upper(text) == reference_to_upper(text));
+
+		auto in_place = text;
+		utils::string::to_lower_inplace(in_place);
+		CHECK(in_place == reference_to_lower(text));
+	}
+}
+
+TEST_CASE(string_overloads_accept_all_string_types)
+{
+	using namespace utils::string;
+
+	const std::string text = "mp_Prison_SS";
+	const std::string_view view = text;
+
+	CHECK(to_lower(text) == "mp_prison_ss");
+	CHECK(to_lower(view) == "mp_prison_ss");
+	CHECK(to_lower("MP") == "mp");
+	CHECK(to_upper(text.data()) == "MP_PRISON_SS");
+
+	CHECK(starts_with(text, "mp_"));
+	CHECK(starts_with(view, "mp_"));
+	CHECK(starts_with("mp_prison", "mp_"));
+	CHECK(starts_with(text, std::string("mp_")));
+	CHECK(!starts_with("mp", "mp_"));
+
+	CHECK(ends_with(text, "_SS"));
+	CHECK(ends_with(view, text));
+	CHECK(ends_with("x.ff", ".ff"));
+	CHECK(!ends_with("ff", ".ff"));
+	CHECK(ends_with(text, ""));
+
+	CHECK(split("a b", ' ').size() == 2);
+	CHECK(split(view, '_').size() == 3);
+}
+
+TEST_CASE(string_va_grows_its_buffer)
+{
+	const std::string long_text(1000, 'x');
+	CHECK(utils::string::va("%s%d", long_text.data(), 5) == long_text + "5");
+	CHECK(std::string(utils::string::va("%02X", 0xAB)) == "AB");
+}
+
+TEST_CASE(string_replace_and_hex)
+{
+	CHECK(utils::string::replace("a.b.c", ".", "::") == "a::b::c");
+	CHECK(utils::string::replace("abc", "", "x") == "abc");
+	CHECK(utils::string::dump_hex("\x01\xFF") == "01 FF");
+}
+
+TEST_CASE(string_quote_csv)
+{
+	CHECK(utils::string::quote_csv("") == "\"\"");
+	CHECK(utils::string::quote_csv("mp_prison") == "\"mp_prison\"");
+	CHECK(utils::string::quote_csv("a,b\nc") == "\"a,b\nc\"");
+	CHECK(utils::string::quote_csv("say \"hi\"") == "\"say \"\"hi\"\"\"");
+}
+
+BENCHMARK(string_benchmark)
+{
+	const std::string name = "^1Some ^2Player ^7Name With A Clan Tag [S1X]";
+
+	test::measure("split info string (getline)", [&] { test::keep(reference_split(info_string, '\\')); });
+	test::measure("split info string", [&] { test::keep(utils::string::split(info_string, '\\')); });
+	test::measure("split_view info string", [&]
+	{
+		size_t count = 0;
+		for (const auto& token : utils::string::split_view(info_string, '\\'))
+		{
+			count += token.size();
+		}
+		test::keep(count);
+	});
+
+	test::measure("to_lower name (transform)", [&] { test::keep(reference_to_lower(name)); });
+	test::measure("to_lower name", [&] { test::keep(utils::string::to_lower(name)); });
+
+	test::measure("starts_with literal", [&] { test::keep(utils::string::starts_with(info_string, "\\sv_hostname")); });
+	test::measure("ends_with literal", [&] { test::keep(utils::string::ends_with(info_string, "1.22")); });
+}
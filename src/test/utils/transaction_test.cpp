@@ -0,0 +1,268 @@
+#include "test.hpp"
+
+#include <utils/transaction.hpp>
+
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+	constexpr size_t fake_page_size = 0x1000;
+
+	// Records the protection calls instead of changing any protections
+	class fake_protection_backend final : public utils::hook::protection_backend
+	{
+	public:
+		std::vector<size_t> unprotected_pages;
+		std::vector<std::pair<size_t, uint32_t>> restored_pages;
+		std::vector<std::pair<size_t, size_t>> flushes;
+		size_t fail_after = SIZE_MAX;
+
+		size_t get_page_size() override
+		{
+			return fake_page_size;
+		}
+
+		bool unprotect(void* address, const size_t length, uint32_t* old_protection) override
+		{
+			CHECK(length == fake_page_size);
+
+			if (this->unprotected_pages.size() == this->fail_after)
+			{
+				return false;
+			}
+
+			this->unprotected_pages.push_back(reinterpret_cast<size_t>(address));
+			*old_protection = static_cast<uint32_t>(this->unprotected_pages.size());
+			return true;
+		}
+
+		void restore(void* address, size_t, const uint32_t old_protection) override
+		{
+			this->restored_pages.emplace_back(reinterpret_cast<size_t>(address), old_protection);
+		}
+
+		void flush(void* address, const size_t length) override
+		{
+			this->flushes.emplace_back(reinterpret_cast<size_t>(address), length);
+		}
+	};
+
+	struct alignas(fake_page_size) pages
+	{
+		uint8_t data[fake_page_size * 3]{};
+	};
+
+	void write_value(utils::hook::transaction& transaction, uint8_t* place, const uint32_t value)
+	{
+		transaction.write(place, &value, sizeof(value));
+	}
+
+	uint32_t read_value(const uint8_t* place)
+	{
+		uint32_t value{};
+		std::memcpy(&value, place, sizeof(value));
+		return value;
+	}
+}
+
+TEST_CASE(transaction_defers_writes_until_commit)
+{
+	fake_protection_backend backend{};
+	pages memory{};
+	auto* const place = memory.data + 0x10;
+
+	utils::hook::transaction transaction{backend};
+	CHECK(utils::hook::transaction::get_active() == &transaction);
+
+	const uint32_t value = 0xDEADBEEF;
+	utils::hook::write_memory(place, &value, sizeof(value));
+
+	CHECK(transaction.size() == 1);
+	CHECK(read_value(place) == 0);
+	CHECK(backend.unprotected_pages.empty());
+
+	transaction.commit();
+
+	CHECK(read_value(place) == value);
+	CHECK(transaction.is_committed());
+	CHECK(utils::hook::transaction::get_active() == nullptr);
+	CHECK_THROWS(write_value(transaction, place, 1));
+}
+
+TEST_CASE(transaction_unprotects_each_page_once)
+{
+	fake_protection_backend backend{};
+	pages memory{};
+	const auto base = reinterpret_cast<size_t>(memory.data);
+
+	{
+		utils::hook::transaction transaction{backend};
+		write_value(transaction, memory.data + 0x20, 1);
+		write_value(transaction, memory.data + 0x40, 2);
+		// Straddles the first and the second page
+		write_value(transaction, memory.data + fake_page_size - 2, 3);
+		write_value(transaction, memory.data + fake_page_size * 2 + 8, 4);
+		transaction.commit();
+	}
+
+	CHECK(backend.unprotected_pages == (std::vector<size_t>{base, base + fake_page_size, base + fake_page_size * 2}));
+
+	// Every page gets back the protection it had
+	CHECK(backend.restored_pages.size() == 3);
+	for (size_t i = 0; i < backend.restored_pages.size(); ++i)
+	{
+		CHECK(backend.restored_pages[i].first == backend.unprotected_pages[i]);
+		CHECK(backend.restored_pages[i].second == i + 1);
+	}
+
+	CHECK(backend.flushes.size() == 1);
+	CHECK(backend.flushes[0].first == base + 0x20);
+	CHECK(backend.flushes[0].second == fake_page_size * 2 + 12 - 0x20);
+
+	CHECK(read_value(memory.data + 0x20) == 1);
+	CHECK(read_value(memory.data + fake_page_size - 2) == 3);
+}
+
+TEST_CASE(transaction_rollback_restores_overlapping_writes)
+{
+	fake_protection_backend backend{};
+	pages memory{};
+	auto* const place = memory.data + 0x100;
+	std::memset(place, 0xCC, 8);
+
+	utils::hook::transaction transaction{backend};
+	write_value(transaction, place, 0x11111111);
+	write_value(transaction, place + 2, 0x22222222);
+	transaction.commit();
+
+	CHECK(read_value(place) == 0x22221111);
+
+	transaction.rollback();
+
+	for (auto i = 0; i < 8; ++i)
+	{
+		CHECK(place[i] == 0xCC);
+	}
+
+	CHECK(backend.unprotected_pages.size() == 2);
+	CHECK(backend.flushes.size() == 2);
+}
+
+TEST_CASE(transaction_rollback_before_commit_discards_writes)
+{
+	fake_protection_backend backend{};
+	pages memory{};
+
+	{
+		utils::hook::transaction transaction{backend};
+		write_value(transaction, memory.data, 5);
+		transaction.rollback();
+
+		CHECK(transaction.size() == 0);
+		CHECK(utils::hook::transaction::get_active() == nullptr);
+	}
+
+	CHECK(read_value(memory.data) == 0);
+	CHECK(backend.unprotected_pages.empty());
+}
+
+TEST_CASE(transaction_exception_discards_pending_writes)
+{
+	fake_protection_backend backend{};
+	pages memory{};
+
+	// A patch in the middle of the set throws, the ones before it must not be applied
+	CHECK_THROWS([&]
+	{
+		utils::hook::transaction transaction{backend};
+		write_value(transaction, memory.data, 1);
+		write_value(transaction, memory.data + fake_page_size, 2);
+		throw std::runtime_error("Pattern not found");
+	}());
+
+	CHECK(read_value(memory.data) == 0);
+	CHECK(read_value(memory.data + fake_page_size) == 0);
+	CHECK(backend.unprotected_pages.empty());
+	CHECK(backend.flushes.empty());
+	CHECK(utils::hook::transaction::get_active() == nullptr);
+}
+
+TEST_CASE(transaction_nested_restores_previous)
+{
+	fake_protection_backend backend{};
+
+	utils::hook::transaction outer{backend};
+	{
+		utils::hook::transaction inner{backend};
+		CHECK(utils::hook::transaction::get_active() == &inner);
+		inner.rollback();
+	}
+
+	CHECK(utils::hook::transaction::get_active() == &outer);
+	outer.rollback();
+}
+
+TEST_CASE(transaction_failed_unprotect_writes_nothing)
+{
+	fake_protection_backend backend{};
+	backend.fail_after = 1;
+	pages memory{};
+
+	utils::hook::transaction transaction{backend};
+	write_value(transaction, memory.data, 1);
+	write_value(transaction, memory.data + fake_page_size, 2);
+
+	CHECK_THROWS(transaction.commit());
+
+	CHECK(read_value(memory.data) == 0);
+	CHECK(read_value(memory.data + fake_page_size) == 0);
+	CHECK(backend.restored_pages.size() == 1);
+	CHECK(backend.flushes.empty());
+
+	transaction.rollback();
+}
+
+TEST_CASE(transaction_native_backend_patches_read_only_memory)
+{
+	auto& backend = utils::hook::get_native_protection_backend();
+	const auto page_size = backend.get_page_size();
+
+#ifdef _WIN32
+	auto* const memory = static_cast<uint8_t*>(VirtualAlloc(nullptr, page_size * 2, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+	CHECK(memory != nullptr);
+	std::memset(memory, 0x90, page_size * 2);
+	DWORD old_protection{};
+	VirtualProtect(memory, page_size * 2, PAGE_EXECUTE_READ, &old_protection);
+#else
+	auto* const memory = static_cast<uint8_t*>(mmap(nullptr, page_size * 2, PROT_READ | PROT_WRITE,
+	                                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	CHECK(memory != MAP_FAILED);
+	std::memset(memory, 0x90, page_size * 2);
+	mprotect(memory, page_size * 2, PROT_READ);
+#endif
+
+	auto* const place = memory + page_size - 2;
+
+	utils::hook::transaction transaction{};
+	write_value(transaction, place, 0xAABBCCDD);
+	transaction.commit();
+
+	CHECK(read_value(place) == 0xAABBCCDD);
+
+	transaction.rollback();
+
+	CHECK(read_value(place) == 0x90909090);
+
+#ifdef _WIN32
+	VirtualFree(memory, 0, MEM_RELEASE);
+#else
+	munmap(memory, page_size * 2);
+#endif
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Sample consumer for the game event stream.
+
+Reads the newline-delimited JSON events a dedicated server writes to g_eventLog
+or sends to g_eventLogAddress, prints kills and chat and keeps per-player stats.
+
+    set g_eventLogAddress "127.0.0.1:28970"    ->  event_consumer.py --udp 127.0.0.1:28970
+    set g_eventLog "logs/events.ndjson"        ->  event_consumer.py --file s1/logs/events.ndjson
+"""
+
+import argparse
+import collections
+import json
+import os
+import socket
+import sys
+import time
+
+
+class Stats:
+	def __init__(self):
+		self.kills = collections.Counter()
+		self.deaths = collections.Counter()
+		self.events = collections.Counter()
+		self.dropped = 0
+
+	def handle(self, event):
+		event_type = event.get("type")
+		self.events[event_type] += 1
+
+		if event_type == "kill":
+			attacker = event["attacker"]["name"] or "<world>"
+			victim = event["victim"]["name"]
+			self.kills[attacker] += 1
+			self.deaths[victim] += 1
+			print(f"[{event['time']}] {attacker} killed {victim} with {event['weapon']} ({event['hitloc']})")
+		elif event_type == "chat":
+			channel = "team" if event["team"] else "all"
+			print(f"[{event['time']}] ({channel}) {event['player']['name']}: {event['message']}")
+		elif event_type in ("join", "quit"):
+			print(f"[{event['time']}] {event['player']['name']} {'joined' if event_type == 'join' else 'left'}")
+		elif event_type == "init_game":
+			print(f"--- {event['map']} ({event['gametype']})")
+		elif event_type == "dropped":
+			# The server couldn't keep up with the consumer or its ring overflowed, events are missing here
+			self.dropped += event["count"]
+			print(f"!!! {event['count']} events dropped", file=sys.stderr)
+
+	def summary(self):
+		print(f"events: {sum(self.events.values())}, dropped: {self.dropped}")
+		for name, kills in self.kills.most_common(10):
+			print(f"  {name}: {kills} kills, {self.deaths[name]} deaths")
+
+
+def handle_lines(stats, data):
+	for line in data.splitlines():
+		if not line.strip():
+			continue
+
+		try:
+			stats.handle(json.loads(line))
+		except (ValueError, KeyError) as error:
+			print(f"bad event: {error}: {line[:200]!r}", file=sys.stderr)
+
+
+def read_udp(stats, address):
+	host, port = address.rsplit(":", 1)
+	sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+	# A larger receive buffer absorbs bursts while this process is busy printing
+	sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+	sock.bind((host, int(port)))
+
+	while True:
+		# Datagrams always end on a line boundary
+		data, _ = sock.recvfrom(65536)
+		handle_lines(stats, data.decode("utf-8", errors="replace"))
+
+
+def read_file(stats, path, from_start):
+	while not os.path.exists(path):
+		time.sleep(0.5)
+
+	with open(path, "r", encoding="utf-8", errors="replace") as file:
+		if not from_start:
+			file.seek(0, os.SEEK_END)
+
+		pending = ""
+		while True:
+			chunk = file.read(65536)
+			if not chunk:
+				time.sleep(0.1)
+				continue
+
+			# Only handle complete lines, the writer might be in the middle of one
+			pending += chunk
+			complete, _, pending = pending.rpartition("\n")
+			handle_lines(stats, complete)
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+	source = parser.add_mutually_exclusive_group(required=True)
+	source.add_argument("--udp", metavar="HOST:PORT", help="listen for datagrams sent to g_eventLogAddress")
+	source.add_argument("--file", metavar="PATH", help="follow the file written to g_eventLog")
+	parser.add_argument("--from-start", action="store_true", help="also read the events already in the file")
+	args = parser.parse_args()
+
+	stats = Stats()
+	try:
+		if args.udp:
+			read_udp(stats, args.udp)
+		else:
+			read_file(stats, args.file, args.from_start)
+	except KeyboardInterrupt:
+		stats.summary()
+
+
+if __name__ == "__main__":
+	main()